@@ -65,7 +65,7 @@ public:
             core::invocation_options _opts = core::invocation_options::unspecified) const
     -> decltype(::std::declval<_Promise<bus_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<bus_prx> >();
+        auto promise = make_promise< _Promise<bus_prx> >();
 
         get_bus_async(bus_id,
             [promise](bus_prx res)
@@ -99,7 +99,7 @@ public:
         ) const
         -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
         subscribe_async(bus_id, prx,
             [promise]()
             {
@@ -130,7 +130,7 @@ public:
             core::invocation_options _opts = core::invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
         unsubscribe_async(bus_id, prx,
             [promise]()
             {
@@ -161,7 +161,7 @@ public:
             core::invocation_options _opts = core::invocation_options::unspecified) const
     -> decltype(::std::declval<_Promise<core::object_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<core::object_prx> >();
+        auto promise = make_promise< _Promise<core::object_prx> >();
 
         get_publisher_async(bus_id,
             [promise](core::object_prx res)
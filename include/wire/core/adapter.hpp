@@ -24,6 +24,7 @@
 
 #include <wire/core/detail/configuration_options_fwd.hpp>
 #include <wire/core/detail/dispatch_request_fwd.hpp>
+#include <wire/core/detail/dispatch_executor_fwd.hpp>
 
 #include <wire/core/invocation_options.hpp>
 #include <wire/core/functional.hpp>
@@ -80,6 +81,12 @@ public:
     options() const;
     detail::ssl_options const&
     ssl_options() const;
+    /**
+     * @return Executor for incoming requests, nullptr if the requests are
+     *         dispatched in the I/O threads
+     */
+    detail::dispatch_executor_ptr
+    executor() const;
 
     //@{
     /** @name Activate/deactivate adapter */
@@ -106,7 +113,7 @@ public:
             invocation_options const&           opts        = invocation_options::unspecified)
         -> decltype(::std::declval< _Promise<void> >().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
 
         deactivate_async(
             [promise]()
@@ -152,7 +159,7 @@ public:
         invocation_options const&           opts        = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<locator_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<locator_prx> >();
+        auto promise = make_promise< _Promise<locator_prx> >();
 
         get_locator_async(
             [promise](locator_prx res)
@@ -198,7 +205,7 @@ public:
         invocation_options const&           opts    = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<locator_registry_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<locator_registry_prx> >();
+        auto promise = make_promise< _Promise<locator_registry_prx> >();
 
         get_locator_registry_async(
             [promise](locator_registry_prx res)
@@ -243,7 +250,7 @@ public:
         invocation_options const&       opts        = invocation_options::unspecified)
         -> decltype( ::std::declval<_Promise<void>>().get_future() )
     {
-        auto promise = ::std::make_shared<_Promise<void>>();
+        auto promise = make_promise<_Promise<void>>();
         register_adapter_async(
             [promise]()
             { promise->set_value(); },
@@ -278,7 +285,7 @@ public:
         invocation_options const&       opts        = invocation_options::unspecified)
         -> decltype( ::std::declval<_Promise<void>>().get_future() )
     {
-        auto promise = ::std::make_shared<_Promise<void>>();
+        auto promise = make_promise<_Promise<void>>();
         unregister_adapter_async(
             [promise]()
             { promise->set_value(); },
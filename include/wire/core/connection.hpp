@@ -219,6 +219,11 @@ public:
     local_endpoint() const;
     endpoint
     remote_endpoint() const;
+    /**
+     * Number of requests waiting for replies
+     */
+    ::std::size_t
+    outstanding_requests() const;
 private:
     connection(connection&&) = delete;
     connection(connection const&) = delete;
@@ -161,7 +161,7 @@ public:
         invocation_options const&       opts        = invocation_options::unspecified)
         -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared<_Promise<void>>();
+        auto promise = make_promise<_Promise<void>>();
 
         shutdown_async(
             [promise]()
@@ -247,7 +247,7 @@ public:
             invocation_options const& opts = invocation_options::unspecified)
         -> decltype(::std::declval<_Promise<connection_ptr>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<connection_ptr> >();
+        auto promise = make_promise< _Promise<connection_ptr> >();
         get_outgoing_connection_async(ep,
             [promise](connection_ptr val)
             {
@@ -291,7 +291,7 @@ public:
             invocation_options const&               opts = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<connection_ptr>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<connection_ptr> >();
+        auto promise = make_promise< _Promise<connection_ptr> >();
 
         resolve_connection_async(ref,
             [promise](connection_ptr res)
@@ -326,7 +326,7 @@ public:
         invocation_options const&           opts        = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<locator_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<locator_prx> >();
+        auto promise = make_promise< _Promise<locator_prx> >();
 
         get_locator_async(
             [promise](locator_prx res)
@@ -372,7 +372,7 @@ public:
         invocation_options const&           opts        = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<locator_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<locator_prx> >();
+        auto promise = make_promise< _Promise<locator_prx> >();
 
         get_locator_async( loc_ref,
             [promise](locator_prx res)
@@ -417,7 +417,7 @@ public:
         invocation_options const&           opts        = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<locator_registry_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<locator_registry_prx> >();
+        auto promise = make_promise< _Promise<locator_registry_prx> >();
 
         get_locator_registry_async(
             [promise](locator_registry_prx res)
@@ -464,7 +464,7 @@ public:
         invocation_options const&           opts    = invocation_options::unspecified) const
         -> decltype(::std::declval<_Promise<locator_registry_prx>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<locator_registry_prx> >();
+        auto promise = make_promise< _Promise<locator_registry_prx> >();
 
         get_locator_registry_async(loc_ref,
             [promise](locator_registry_prx res)
@@ -517,7 +517,7 @@ public:
             invocation_options const& opts = invocation_options::unspecified)
     -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
 
         add_well_known_object_async(obj,
                 [promise]()
@@ -569,7 +569,7 @@ public:
             invocation_options const& opts = invocation_options::unspecified)
     -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
 
         add_well_known_object_async(obj, loc_ref,
                 [promise]()
@@ -619,7 +619,7 @@ public:
             invocation_options const& opts = invocation_options::unspecified)
     -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
 
         remove_well_known_object_async(obj,
                 [promise]()
@@ -669,7 +669,7 @@ public:
             invocation_options const& opts = invocation_options::unspecified)
     -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
 
         remove_well_known_object_async(obj, loc_ref,
                 [promise]()
@@ -0,0 +1,386 @@
+/*
+ * coroutine.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_COROUTINE_HPP_
+#define WIRE_CORE_COROUTINE_HPP_
+
+/**
+ * Coroutine support for proxies and servants. Available only if the
+ * translation unit is compiled with coroutines enabled, the rest of the
+ * library doesn't depend on it.
+ */
+#if defined(__has_include)
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define WIRE_HAS_COROUTINES 1
+#define WIRE_COROUTINE_NS ::std
+#elif defined(__cpp_coroutines) && __has_include(<experimental/coroutine>)
+#include <experimental/coroutine>
+#define WIRE_HAS_COROUTINES 1
+#define WIRE_COROUTINE_NS ::std::experimental
+#endif
+#endif
+
+#ifndef WIRE_HAS_COROUTINES
+#define WIRE_HAS_COROUTINES 0
+#endif
+
+#include <type_traits>
+
+namespace wire {
+namespace core {
+
+template < typename T >
+class dispatch_task;
+
+template < typename T >
+struct is_dispatch_task : ::std::false_type {};
+
+template < typename T >
+struct is_dispatch_task< dispatch_task< T > > : ::std::true_type {};
+
+}  /* namespace core */
+}  /* namespace wire */
+
+#if WIRE_HAS_COROUTINES
+
+#include <wire/core/functional.hpp>
+#include <wire/util/spsc_future.hpp>
+
+#include <atomic>
+#include <exception>
+#include <utility>
+
+namespace wire {
+namespace core {
+
+template < typename T = void >
+using coroutine_handle = WIRE_COROUTINE_NS::coroutine_handle< T >;
+
+namespace detail {
+
+/**
+ * Completion status shared by the coroutine and the callbacks of an
+ * async operation, whichever comes last continues.
+ */
+enum class completion_status {
+    started,
+    /** The coroutine is suspended or the continuation is set */
+    waiting,
+    /** The result is set */
+    done
+};
+
+}  /* namespace detail */
+
+/**
+ * Awaitable for an async invocation.
+ *
+ * The invocation is started when the awaitable is constructed, the
+ * result and the exception callbacks store the result in the awaitable
+ * and resume the awaiting coroutine in the thread that called them, that
+ * is the connection's I/O thread. The callbacks capture only the pointer
+ * to the awaitable, so they don't allocate.
+ *
+ * The awaitable cannot be copied or moved and must be awaited before it
+ * is destroyed.
+ */
+template < typename T >
+class [[nodiscard]] invocation_awaitable {
+public:
+    using value_type    = T;
+
+    /**
+     * @param init Function starting the async operation, is called with
+     *      the result and the exception callbacks
+     */
+    template < typename Initiate >
+    explicit
+    invocation_awaitable(Initiate&& init)
+    {
+        try {
+            init(
+                [this](auto&& ... res)
+                {
+                    value_.emplace(::std::forward<decltype(res)>(res)...);
+                    complete();
+                },
+                [this](::std::exception_ptr ex)
+                {
+                    exception_ = ::std::move(ex);
+                    complete();
+                });
+        } catch (...) {
+            exception_ = ::std::current_exception();
+            status_.store(detail::completion_status::done, ::std::memory_order_release);
+        }
+    }
+
+    invocation_awaitable(invocation_awaitable const&) = delete;
+    invocation_awaitable&
+    operator = (invocation_awaitable const&) = delete;
+
+    bool
+    await_ready() const noexcept
+    {
+        return status_.load(::std::memory_order_acquire) == detail::completion_status::done;
+    }
+
+    bool
+    await_suspend(coroutine_handle<> h) noexcept
+    {
+        handle_ = h;
+        return status_.exchange(detail::completion_status::waiting,
+                ::std::memory_order_acq_rel) != detail::completion_status::done;
+    }
+
+    T
+    await_resume()
+    {
+        if (exception_)
+            ::std::rethrow_exception(exception_);
+        return value_.take();
+    }
+private:
+    void
+    complete()
+    {
+        if (status_.exchange(detail::completion_status::done,
+                ::std::memory_order_acq_rel) == detail::completion_status::waiting)
+            handle_.resume();
+    }
+private:
+    ::std::atomic< detail::completion_status >  status_{ detail::completion_status::started };
+    coroutine_handle<>                          handle_;
+    util::detail::spsc_value_storage< T >       value_;
+    ::std::exception_ptr                        exception_;
+};
+
+namespace detail {
+
+template < typename T >
+struct dispatch_result_callback {
+    using type = functional::callback< T&& >;
+};
+
+template <>
+struct dispatch_result_callback< void > {
+    using type = functional::void_callback;
+};
+
+template < typename T >
+class dispatch_promise_base {
+public:
+    using result_callback   = typename dispatch_result_callback< T >::type;
+
+    WIRE_COROUTINE_NS::suspend_never
+    initial_suspend() noexcept
+    { return {}; }
+
+    struct final_awaiter {
+        bool
+        await_ready() const noexcept
+        { return false; }
+        template < typename Promise >
+        void
+        await_suspend(coroutine_handle< Promise > h) noexcept
+        {
+            auto& promise = h.promise();
+            if (promise.status_.exchange(completion_status::done,
+                    ::std::memory_order_acq_rel) == completion_status::waiting) {
+                promise.deliver();
+                h.destroy();
+            }
+        }
+        void
+        await_resume() const noexcept {}
+    };
+
+    final_awaiter
+    final_suspend() noexcept
+    { return {}; }
+
+    void
+    unhandled_exception() noexcept
+    {
+        exception_ = ::std::current_exception();
+    }
+
+    /**
+     * Set the callbacks to deliver the result to. If the coroutine is
+     * finished, the result is delivered immediately.
+     * @return true if the coroutine is finished
+     */
+    bool
+    set_callbacks(result_callback&& result, functional::exception_callback&& exception) noexcept
+    {
+        result_     = ::std::move(result);
+        exception_cb_ = ::std::move(exception);
+        if (status_.exchange(completion_status::waiting,
+                ::std::memory_order_acq_rel) == completion_status::done) {
+            deliver();
+            return true;
+        }
+        return false;
+    }
+protected:
+    void
+    deliver() noexcept
+    {
+        if (!exception_) {
+            try {
+                deliver_value(::std::is_void<T>{});
+                return;
+            } catch (...) {
+                exception_ = ::std::current_exception();
+            }
+        }
+        functional::report_exception(exception_cb_, exception_);
+    }
+
+    void
+    deliver_value(::std::true_type)
+    {
+        value_.take();
+        if (result_)
+            result_();
+    }
+    template < typename U = T >
+    void
+    deliver_value(::std::false_type)
+    {
+        U res = value_.take();
+        if (result_)
+            result_(::std::move(res));
+    }
+protected:
+    ::std::atomic< completion_status >      status_{ completion_status::started };
+    util::detail::spsc_value_storage< T >   value_;
+    ::std::exception_ptr                    exception_;
+    result_callback                         result_;
+    functional::exception_callback          exception_cb_;
+};
+
+template < typename T >
+class dispatch_promise : public dispatch_promise_base< T > {
+public:
+    dispatch_task< T >
+    get_return_object() noexcept;
+
+    template < typename U >
+    void
+    return_value(U&& val)
+    {
+        this->value_.emplace(::std::forward<U>(val));
+    }
+};
+
+template <>
+class dispatch_promise< void > : public dispatch_promise_base< void > {
+public:
+    dispatch_task< void >
+    get_return_object() noexcept;
+
+    void
+    return_void() noexcept
+    {
+        this->value_.emplace();
+    }
+};
+
+}  /* namespace detail */
+
+/**
+ * Return type of a coroutine servant function. The coroutine starts
+ * immediately, the dispatch function passes the reply callbacks to the
+ * task via then and the result is delivered to them when the coroutine
+ * finishes, in the thread where it finished.
+ */
+template < typename T >
+class dispatch_task {
+public:
+    using promise_type  = detail::dispatch_promise< T >;
+    using handle_type   = coroutine_handle< promise_type >;
+    using result_callback = typename promise_type::result_callback;
+
+    dispatch_task(dispatch_task const&) = delete;
+    dispatch_task(dispatch_task&& rhs) noexcept
+        : handle_{ rhs.handle_ }
+    {
+        rhs.handle_ = nullptr;
+    }
+    ~dispatch_task()
+    {
+        detach(nullptr, nullptr);
+    }
+
+    dispatch_task&
+    operator = (dispatch_task const&) = delete;
+    dispatch_task&
+    operator = (dispatch_task&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            detach(nullptr, nullptr);
+            handle_ = rhs.handle_;
+            rhs.handle_ = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * Set the callbacks to receive the result of the coroutine.
+     */
+    void
+    then(result_callback result, functional::exception_callback exception)
+    {
+        detach(::std::move(result), ::std::move(exception));
+    }
+private:
+    friend class detail::dispatch_promise< T >;
+    explicit
+    dispatch_task(handle_type h) noexcept
+        : handle_{h} {}
+
+    void
+    detach(result_callback&& result, functional::exception_callback&& exception) noexcept
+    {
+        if (handle_) {
+            auto h = handle_;
+            handle_ = nullptr;
+            if (h.promise().set_callbacks(::std::move(result), ::std::move(exception)))
+                h.destroy();
+        }
+    }
+private:
+    handle_type     handle_;
+};
+
+namespace detail {
+
+template < typename T >
+dispatch_task< T >
+dispatch_promise< T >::get_return_object() noexcept
+{
+    return dispatch_task< T >{
+        dispatch_task< T >::handle_type::from_promise(*this) };
+}
+
+inline dispatch_task< void >
+dispatch_promise< void >::get_return_object() noexcept
+{
+    return dispatch_task< void >{
+        dispatch_task< void >::handle_type::from_promise(*this) };
+}
+
+}  /* namespace detail */
+
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_HAS_COROUTINES */
+
+#endif /* WIRE_CORE_COROUTINE_HPP_ */
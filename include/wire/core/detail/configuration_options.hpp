@@ -12,6 +12,7 @@
 #include <wire/core/endpoint.hpp>
 #include <wire/core/reference.hpp>
 #include <wire/core/detail/ssl_options.hpp>
+#include <wire/core/detail/dispatch_executor_fwd.hpp>
 
 namespace wire {
 namespace core {
@@ -45,6 +46,15 @@ struct connector_options {
      * Client-side ssl options
      */
     ssl_options     client_ssl;
+    /**
+     * Disable client-side SSL session resumption
+     */
+    bool            no_ssl_session_cache{false};
+    /**
+     * Use io_uring for tcp and unix socket connections when the kernel
+     * supports it
+     */
+    bool            io_uring{false};
 
     //@{
     /** @name Connection management */
@@ -56,10 +66,58 @@ struct connector_options {
      * Enable connection timing out
      */
     bool            enable_connection_timeouts{false};
+    /**
+     * Maximum number of connections to an endpoint. A new connection is
+     * opened when all the existing ones have requests in flight.
+     */
+    ::std::size_t   connection_pool_size{1};
+    /**
+     * Maximum number of connections to an endpoint for invocations
+     * with the bulk flag
+     */
+    ::std::size_t   bulk_pool_size{1};
+    /**
+     * Client connections send the validate message and the requests
+     * right after connect without waiting for the server's validate
+     * message. Requests sent to a server with an incompatible protocol
+     * version fail when the server's validate message arrives.
+     */
+    bool            optimistic_handshake{false};
     //@}
     //@{
     /** @name Request management */
     ::std::size_t   request_timeout{5000};
+    /**
+     * Maximum number of requests waiting for a reply per connection,
+     * zero means no limit. Invocations over the limit wait in the
+     * connection's queue.
+     */
+    ::std::size_t   max_outstanding_requests{0};
+    /**
+     * Maximum number of request bytes queued for writing per connection,
+     * zero means no limit
+     */
+    ::std::size_t   max_outstanding_bytes{0};
+    /**
+     * Maximum number of invocations waiting for the request window,
+     * zero means no limit. Invocations over the limit fail with
+     * request_overflow.
+     */
+    ::std::size_t   max_queued_requests{0};
+    /**
+     * Maximum number of incoming requests dispatched and not yet responded
+     * per connection, zero means no limit. When the limit is reached the
+     * connection stops reading until responses are sent.
+     */
+    ::std::size_t   max_dispatch_requests{0};
+    //@}
+    //@{
+    /** @name Monitoring */
+    /**
+     * Deliver connection observer events in batches, byte counters are
+     * aggregated between deliveries
+     */
+    bool            batch_observer_events{false};
     //@}
 
     connector_options() {}
@@ -78,6 +136,16 @@ struct adapter_options {
     bool            replicated;
     ssl_options     adapter_ssl;
     reference_data  locator_ref         = reference_data{};
+    /**
+     * Number of threads dispatching requests, zero means the requests are
+     * dispatched in the I/O threads.
+     * Requests waiting in the executor queues count against the
+     * connection's max_dispatch_requests window, the window is the only
+     * bound of the queues.
+     */
+    ::std::size_t   dispatch_threads    = 0;
+    dispatch_ordering
+                    dispatch_order      = dispatch_ordering::connection;
 };
 
 }  // namespace detail
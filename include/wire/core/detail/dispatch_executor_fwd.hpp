@@ -0,0 +1,36 @@
+/*
+ * dispatch_executor_fwd.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_DISPATCH_EXECUTOR_FWD_HPP_
+#define WIRE_CORE_DETAIL_DISPATCH_EXECUTOR_FWD_HPP_
+
+#include <memory>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Order of requests dispatched by an adapter's executor
+ */
+enum class dispatch_ordering {
+    /** Requests run in any order */
+    unordered,
+    /** Requests from a connection run in the order they were received */
+    connection,
+    /** Requests to a target identity run in the order they were received */
+    target
+};
+
+class dispatch_executor;
+using dispatch_executor_ptr = ::std::shared_ptr< dispatch_executor >;
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_DISPATCH_EXECUTOR_FWD_HPP_ */
@@ -11,6 +11,7 @@
 #include <wire/core/detail/dispatch_request_fwd.hpp>
 #include <wire/core/functional.hpp>
 #include <wire/encoding/buffers.hpp>
+#include <wire/encoding/message.hpp>
 
 namespace wire {
 namespace core {
@@ -27,6 +28,32 @@ struct dispatch_request {
 
     encoding::request_result_callback   result;
     functional::exception_callback      exception;
+
+    /** Number of the request, written to the reply header */
+    encoding::request::request_number   number          = 0;
+    /** Flags of the reply message, zero if no reply is expected */
+    encoding::message::message_flags    reply_flags     = encoding::message::request;
+
+    /**
+     * Create the buffer for the result of the request.
+     *
+     * For two-way requests the buffer is the reply message itself with the
+     * reply header written and the result encapsulation open, so the result
+     * is marshalled directly into the bytes sent to the peer. The buffer
+     * must be passed to the result callback.
+     */
+    encoding::outgoing
+    reply_writer() const
+    {
+        if ((reply_flags & encoding::message::type_bits) != encoding::message::reply) {
+            return encoding::outgoing{ buffer->get_connector() };
+        }
+        encoding::outgoing out{ buffer->get_connector(), reply_flags };
+        encoding::write(::std::back_inserter(out),
+                encoding::reply{ number, encoding::reply::success });
+        out.begin_encapsulation();
+        return out;
+    }
 };
 
 }  /* namespace detail */
@@ -9,12 +9,16 @@
 #define WIRE_CORE_DETAIL_SSL_OPTIONS_HPP_
 
 #include <string>
+#include <memory>
 #include <wire/core/ssl_certificate_fwd.hpp>
 
 namespace wire {
 namespace core {
 namespace detail {
 
+class ssl_session_cache;
+using ssl_session_cache_ptr = ::std::shared_ptr< ssl_session_cache >;
+
 struct ssl_options {
     ::std::string       verify_file;
     ::std::string       cert_file;
@@ -22,6 +26,22 @@ struct ssl_options {
     bool                require_peer_cert;
 
     ssl_verify_callback verify_func;
+    //@{
+    /** @name Session resumption */
+    /**
+     * Client-side session cache, shared by connections of a connector
+     */
+    ssl_session_cache_ptr   session_cache;
+    /**
+     * Server-side file with session ticket keys
+     */
+    ::std::string           ticket_key_file;
+    /**
+     * Server-side session ticket keys. Contexts sharing the keys can
+     * resume each other's sessions.
+     */
+    ::std::string           ticket_keys;
+    //@}
 };
 
 }  // namespace detail
@@ -12,6 +12,9 @@
 #include <iosfwd>
 #include <unordered_set>
 #include <mutex>
+#include <vector>
+#include <chrono>
+#include <algorithm>
 #include <boost/variant.hpp>
 
 #include <wire/encoding/wire_io.hpp>
@@ -30,6 +33,8 @@ enum class transport_type {
     ssl,
     udp,
     socket,
+    shm,
+    inproc,
 };
 
 namespace detail {
@@ -229,6 +234,30 @@ wire_read(InputIterator& begin, InputIterator end, socket_endpoint_data& v)
     encoding::read(begin, end, v.path);
 }
 
+/**
+ * Shared memory endpoint. The path is the unix socket used to set up
+ * the shared memory segment.
+ */
+struct shm_endpoint_data : socket_endpoint_data {
+    shm_endpoint_data() = default;
+    shm_endpoint_data( ::std::string const& path )
+        : socket_endpoint_data{path}
+    {
+    }
+};
+
+/**
+ * In-process endpoint. The path is the name the acceptor is bound to
+ * in the process-wide registry.
+ */
+struct inproc_endpoint_data : socket_endpoint_data {
+    inproc_endpoint_data() = default;
+    inproc_endpoint_data( ::std::string const& name )
+        : socket_endpoint_data{name}
+    {
+    }
+};
+
 template < typename T >
 struct endpoint_data_traits
     : ::std::integral_constant< transport_type, transport_type::empty > {};
@@ -249,6 +278,14 @@ template <>
 struct endpoint_data_traits< socket_endpoint_data >
     : ::std::integral_constant< transport_type, transport_type::socket > {};
 
+template <>
+struct endpoint_data_traits< shm_endpoint_data >
+    : ::std::integral_constant< transport_type, transport_type::shm > {};
+
+template <>
+struct endpoint_data_traits< inproc_endpoint_data >
+    : ::std::integral_constant< transport_type, transport_type::inproc > {};
+
 }  // namespace detail
 
 class endpoint;
@@ -263,7 +300,9 @@ public:
             detail::tcp_endpoint_data,
             detail::ssl_endpoint_data,
             detail::udp_endpoint_data,
-            detail::socket_endpoint_data
+            detail::socket_endpoint_data,
+            detail::shm_endpoint_data,
+            detail::inproc_endpoint_data
         >;
 public:
     endpoint() : endpoint_data_{ detail::empty_endpoint{} } {}
@@ -379,6 +418,10 @@ public:
     udp(::std::string const& host, uint16_t port);
     static endpoint
     socket(::std::string const& path);
+    static endpoint
+    shm(::std::string const& path);
+    static endpoint
+    inproc(::std::string const& name);
 private:
     bool
     transport_valid() const;
@@ -414,16 +457,19 @@ class endpoint_rotation< EndpointContainer<endpoint> > {
 public:
     using container_type    = EndpointContainer<endpoint>;
     using const_iterator    = typename container_type::const_iterator;
+    using duration_type     = ::std::chrono::microseconds;
+
+    static constexpr duration_type failure_penalty = ::std::chrono::seconds{60};
 public:
     endpoint_rotation()
         : endpoints_{}, current_{endpoints_.end()}, mtx_{} {}
 
     endpoint_rotation(endpoint_rotation const& rhs)
         : endpoints_{rhs.endpoints_},
-          current_{endpoints_.end()}, mtx_{} {}
+          current_{endpoints_.end()}, latencies_{rhs.latencies_}, mtx_{} {}
     endpoint_rotation(endpoint_rotation && rhs)
         : endpoints_{::std::move(rhs.endpoints_)},
-          current_{endpoints_.end()}, mtx_{} {}
+          current_{endpoints_.end()}, latencies_{::std::move(rhs.latencies_)}, mtx_{} {}
 
     endpoint_rotation(container_type const& eps)
         : endpoints_{eps}, current_{endpoints_.end()}, mtx_{} {}
@@ -450,6 +496,7 @@ public:
         lock_type lk{mtx_};
         endpoints_ = rhs;
         current_ = endpoints_.end();
+        latencies_.clear();
         return *this;
     }
     endpoint_rotation&
@@ -458,6 +505,7 @@ public:
         lock_type lk{mtx_};
         endpoints_.swap(rhs);
         current_ = endpoints_.end();
+        latencies_.clear();
         return *this;
     }
 
@@ -468,6 +516,7 @@ public:
         ::std::lock(mtx_, rhs.mtx_);
         swap(endpoints_, rhs.endpoints_);
         swap(current_, rhs.current_);
+        swap(latencies_, rhs.latencies_);
     }
 
     bool
@@ -496,15 +545,91 @@ public:
     container_type const&
     endpoints() const
     { return endpoints_; }
+
+    //@{
+    /** @name Connect latency */
+    /**
+     * Record time taken to connect to the endpoint
+     */
+    void
+    connected(endpoint const& ep, duration_type latency)
+    {
+        lock_type lk{mtx_};
+        auto f = find_latency(ep);
+        if (f == latencies_.end()) {
+            latencies_.emplace_back(ep, latency);
+        } else {
+            // Smooth the value, a single slow connect shouldn't demote
+            // an endpoint
+            f->second = (f->second * 3 + latency) / 4;
+        }
+    }
+    /**
+     * Record failure to connect to the endpoint
+     */
+    void
+    failed(endpoint const& ep)
+    {
+        lock_type lk{mtx_};
+        auto f = find_latency(ep);
+        if (f == latencies_.end()) {
+            latencies_.emplace_back(ep, failure_penalty);
+        } else {
+            f->second = failure_penalty;
+        }
+    }
+    /**
+     * Endpoints in order they should be tried. Starts with the next
+     * endpoint in rotation, endpoints with lower latency go first,
+     * endpoints not yet tried are considered fast.
+     */
+    ::std::vector< endpoint >
+    connect_order() const
+    {
+        auto first = next();
+        lock_type lk{mtx_};
+        ::std::vector< endpoint > res;
+        res.reserve(endpoints_.size());
+        auto start = ::std::find(endpoints_.begin(), endpoints_.end(), first);
+        res.insert(res.end(), start, endpoints_.end());
+        res.insert(res.end(), endpoints_.begin(), start);
+        ::std::stable_sort(res.begin(), res.end(),
+            [this](endpoint const& lhs, endpoint const& rhs)
+            {
+                return latency(lhs) < latency(rhs);
+            });
+        return res;
+    }
+    //@}
 private:
     using mutex_type        = ::std::mutex;
     using lock_type         = ::std::unique_lock<mutex_type>;
+    using latency_list      = ::std::vector< ::std::pair< endpoint, duration_type > >;
+
+    typename latency_list::iterator
+    find_latency(endpoint const& ep)
+    {
+        return ::std::find_if(latencies_.begin(), latencies_.end(),
+            [&ep](typename latency_list::value_type const& v){ return v.first == ep; });
+    }
+    duration_type
+    latency(endpoint const& ep) const
+    {
+        auto f = ::std::find_if(latencies_.begin(), latencies_.end(),
+            [&ep](typename latency_list::value_type const& v){ return v.first == ep; });
+        return f == latencies_.end() ? duration_type{0} : f->second;
+    }
 
     container_type          endpoints_;
     const_iterator mutable  current_;
+    latency_list            latencies_;
     mutex_type     mutable  mtx_;
 };
 
+template < template < typename, typename... > class EndpointContainer >
+constexpr typename endpoint_rotation< EndpointContainer<endpoint> >::duration_type
+endpoint_rotation< EndpointContainer<endpoint> >::failure_penalty;
+
 template < typename Endpoints >
 ::std::size_t
 hash(endpoint_rotation<Endpoints> const& eps)
@@ -556,7 +681,9 @@ struct enum_traits<core::transport_type> {
         core::transport_type::tcp,
         core::transport_type::ssl,
         core::transport_type::udp,
-        core::transport_type::socket
+        core::transport_type::socket,
+        core::transport_type::shm,
+        core::transport_type::inproc
     >;
 };
 
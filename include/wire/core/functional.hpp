@@ -12,15 +12,30 @@
 #include <exception>
 #include <vector>
 #include <wire/asio_config.hpp>
+#include <wire/util/inplace_function.hpp>
+
+/**
+ * Size of inline storage for callback captures, larger captures are
+ * allocated in the heap. A callback is larger than its storage, so a
+ * capture of another callback is never stored inline, whatever the size.
+ */
+#ifndef WIRE_CALLBACK_CAPACITY
+#define WIRE_CALLBACK_CAPACITY 64
+#endif
 
 namespace wire {
 namespace core {
 namespace functional {
 
-using void_callback         = ::std::function< void() >;
+constexpr ::std::size_t callback_capacity = WIRE_CALLBACK_CAPACITY;
+
+template < typename Signature >
+using function              = util::inplace_function< Signature, callback_capacity >;
+
+using void_callback         = function< void() >;
 
 template < typename ... T >
-using callback              = ::std::function< void (T ... ) >;
+using callback              = function< void (T ... ) >;
 
 using exception_callback    = callback< ::std::exception_ptr >;
 
@@ -74,7 +89,7 @@ private:
 };
 
 inline void
-report_exception(exception_callback handler, ::std::exception_ptr ex) noexcept
+report_exception(exception_callback const& handler, ::std::exception_ptr ex) noexcept
 {
     if (handler) {
         try {
@@ -84,7 +99,7 @@ report_exception(exception_callback handler, ::std::exception_ptr ex) noexcept
 }
 
 inline void
-report_exception(exception_callback handler, asio_config::error_code const& ec) noexcept
+report_exception(exception_callback const& handler, asio_config::error_code const& ec) noexcept
 {
     if (handler) {
         try {
@@ -96,7 +111,7 @@ report_exception(exception_callback handler, asio_config::error_code const& ec)
 
 template < typename Exception >
 void
-report_exception(exception_callback handler, Exception&& err) noexcept
+report_exception(exception_callback const& handler, Exception&& err) noexcept
 {
     if (handler) {
         try {
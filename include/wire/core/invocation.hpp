@@ -13,6 +13,7 @@
 #include <wire/core/detail/dispatch_request.hpp>
 #include <wire/core/current.hpp>
 #include <wire/core/object.hpp>
+#include <wire/core/coroutine.hpp>
 #include <wire/encoding/message.hpp>
 
 #include <wire/errors/not_found.hpp>
@@ -66,11 +67,31 @@ template < typename Interface, typename Return, typename ... Args >
 struct is_sync_dispatch< Return(Interface::*)(Args ...) const>
     : is_sync_dispatch_impl< sizeof ... (Args) >= 3, Args ... > {};
 
+/**
+ * Parameter types of a servant member function
+ */
+template < typename ... T >
+struct member_params;
+
+template < typename Interface, typename Return, typename ... Args >
+struct member_params< Return(Interface::*)(Args ...) > {
+    template < ::std::size_t N >
+    using arg = ::std::tuple_element< N, ::std::tuple< Args ... > >;
+};
+
+template < typename Interface, typename Return, typename ... Args >
+struct member_params< Return(Interface::*)(Args ...) const > {
+    template < ::std::size_t N >
+    using arg = ::std::tuple_element< N, ::std::tuple< Args ... > >;
+};
+
 enum class invokation_type {
     void_sync,
     nonvoid_sync,
     void_async,
-    nonvoid_async
+    nonvoid_async,
+    /** Servant function is a coroutine */
+    task
 };
 
 template < bool isVoid, bool isSync >
@@ -112,6 +133,13 @@ struct local_invocation< Handler, Member,
     static constexpr bool is_void       = ::psst::meta::is_func_void< member_type >::value;
     static constexpr bool is_sync       = is_sync_dispatch< member_type >::value;
     static constexpr bool void_response = response_traits::arity == 0;
+    static constexpr bool is_task       =
+            is_dispatch_task< typename member_traits::result_type >::value;
+
+    using dispatch_mode     = typename ::std::conditional<
+            is_task,
+            invocation_mode< invokation_type::task >,
+            invokation_selector< is_void && void_response, is_sync > >::type;
 
     using invocation_args = ::std::tuple< typename ::std::decay< Args >::type ... >;
     using exception_handler = functional::exception_callback;
@@ -151,7 +179,7 @@ struct local_invocation< Handler, Member,
         if (!srv) {
             dispatch(obj, curr, opts);
         } else {
-            invoke(srv, curr, opts, invokation_selector< is_void && void_response, is_sync >{});
+            invoke(srv, curr, opts, dispatch_mode{});
         }
     }
 
@@ -212,6 +240,19 @@ struct local_invocation< Handler, Member,
         }
     }
 
+    void
+    invoke( servant_ptr srv, current const& curr, invocation_options const&,
+            invocation_mode< invokation_type::task > const&) const
+    {
+        try {
+            invocation_args tmp = args;
+            ((*srv).*member)(::std::move(::std::get< Indexes >(tmp)) ..., curr)
+                    .then(response, exception);
+        } catch (...) {
+            functional::report_exception(exception, ::std::current_exception());
+        }
+    }
+
     void
     invocation_sent() const
     {
@@ -290,6 +331,228 @@ struct local_invocation< Handler, Member,
     }
 };
 
+/**
+ * Direct call of a servant function for a proxy which servant lives in
+ * the same connector and implements the interface.
+ *
+ * The arguments are forwarded to the servant function without copying,
+ * except for the parameters the servant function takes by rvalue
+ * reference, those get a copy of the caller's argument. A non-empty
+ * context is copied, as the servant can keep the current.
+ *
+ * A one-way invocation doesn't call the response handler, as with a
+ * remote one a non-void function cannot be invoked one way with a
+ * response handler. The timeout is not applied: the servant function runs
+ * in the calling thread, an asynchronous servant function responds when
+ * it is done.
+ */
+template < typename Handler, typename Member >
+struct collocated_invocation {
+    using member_type       = Member;
+    using member_traits     = ::psst::meta::function_traits< member_type >;
+    using interface_type    = typename member_traits::class_type;
+    using target_type       = local_target< interface_type >;
+
+    using response_hander   = Handler;
+    using response_traits   = ::psst::meta::function_traits<response_hander>;
+    using response_args     = typename response_traits::decayed_args_tuple_type;
+
+    static constexpr bool is_void       = ::psst::meta::is_func_void< member_type >::value;
+    static constexpr bool is_sync       = is_sync_dispatch< member_type >::value;
+    static constexpr bool void_response = response_traits::arity == 0;
+    static constexpr bool is_task       =
+            is_dispatch_task< typename member_traits::result_type >::value;
+
+    using dispatch_mode     = typename ::std::conditional<
+            is_task,
+            invocation_mode< invokation_type::task >,
+            invokation_selector< is_void && void_response, is_sync > >::type;
+
+    using exception_handler = functional::exception_callback;
+    using sent_handler      = functional::callback< bool >;
+
+    template < typename ... Args >
+    static void
+    invoke(reference const& ref, target_type&& target, member_type member,
+            encoding::operation_specs::operation_id const&  op,
+            context_type const&                             ctx,
+            response_hander const&                          response,
+            exception_handler const&                        exception,
+            sent_handler const&                             sent,
+            invocation_options const&                       opts,
+            Args&& ...                                      args)
+    {
+        if (opts.is_one_way() && !void_response && response) {
+            ::std::ostringstream os;
+            os << "Cannot invoke a non-void function "
+                << op << " on a one-way proxy";
+            throw errors::invalid_one_way_invocation{os.str()};
+        }
+        if (sent) {
+            try {
+                sent(true);
+            } catch (...) {}
+        }
+        try {
+            current curr{{{ref.object_id(), ref.facet()}, op},
+                make_context(ctx),
+                endpoint{},
+                ::std::move(target.adapter)};
+            invoke(*target.servant, member, curr,
+                    servant_response(response, opts,
+                            ::std::integral_constant<bool, void_response>{}),
+                    exception,
+                    typename ::psst::meta::index_builder< sizeof ... (Args) >::type{},
+                    ::std::forward<Args>(args)...);
+        } catch (...) {
+            functional::report_exception(exception, ::std::current_exception());
+        }
+    }
+
+    template < ::std::size_t ... Indexes, typename ... Args >
+    static void
+    invoke(interface_type& srv, member_type member, current const& curr,
+            response_hander const& response, exception_handler const& exception,
+            ::psst::meta::indexes_tuple< Indexes ... > const&,
+            Args&& ... args)
+    {
+        invoke(srv, member, curr, response, exception, dispatch_mode{},
+                servant_arg< Indexes >(::std::forward<Args>(args)) ...);
+    }
+
+    //@{
+    /** @name Arguments for the servant function parameters */
+    template < ::std::size_t N >
+    using param_type = typename member_params< member_type >::template arg< N >::type;
+    /**
+     * A servant function taking a parameter by rvalue reference can move
+     * from it, so it gets a copy of an lvalue argument.
+     */
+    template < typename Param, typename Arg >
+    using copy_arg = ::std::integral_constant< bool,
+            ::std::is_rvalue_reference< Param >::value &&
+            ::std::is_lvalue_reference< Arg >::value >;
+
+    template < ::std::size_t N, typename Arg >
+    static typename ::std::enable_if< copy_arg< param_type< N >, Arg >::value,
+            typename ::std::decay< Arg >::type >::type
+    servant_arg(Arg&& arg)
+    {
+        return arg;
+    }
+    template < ::std::size_t N, typename Arg >
+    static typename ::std::enable_if< !copy_arg< param_type< N >, Arg >::value,
+            Arg&& >::type
+    servant_arg(Arg&& arg)
+    {
+        return ::std::forward<Arg>(arg);
+    }
+    //@}
+
+    /**
+     * The servant can hold the current after it returns, so the current
+     * owns a copy of the context. An empty context is not allocated.
+     */
+    static context_const_ptr
+    make_context(context_type const& ctx)
+    {
+        if (ctx.empty())
+            return context_const_ptr{};
+        return ::std::make_shared< context_type >(ctx);
+    }
+
+    //@{
+    /** @name Response handler for the servant */
+    /**
+     * An asynchronous servant function calls the handler it gets, the
+     * handler of a one-way invocation does nothing.
+     */
+    static response_hander
+    servant_response(response_hander const& response,
+            invocation_options const& opts, ::std::true_type const&)
+    {
+        if (opts.is_one_way() || !response)
+            return [](){};
+        return response;
+    }
+    /**
+     * The result of a non-void function is passed to the handler if any
+     */
+    static response_hander
+    servant_response(response_hander const& response,
+            invocation_options const& opts, ::std::false_type const&)
+    {
+        if (opts.is_one_way())
+            return nullptr;
+        return response;
+    }
+    //@}
+
+    template < typename ... Args >
+    static void
+    invoke(interface_type& srv, member_type member, current const& curr,
+            response_hander const& response, exception_handler const&,
+            invocation_mode< invokation_type::void_sync > const&,
+            Args&& ... args)
+    {
+        (srv.*member)(::std::forward<Args>(args) ..., curr);
+        if (response)
+            response();
+    }
+
+    template < typename ... Args >
+    static void
+    invoke(interface_type& srv, member_type member, current const& curr,
+            response_hander const& response, exception_handler const&,
+            invocation_mode< invokation_type::nonvoid_sync > const&,
+            Args&& ... args)
+    {
+        response_args res = (srv.*member)(::std::forward<Args>(args) ..., curr);
+        if (response)
+            response(::std::move(res));
+    }
+
+    template < typename ... Args >
+    static void
+    invoke(interface_type& srv, member_type member, current const& curr,
+            response_hander const& response, exception_handler const& exception,
+            invocation_mode< invokation_type::void_async > const&,
+            Args&& ... args)
+    {
+        (srv.*member)(::std::forward<Args>(args) ..., response, exception, curr);
+    }
+
+    template < typename ... Args >
+    static void
+    invoke(interface_type& srv, member_type member, current const& curr,
+            response_hander const& response, exception_handler const& exception,
+            invocation_mode< invokation_type::nonvoid_async > const&,
+            Args&& ... args)
+    {
+        auto resp = response;
+        (srv.*member)(::std::forward<Args>(args) ...,
+                [resp](response_args const& res)
+                {
+                    if (resp) {
+                        auto tmp = res;
+                        resp(::std::move(tmp));
+                    }
+                }, exception, curr);
+    }
+
+    template < typename ... Args >
+    static void
+    invoke(interface_type& srv, member_type member, current const& curr,
+            response_hander const& response, exception_handler const& exception,
+            invocation_mode< invokation_type::task > const&,
+            Args&& ... args)
+    {
+        // The coroutine takes the arguments and the current by value
+        (srv.*member)(::std::forward<Args>(args) ..., curr)
+                .then(response, exception);
+    }
+};
+
 template < typename Handler, typename IndexTuple, typename ... Args >
 struct remote_invocation;
 
@@ -329,38 +592,39 @@ struct remote_invocation< Handler,
                 ::std::get< Indexes >(args).get() ...);
     }
 
+    using invocation_data_ptr = ::std::shared_ptr< invocation_data >;
+
     /**
-     * Make a connection response callback for a non-void function invocation
-     * @param response
-     * @param exception
+     * Make a connection response callback for a non-void function invocation.
+     * The callback holds the invocation data rather than copies of the
+     * handlers, so that it fits the callback's inline storage.
+     * @param d
+     * @param opts
      * @param
      * @return
      */
-    template <typename ReplyHandler>
-    typename ::std::enable_if< (::psst::meta::function_traits< ReplyHandler >::arity > 0),
-        encoding::reply_callback >::type
-    make_callback(ReplyHandler response, exception_handler exception,
-            invocation_options const& opts, ::std::false_type const&) const
+    static encoding::reply_callback
+    make_callback(invocation_data_ptr const& d,
+            invocation_options const& opts, ::std::false_type const&)
     {
         using encoding::incoming;
-        using reply_traits = ::psst::meta::function_traits<ReplyHandler>;
-        using reply_tuple  = typename reply_traits::decayed_args_tuple_type;
-        if (response) {
+        using reply_tuple  = typename response_traits::decayed_args_tuple_type;
+        if (d->response) {
             if (opts.is_one_way()) {
                 ::std::ostringstream os;
                 os << "Cannot invoke a non-void function "
-                    << data->op << " on a one-way proxy";
+                    << d->op << " on a one-way proxy";
                 throw errors::invalid_one_way_invocation{os.str()};
             }
-            return [response, exception](incoming::const_iterator begin, incoming::const_iterator end) {
+            return [d](incoming::const_iterator begin, incoming::const_iterator end) {
                 try {
                     auto encaps = begin.incoming_encapsulation();
                     reply_tuple args;
                     encoding::read(begin, end, args);
                     encaps.read_indirection_table(begin);
-                    ::psst::meta::invoke(response, ::std::move(args));
+                    ::psst::meta::invoke(d->response, ::std::move(args));
                 } catch(...) {
-                    functional::report_exception(exception, ::std::current_exception());
+                    functional::report_exception(d->exception, ::std::current_exception());
                 }
             };
         }
@@ -369,20 +633,20 @@ struct remote_invocation< Handler,
 
     /**
      * Make a connection response callback for a void function invocation
-     * @param response
-     * @param exception
+     * @param d
+     * @param opts
      * @param
      * @return
      */
-    encoding::reply_callback
-    make_callback(response_hanlder response, exception_handler exception,
-            invocation_options const& opts, ::std::true_type const&) const
+    static encoding::reply_callback
+    make_callback(invocation_data_ptr const& d,
+            invocation_options const& opts, ::std::true_type const&)
     {
         using encoding::incoming;
-        if (response && !opts.is_one_way())
-            return [response, exception](incoming::const_iterator, incoming::const_iterator) {
+        if (d->response && !opts.is_one_way())
+            return [d](incoming::const_iterator, incoming::const_iterator) {
                 try {
-                    response();
+                    d->response();
                 } catch(...) {
                     // Don't report exception here, as the exception is the
                     // pair for the response and it will lead to setting shared
@@ -396,7 +660,7 @@ struct remote_invocation< Handler,
     void
     operator()(invocation_options const& opts) const
     {
-        auto reply = make_callback(data->response, data->exception, opts, is_void{});
+        auto reply = make_callback(data, opts, is_void{});
         if (opts.is_sync()) {
             try {
                 ref->get_connection(opts)->invoke(data->target, data->op, data->ctx, opts,
@@ -406,10 +670,13 @@ struct remote_invocation< Handler,
             }
         } else {
             auto d = data;
+            // The reply callback is made again in the connection callback
+            // instead of being captured there
             ref->get_connection_async(
-            [d, reply, opts](connection_ptr conn) {
+            [d, opts](connection_ptr conn) {
                 conn->invoke(d->target, d->op, d->ctx, opts,
-                    ::std::move(d->out), reply, d->exception, d->sent);
+                    ::std::move(d->out), make_callback(d, opts, is_void{}),
+                    d->exception, d->sent);
             },
             [d](::std::exception_ptr ex) {
                 functional::report_exception(d->exception, ex);
@@ -418,7 +685,7 @@ struct remote_invocation< Handler,
     }
 
     reference_const_ptr                     ref;
-    ::std::shared_ptr< invocation_data >    data;
+    invocation_data_ptr                     data;
 };
 
 }  /* namespace detail */
@@ -458,6 +725,57 @@ make_invocation(reference_const_ptr                     ref,
     }
 }
 
+/**
+ * Invoke an operation on the reference.
+ *
+ * If the servant of the reference lives in the same connector and
+ * implements the interface, the servant function is called directly in
+ * the calling thread, otherwise an invocation is made and called with
+ * the options.
+ */
+template < typename Handler, typename Member, typename ... Args>
+void
+invoke_operation(reference_const_ptr const&             ref,
+        encoding::operation_specs::operation_id const&  op,
+        context_type const&                             ctx,
+        Member                                          member,
+        Handler const&                                  response,
+        functional::exception_callback const&           exception,
+        functional::callback< bool > const&             sent,
+        invocation_options const&                       opts,
+        Args&& ...                                      args)
+{
+    using collocated        = detail::collocated_invocation< Handler, Member >;
+    using interface_type    = typename collocated::interface_type;
+    using index_type        = typename ::psst::meta::index_builder< sizeof ... (Args) >::type;
+    using remote_invocation = detail::remote_invocation< Handler, index_type, Args ... >;
+    using remote_args       = typename remote_invocation::invocation_args;
+    using local_invocation  = detail::local_invocation< Handler, Member, index_type, Args ... >;
+    using local_args        = typename local_invocation::invocation_args;
+
+    if (!ref)
+        throw errors::runtime_error{"Empty reference"};
+
+    auto target = ref->get_local_target< interface_type >();
+    if (target.servant) {
+        collocated::invoke(*ref, ::std::move(target), member, op, ctx,
+                response, exception, sent, opts, ::std::forward<Args>(args) ...);
+    } else if (target.object || target.adapter) {
+        // The servant doesn't implement the interface or is not found
+        local_invocation {
+            ref, member, op, ctx,
+            local_args{ args ... },
+            response, exception, sent
+        }(opts);
+    } else {
+        remote_invocation {
+            ref, op, ctx,
+            remote_args{ args ... },
+            response, exception, sent
+        }(opts);
+    }
+}
+
 }  /* namespace core */
 }  /* namespace wire */
 
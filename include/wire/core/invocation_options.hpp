@@ -11,6 +11,8 @@
 #include <functional>
 #include <future>
 
+#include <wire/util/spsc_future.hpp>
+
 namespace wire {
 namespace core {
 
@@ -18,6 +20,10 @@ enum class invocation_flags {
     none        = 0x00,
     sync        = 0x01,
     one_way     = 0x02,
+    /** Use the connection pool for bulk transfers */
+    bulk        = 0x04,
+    /** Send and dispatch ahead of normal invocations on the connection */
+    urgent      = 0x08,
     unspecified = 0x10
 };
 
@@ -47,7 +53,8 @@ operator ~ (invocation_flags val)
 {
     using integral_type = ::std::underlying_type<invocation_flags>::type;
     return static_cast<invocation_flags>(~static_cast< integral_type >(val))
-            & (invocation_flags::one_way | invocation_flags::sync | invocation_flags::unspecified);
+            & (invocation_flags::one_way | invocation_flags::sync | invocation_flags::bulk
+                    | invocation_flags::urgent | invocation_flags::unspecified);
 }
 
 constexpr inline invocation_flags&
@@ -136,6 +143,18 @@ struct invocation_options {
         return any(flags & invocation_flags::one_way);
     }
 
+    constexpr bool
+    is_bulk() const
+    {
+        return any(flags & invocation_flags::bulk);
+    }
+
+    constexpr bool
+    is_urgent() const
+    {
+        return any(flags & invocation_flags::urgent);
+    }
+
     constexpr bool
     dont_retry() const
     { return retries < 0; }
@@ -242,6 +261,10 @@ template <typename T>
 struct promise_invocation_flags<::std::promise<T>> :
         ::std::integral_constant<invocation_flags, invocation_flags::sync> {};
 
+template <typename T>
+struct promise_invocation_flags<util::spsc_promise<T>> :
+        ::std::integral_constant<invocation_flags, invocation_flags::sync> {};
+
 namespace functional {
 using invocation_function   = ::std::function< void(invocation_options const&) >;
 }  /* namespace functional */
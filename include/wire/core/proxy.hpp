@@ -82,7 +82,7 @@ public:
             invocation_options const& opts = invocation_options::unspecified) const
         -> decltype( ::std::declval<_Promise<connection_ptr>>().get_future() )
     {
-        auto promise = ::std::make_shared<_Promise<connection_ptr>>();
+        auto promise = make_promise<_Promise<connection_ptr>>();
 
         wire_get_connection_async(
             [promise](connection_ptr v)
@@ -158,7 +158,7 @@ public:
             invocation_options const&       opts    = invocation_options::unspecified  )
         -> decltype(::std::declval<_Promise<bool>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<bool> >();
+        auto promise = make_promise< _Promise<bool> >();
 
         wire_is_a_async(
             type_id,
@@ -202,7 +202,7 @@ public:
 
         -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
 
         if (opts.is_one_way()) {
             wire_ping_async(
@@ -264,7 +264,7 @@ public:
             invocation_options const&       opts    = invocation_options::unspecified  )
         -> decltype(::std::declval<_Promise<::std::string>>().get_future())
     {
-        auto promise = ::std::make_shared<_Promise<::std::string>>();
+        auto promise = make_promise<_Promise<::std::string>>();
 
         wire_type_async(
             [promise](::std::string&& val)
@@ -306,7 +306,7 @@ public:
             invocation_options const&        opts    = invocation_options::unspecified  )
         -> decltype(::std::declval<_Promise<::std::vector< ::std::string >>>().get_future())
     {
-        auto promise = ::std::make_shared<_Promise<::std::vector< ::std::string >>>();
+        auto promise = make_promise<_Promise<::std::vector< ::std::string >>>();
 
         wire_types_async(
             [promise](::std::vector< ::std::string >&& val)
@@ -489,7 +489,7 @@ checked_cast_async(::std::shared_ptr<SourcePrx>                 v,
     -> decltype(::std::declval<_Promise< ::std::shared_ptr<TargetPrx>>>().get_future())
 {
     using result_prx = ::std::shared_ptr<TargetPrx>;
-    auto promise = ::std::make_shared<_Promise<result_prx>>();
+    auto promise = make_promise<_Promise<result_prx>>();
 
     checked_cast_async<TargetPrx>(
         v,
@@ -26,6 +26,11 @@
 
 #include <wire/encoding/detail/optional_io.hpp>
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <typeinfo>
+
 namespace wire {
 namespace core {
 
@@ -88,6 +93,18 @@ id_facet_hash(reference_data const&);
 ::std::size_t
 hash(reference_data const&);
 
+/**
+ * Local servant of a reference cast to an interface.
+ */
+template < typename Interface >
+struct local_target {
+    /** Keeps the servant alive while the target is used */
+    object_ptr      object;
+    /** nullptr if the servant doesn't implement the interface */
+    Interface*      servant;
+    adapter_ptr     adapter;
+};
+
 /**
  * Class for a reference.
  */
@@ -95,6 +112,7 @@ class reference : public ::std::enable_shared_from_this<reference> {
 public:
     using connection_callback = functional::callback< connection_ptr >;
     using local_servant         = ::std::pair<object_ptr, adapter_ptr>;
+    using servant_cast          = void* (*)(object_ptr const&);
 public:
     reference(connector_ptr cn, reference_data const& ref)
         : connector_{cn}, ref_{ref} {}
@@ -112,6 +130,28 @@ public:
     is_local() const;
     local_servant
     get_local_object() const;
+    /**
+     * Get the local servant cast to the interface. The servant and the
+     * interface pointer are cached in the reference, the servant is cast
+     * only when the interface type differs from the cached one.
+     *
+     * If the reference is not local, both the object and the adapter of
+     * the result are empty. If the reference is local, but the object
+     * is not found, only the adapter is set.
+     */
+    template < typename Interface >
+    local_target< Interface >
+    get_local_target() const
+    {
+        local_target< Interface > res{ nullptr, nullptr, nullptr };
+        res.servant = static_cast< Interface* >(
+            get_local_target(res.object, res.adapter, typeid(Interface),
+                [](object_ptr const& obj) -> void*
+                {
+                    return dynamic_cast< Interface* >(obj.get());
+                }));
+        return res;
+    }
 
     identity const&
     object_id() const
@@ -144,7 +184,7 @@ public:
     get_connection_async(invocation_options const& opts = invocation_options::unspecified) const
         -> decltype(::std::declval< _Promise< connection_ptr > >().get_future() )
     {
-        auto promise = ::std::make_shared< _Promise< connection_ptr > >();
+        auto promise = make_promise< _Promise< connection_ptr > >();
         get_connection_async(
             [promise](connection_ptr val)
             {
@@ -173,6 +213,10 @@ public:
     void
     set_locator(reference_data const& loc_ref);
 protected:
+    void*
+    get_local_target(object_ptr& obj, adapter_ptr& adapter,
+            ::std::type_info const& type, servant_cast cast) const;
+
     template < typename T >
     ::std::shared_ptr<T>
     shared_this()
@@ -189,8 +233,50 @@ private:
     connector_weak_ptr  connector_;
 protected:
     reference_data              ref_;
-    object_weak_ptr mutable     local_object_cache_;
-    adapter_weak_ptr mutable    adapter_cache_;
+private:
+    /**
+     * Cached local servant, an entry is not modified after it is
+     * published, so it is read without locking.
+     */
+    struct local_entry {
+        object_weak_ptr             object;
+        adapter_weak_ptr            adapter;
+        void*                       servant;
+        ::std::type_info const*     servant_type;
+    };
+    /**
+     * Cache of the local servant, is not copied with the reference.
+     *
+     * Readers load the current entry, writers publish a new one under the
+     * mutex. Replaced entries are kept until the reference is destroyed
+     * as a reader can still use them, an entry for the same servant and
+     * interface is reused, so there is one entry per interface and
+     * servant the reference resolved to.
+     */
+    struct local_cache {
+        local_cache() = default;
+        local_cache(local_cache const&) {}
+        local_cache&
+        operator = (local_cache const&)
+        { return *this; }
+
+        using mutex_type    = ::std::mutex;
+        using lock_guard    = ::std::lock_guard< mutex_type >;
+
+        local_entry const*
+        get() const
+        {
+            return current.load(::std::memory_order_acquire);
+        }
+        void
+        set(object_ptr const& obj, adapter_ptr const& adapter,
+                void* servant, ::std::type_info const* type);
+
+        mutex_type                          mutex;
+        ::std::atomic< local_entry const* > current{nullptr};
+        ::std::list< local_entry >          entries;
+    };
+    local_cache mutable         local_cache_;
 };
 
 /**
@@ -212,9 +298,28 @@ public:
 private:
     using mutex_type                        = ::std::mutex;
     using lock_guard                        = ::std::lock_guard<mutex_type>;
+    using endpoint_rotation_type            = endpoint_rotation< endpoint_list >;
+    using endpoint_rotation_ptr             = ::std::shared_ptr< endpoint_rotation_type >;
+
+    /**
+     * Connection the reference uses and the endpoint it was made to.
+     * Normal and bulk invocations use connections from different pools.
+     */
+    struct cached_connection {
+        connection_weak_ptr     connection;
+        endpoint                ep;
+    };
+
+    cached_connection&
+    cache(bool bulk) const
+    { return bulk ? bulk_connection_ : connection_; }
+    bool
+    pooled(bool bulk) const;
+
     mutex_type mutable                      mutex_;
-    connection_weak_ptr mutable             connection_;
-    endpoint_list::const_iterator mutable   current_;
+    cached_connection mutable               connection_;
+    cached_connection mutable               bulk_connection_;
+    endpoint_rotation_ptr                   endpoints_;
 };
 
 /**
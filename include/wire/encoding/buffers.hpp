@@ -12,6 +12,7 @@
 #include <wire/encoding/wire_io.hpp>
 #include <wire/encoding/message.hpp>
 #include <wire/core/connector_fwd.hpp>
+#include <wire/core/functional.hpp>
 #include <wire/encoding/detail/buffer_sequence.hpp>
 
 #include <memory>
@@ -85,6 +86,11 @@ public:
 
     message::message_flags
     type() const;
+    /**
+     * Message header flags including the type
+     */
+    message::message_flags
+    flags() const;
     //@{
     /**
      * @name Container concept
@@ -372,8 +378,8 @@ using incoming_ptr = ::std::shared_ptr<incoming>;
 
 // TODO Chage the signature to an encapsulation
 using reply_callback
-        = ::std::function< void(incoming::const_iterator, incoming::const_iterator) >;
-using request_result_callback = ::std::function< void(outgoing&&) >;
+        = core::functional::callback< incoming::const_iterator, incoming::const_iterator >;
+using request_result_callback = core::functional::callback< outgoing&& >;
 
 }  // namespace encoding
 }  // namespace wire
@@ -112,6 +112,7 @@ struct message {
         // Flags
         protocol            = 8,        /**< Message header contains protocol version */
         encoding            = 0x10,     /**< Message header contains encoding version */
+        urgent              = 0x20,     /**< Request is dispatched ahead of normal ones, since protocol 0.2 */
 
         // Combinations
         validate_flags      = validate | protocol | encoding,
@@ -166,6 +167,14 @@ struct message {
     }
 };
 
+inline message::message_flags
+operator | (message::message_flags lhs, message::message_flags rhs)
+{
+    using integral_type = ::std::underlying_type<message::message_flags>::type;
+    return static_cast<message::message_flags>(
+            static_cast<integral_type>(lhs) | static_cast<integral_type>(rhs) );
+}
+
 ::std::ostream&
 operator << (::std::ostream& out, message::message_flags val);
 
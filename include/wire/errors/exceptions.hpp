@@ -97,6 +97,29 @@ public:
     request_timed_out(T const& ... args) : runtime_error(args ...) {}
 };
 
+/**
+ * The connection's request window is full and the invocation cannot be
+ * queued
+ */
+class request_overflow : public runtime_error {
+public:
+    request_overflow(std::string const& msg) : runtime_error{msg} {}
+    request_overflow(char const* msg) : runtime_error{msg} {}
+    template < typename ... T >
+    request_overflow(T const& ... args) : runtime_error(args ...) {}
+};
+
+/**
+ * The request uses a feature the peer's protocol version doesn't have
+ */
+class unsupported_feature : public runtime_error {
+public:
+    unsupported_feature(std::string const& msg) : runtime_error{msg} {}
+    unsupported_feature(char const* msg) : runtime_error{msg} {}
+    template < typename ... T >
+    unsupported_feature(T const& ... args) : runtime_error(args ...) {}
+};
+
 class invalid_one_way_invocation : public runtime_error {
 public:
     invalid_one_way_invocation(std::string const& msg) : runtime_error{msg} {}
@@ -11,9 +11,10 @@
 #ifdef WITH_BOOST_FIBERS
 #include <boost/fiber/future.hpp>
 #include <boost/fiber/fiber.hpp>
-#else
-#include <future>
 #endif
+#include <future>
+#include <memory>
+#include <wire/util/spsc_future.hpp>
 
 namespace wire {
 
@@ -23,9 +24,42 @@ using promise = ::boost::fibers::promise< _Res >;
 using fiber = ::boost::fibers::fiber;
 #else
 template < typename _Res >
-using promise = ::std::promise< _Res >;
+using promise = util::spsc_promise< _Res >;
 #endif
 
+/**
+ * Pointer to a promise shared between the result and exception callbacks
+ * of an async call.
+ */
+template < typename _Promise >
+struct promise_traits {
+    using pointer = ::std::shared_ptr< _Promise >;
+
+    static pointer
+    make()
+    {
+        return ::std::make_shared< _Promise >();
+    }
+};
+
+template < typename _Res >
+struct promise_traits< util::spsc_promise< _Res > > {
+    using pointer = util::spsc_promise_ptr< _Res >;
+
+    static pointer
+    make()
+    {
+        return pointer::create();
+    }
+};
+
+template < typename _Promise >
+typename promise_traits< _Promise >::pointer
+make_promise()
+{
+    return promise_traits< _Promise >::make();
+}
+
 } /* namespace wire */
 
 
@@ -10,42 +10,42 @@
 
 #include <wire/future_config.hpp>
 #include <wire/asio_config.hpp>
+#include <wire/util/fiber_scheduler.hpp>
+#include <wire/util/detail/io_service_wait_thread.hpp>
 
 namespace wire {
 namespace util {
+namespace detail {
 
+/**
+ * If the calling thread runs the io_service with the fiber scheduler, the
+ * calling fiber yields until the condition is met and the handlers are run
+ * by the scheduler. Otherwise the io_service is polled in a thread.
+ */
 template < typename Pred >
 void
-run_while( asio_config::io_service_ptr svc, Pred pred )
+fiber_run_while( asio_config::io_service_ptr svc, Pred pred )
 {
-//    namespace this_fiber = ::boost::this_fiber;
-//    fiber f{
-//        [svc, pred](){
-//            while(pred()) {
-//                ::std::cerr << "Run while fiber\n";
-//                svc->poll();
-//                this_fiber::yield();
-//            }
-//        }};
-//    f.join();
+    auto algo = fiber::io_service_algorithm::current();
+    if (algo && algo->io_service() == svc) {
+        namespace this_fiber = ::boost::this_fiber;
+        while(pred()) {
+            svc->poll();
+            this_fiber::yield();
+        }
+    } else {
+        thread_run_while(svc, pred);
+    }
 }
 
 template < typename Pred >
 void
-run_until( asio_config::io_service_ptr svc, Pred pred)
+fiber_run_until( asio_config::io_service_ptr svc, Pred pred)
 {
-//    namespace this_fiber = ::boost::this_fiber;
-//    fiber f{
-//        [svc, pred](){
-//            while(!pred()) {
-//                ::std::cerr << "Run until fiber\n";
-//                svc->poll();
-//                this_fiber::yield();
-//            }
-//        }};
-//    f.join();
+    fiber_run_while(svc, [pred](){ return !pred(); });
 }
 
+} /* namespace detail */
 } /* namespace util */
 } /* namespace wire */
 
@@ -14,11 +14,11 @@
 
 namespace wire {
 namespace util {
-
+namespace detail {
 
 template < typename Pred >
 void
-run_while( asio_config::io_service_ptr svc, Pred pred )
+thread_run_while( asio_config::io_service_ptr svc, Pred pred )
 {
     asio_config::io_service::work w(*svc);
     ::std::thread t{
@@ -34,7 +34,7 @@ run_while( asio_config::io_service_ptr svc, Pred pred )
 
 template < typename Pred >
 void
-run_until( asio_config::io_service_ptr svc, Pred pred)
+thread_run_until( asio_config::io_service_ptr svc, Pred pred)
 {
     asio_config::io_service::work w(*svc);
     ::std::thread t{
@@ -48,6 +48,7 @@ run_until( asio_config::io_service_ptr svc, Pred pred)
     DEBUG_LOG(3, "*** End wait done (until condition)");
 }
 
+}  /* namespace detail */
 }  /* namespace util */
 }  /* namespace wire */
 
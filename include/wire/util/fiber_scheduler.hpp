@@ -0,0 +1,256 @@
+/*
+ * fiber_scheduler.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_UTIL_FIBER_SCHEDULER_HPP_
+#define WIRE_UTIL_FIBER_SCHEDULER_HPP_
+
+#include <wire/asio_config.hpp>
+
+#include <boost/asio/version.hpp>
+#include <boost/fiber/algo/algorithm.hpp>
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/operations.hpp>
+#include <boost/fiber/type.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+static_assert(BOOST_ASIO_VERSION >= 101100,
+        "Fiber scheduler requires Boost.Asio 1.11 (Boost 1.66) or later");
+
+namespace wire {
+namespace util {
+namespace fiber {
+
+/**
+ * Fiber scheduling algorithm running the handlers of an io_service in the
+ * thread it is installed to.
+ *
+ * The fibers are scheduled round robin and never leave the thread they
+ * were started in. A fiber waiting for a reply is parked on the fiber
+ * future and doesn't consume the thread, so a thread can serve thousands
+ * of fibers making synchronous calls.
+ *
+ * Several threads can install the algorithm for the same io_service, in
+ * this case the handler resuming a fiber can run in another thread and
+ * the fiber is resumed after the handler posted by notify or after the
+ * max_wait interval, whichever comes first.
+ *
+ * Usage synopsis:
+ *
+ * @code
+ * auto& sched = ::wire::util::fiber::use_io_service_algorithm( io_svc );
+ * ::boost::fibers::fiber{ [&](){ prx->wire_ping(); io_svc->stop(); } }.detach();
+ * sched.run();
+ * @endcode
+ */
+class io_service_algorithm : public ::boost::fibers::algo::algorithm {
+public:
+    using context       = ::boost::fibers::context;
+    using context_type  = ::boost::fibers::type;
+    using clock_type    = ::std::chrono::steady_clock;
+    using time_point    = clock_type::time_point;
+    using duration      = clock_type::duration;
+public:
+    explicit
+    io_service_algorithm(asio_config::io_service_ptr svc,
+            duration max_wait = ::std::chrono::milliseconds{1})
+        : io_service_{svc}, max_wait_{max_wait}
+    {
+        current_ref() = this;
+    }
+
+    ~io_service_algorithm()
+    {
+        if (current_ref() == this)
+            current_ref() = nullptr;
+    }
+
+    io_service_algorithm(io_service_algorithm const&) = delete;
+    io_service_algorithm&
+    operator = (io_service_algorithm const&) = delete;
+
+    /**
+     * Algorithm installed in the calling thread, nullptr if the thread
+     * doesn't run an io_service scheduler.
+     */
+    static io_service_algorithm*
+    current() noexcept
+    { return current_ref(); }
+
+    asio_config::io_service_ptr const&
+    io_service() const noexcept
+    { return io_service_; }
+
+    /**
+     * Run the io_service handlers and the ready fibers until the
+     * io_service is stopped. Must be called by the main fiber of the
+     * thread.
+     *
+     * Exceptions thrown by the handlers are propagated to the caller.
+     */
+    void
+    run()
+    {
+        asio_config::io_service::work w{ *io_service_ };
+        while (!io_service_->stopped()) {
+            rethrow_handler_exception();
+            if (ready_workers_ > 0) {
+                io_service_->poll();
+            } else {
+                wait_io(time_point::max());
+            }
+            // Let the scheduler resume the fibers woken up by other
+            // threads and the sleeping ones
+            ::boost::this_fiber::yield();
+        }
+        rethrow_handler_exception();
+    }
+
+    //@{
+    /** @name Scheduling algorithm interface */
+    void
+    awakened(context* ctx) noexcept override
+    {
+        if (!ctx->is_context(context_type::dispatcher_context))
+            ++ready_workers_;
+        ready_.push_back(ctx);
+    }
+
+    context*
+    pick_next() noexcept override
+    {
+        if (ready_.empty())
+            return nullptr;
+        context* ctx = ready_.front();
+        ready_.pop_front();
+        if (!ctx->is_context(context_type::dispatcher_context))
+            --ready_workers_;
+        return ctx;
+    }
+
+    bool
+    has_ready_fibers() const noexcept override
+    {
+        return !ready_.empty();
+    }
+
+    /**
+     * Called by the scheduler when all fibers of the thread are parked,
+     * e.g. the main fiber joins a fiber instead of calling run. Runs the
+     * io_service handlers until a fiber is resumed or the time point is
+     * reached.
+     */
+    void
+    suspend_until(time_point const& tp) noexcept override
+    {
+        while (ready_.empty() && clock_type::now() < tp) {
+            if (!wait_io(tp))
+                break;
+        }
+    }
+
+    void
+    notify() noexcept override
+    {
+        notified_.store(true, ::std::memory_order_release);
+        try {
+            io_service_->post([](){});
+        } catch (...) {}
+        {
+            ::std::lock_guard< ::std::mutex > lock{mtx_};
+        }
+        cnd_.notify_all();
+    }
+    //@}
+private:
+    static io_service_algorithm*&
+    current_ref() noexcept
+    {
+        static thread_local io_service_algorithm* algo = nullptr;
+        return algo;
+    }
+
+    /**
+     * Run at most one io_service handler, wait not longer than max_wait
+     * interval.
+     * @return false if the wait was interrupted by notify
+     */
+    bool
+    wait_io(time_point tp) noexcept
+    {
+        if (notified_.exchange(false, ::std::memory_order_acq_rel))
+            return false;
+        auto deadline = ::std::min(tp, clock_type::now() + max_wait_);
+        if (io_service_->stopped()) {
+            ::std::unique_lock< ::std::mutex > lock{mtx_};
+            cnd_.wait_until(lock, deadline, [this](){
+                return notified_.load(::std::memory_order_acquire); });
+            return !notified_.exchange(false, ::std::memory_order_acq_rel);
+        }
+        try {
+            io_service_->run_one_until(deadline);
+        } catch (...) {
+            if (!handler_exception_)
+                handler_exception_ = ::std::current_exception();
+        }
+        return !notified_.exchange(false, ::std::memory_order_acq_rel);
+    }
+
+    void
+    rethrow_handler_exception()
+    {
+        if (handler_exception_) {
+            auto ex = handler_exception_;
+            handler_exception_ = nullptr;
+            ::std::rethrow_exception(ex);
+        }
+    }
+private:
+    asio_config::io_service_ptr     io_service_;
+    duration const                  max_wait_;
+
+    ::std::deque< context* >        ready_;
+    ::std::size_t                   ready_workers_ = 0;
+
+    ::std::atomic< bool >           notified_{false};
+    ::std::mutex                    mtx_;
+    ::std::condition_variable       cnd_;
+    ::std::exception_ptr            handler_exception_;
+};
+
+/**
+ * Install the io_service scheduling algorithm to the calling thread.
+ * @return Reference to the algorithm, it is owned by the fiber scheduler
+ *      of the thread
+ */
+inline io_service_algorithm&
+use_io_service_algorithm(asio_config::io_service_ptr svc)
+{
+    ::boost::fibers::use_scheduling_algorithm< io_service_algorithm >(svc);
+    return *io_service_algorithm::current();
+}
+
+/**
+ * Run the io_service and fibers in the calling thread until the io_service
+ * is stopped.
+ */
+inline void
+run(asio_config::io_service_ptr svc)
+{
+    use_io_service_algorithm(svc).run();
+}
+
+}  /* namespace fiber */
+}  /* namespace util */
+}  /* namespace wire */
+
+#endif /* WIRE_UTIL_FIBER_SCHEDULER_HPP_ */
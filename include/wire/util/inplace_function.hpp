@@ -0,0 +1,347 @@
+/*
+ * inplace_function.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_UTIL_INPLACE_FUNCTION_HPP_
+#define WIRE_UTIL_INPLACE_FUNCTION_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wire {
+namespace util {
+
+constexpr ::std::size_t inplace_function_default_capacity = 64;
+
+template < typename Signature,
+        ::std::size_t Capacity = inplace_function_default_capacity >
+class inplace_function;
+
+namespace detail {
+
+template < typename ... T >
+struct make_void {
+    using type = void;
+};
+
+template < typename ... T >
+using void_t = typename make_void< T... >::type;
+
+template < typename F, typename R, typename Args, typename = void >
+struct is_callable_r : ::std::false_type {};
+
+template < typename F, typename R, typename ... Args >
+struct is_callable_r< F, R, void(Args...),
+        void_t< decltype( ::std::declval<F&>()(::std::declval<Args>()...) ) > >
+    : ::std::integral_constant< bool,
+          ::std::is_void<R>::value ||
+          ::std::is_convertible<
+              decltype( ::std::declval<F&>()(::std::declval<Args>()...) ), R >::value > {};
+
+//@{
+/** @name Empty callable objects */
+template < typename F >
+bool
+is_null_callable(F const&)
+{
+    return false;
+}
+
+template < typename T >
+bool
+is_null_callable(T* f)
+{
+    return f == nullptr;
+}
+
+template < typename Signature >
+bool
+is_null_callable(::std::function< Signature > const& f)
+{
+    return !f;
+}
+
+template < typename Signature, ::std::size_t Capacity >
+bool
+is_null_callable(inplace_function< Signature, Capacity > const& f)
+{
+    return !f;
+}
+//@}
+
+}  /* namespace detail */
+
+/**
+ * Copyable type erased function wrapper storing the target in an inline
+ * buffer of Capacity bytes.
+ *
+ * Unlike ::std::function the target is not required to be trivially
+ * copyable to be stored inline, only to fit the buffer and to be nothrow
+ * move constructible. Larger targets are allocated in the heap.
+ */
+template < typename R, typename ... Args, ::std::size_t Capacity >
+class inplace_function< R(Args...), Capacity > {
+public:
+    using result_type   = R;
+    static constexpr ::std::size_t capacity    = Capacity;
+    static constexpr ::std::size_t alignment   = alignof(::std::max_align_t);
+
+    template < typename F >
+    using stored_inline = ::std::integral_constant< bool,
+            sizeof(F) <= capacity && alignof(F) <= alignment &&
+            ::std::is_nothrow_move_constructible<F>::value >;
+public:
+    inplace_function() noexcept
+        : vtable_{nullptr} {}
+    inplace_function(::std::nullptr_t) noexcept
+        : vtable_{nullptr} {}
+
+    inplace_function(inplace_function const& rhs)
+        : vtable_{nullptr}
+    {
+        if (rhs.vtable_) {
+            rhs.vtable_->copy(&storage_, &rhs.storage_);
+            vtable_ = rhs.vtable_;
+        }
+    }
+    inplace_function(inplace_function&& rhs) noexcept
+        : vtable_{nullptr}
+    {
+        move_from(rhs);
+    }
+
+    template < typename F,
+        typename Fn = typename ::std::decay<F>::type,
+        typename = typename ::std::enable_if<
+            !::std::is_same< Fn, inplace_function >::value &&
+            detail::is_callable_r< Fn, R, void(Args...) >::value >::type >
+    inplace_function(F&& f)
+        : vtable_{nullptr}
+    {
+        if (!detail::is_null_callable(f)) {
+            construct< Fn >(::std::forward<F>(f), stored_inline<Fn>{});
+        }
+    }
+
+    ~inplace_function()
+    {
+        clear();
+    }
+
+    inplace_function&
+    operator = (inplace_function const& rhs)
+    {
+        if (this != &rhs) {
+            inplace_function tmp{rhs};
+            clear();
+            move_from(tmp);
+        }
+        return *this;
+    }
+    inplace_function&
+    operator = (inplace_function&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            clear();
+            move_from(rhs);
+        }
+        return *this;
+    }
+    inplace_function&
+    operator = (::std::nullptr_t) noexcept
+    {
+        clear();
+        return *this;
+    }
+    template < typename F,
+        typename Fn = typename ::std::decay<F>::type,
+        typename = typename ::std::enable_if<
+            !::std::is_same< Fn, inplace_function >::value &&
+            detail::is_callable_r< Fn, R, void(Args...) >::value >::type >
+    inplace_function&
+    operator = (F&& f)
+    {
+        inplace_function tmp{ ::std::forward<F>(f) };
+        clear();
+        move_from(tmp);
+        return *this;
+    }
+
+    void
+    swap(inplace_function& rhs) noexcept
+    {
+        inplace_function tmp{ ::std::move(rhs) };
+        rhs.move_from(*this);
+        move_from(tmp);
+    }
+
+    explicit
+    operator bool() const noexcept
+    { return vtable_ != nullptr; }
+
+    R
+    operator()(Args ... args) const
+    {
+        if (!vtable_)
+            throw ::std::bad_function_call{};
+        return vtable_->invoke(const_cast<storage_type*>(&storage_),
+                ::std::forward<Args>(args)...);
+    }
+private:
+    using storage_type = typename ::std::aligned_storage< capacity, alignment >::type;
+
+    struct vtable_type {
+        R       (*invoke)(storage_type*, Args&& ...);
+        void    (*copy)(storage_type*, storage_type const*);
+        /** Move construct the target and destroy the source */
+        void    (*move)(storage_type*, storage_type*) noexcept;
+        void    (*destroy)(storage_type*) noexcept;
+    };
+
+    template < typename F >
+    struct inline_target {
+        static F*
+        get(storage_type* s)
+        { return reinterpret_cast<F*>(s); }
+        static F const*
+        get(storage_type const* s)
+        { return reinterpret_cast<F const*>(s); }
+
+        static R
+        invoke(storage_type* s, Args&& ... args)
+        { return (*get(s))(::std::forward<Args>(args)...); }
+        static void
+        copy(storage_type* dst, storage_type const* src)
+        { new (dst) F( *get(src) ); }
+        static void
+        move(storage_type* dst, storage_type* src) noexcept
+        {
+            new (dst) F( ::std::move(*get(src)) );
+            get(src)->~F();
+        }
+        static void
+        destroy(storage_type* s) noexcept
+        { get(s)->~F(); }
+
+        static constexpr vtable_type vtable{ &invoke, &copy, &move, &destroy };
+    };
+
+    template < typename F >
+    struct heap_target {
+        static F*&
+        get(storage_type* s)
+        { return *reinterpret_cast<F**>(s); }
+        static F const*
+        get(storage_type const* s)
+        { return *reinterpret_cast<F* const*>(s); }
+
+        static R
+        invoke(storage_type* s, Args&& ... args)
+        { return (*get(s))(::std::forward<Args>(args)...); }
+        static void
+        copy(storage_type* dst, storage_type const* src)
+        { new (dst) F*{ new F( *get(src) ) }; }
+        static void
+        move(storage_type* dst, storage_type* src) noexcept
+        { new (dst) F*{ get(src) }; }
+        static void
+        destroy(storage_type* s) noexcept
+        { delete get(s); }
+
+        static constexpr vtable_type vtable{ &invoke, &copy, &move, &destroy };
+    };
+
+    template < typename Fn, typename F >
+    void
+    construct(F&& f, ::std::true_type)
+    {
+        new (&storage_) Fn( ::std::forward<F>(f) );
+        vtable_ = &inline_target<Fn>::vtable;
+    }
+    template < typename Fn, typename F >
+    void
+    construct(F&& f, ::std::false_type)
+    {
+        new (&storage_) Fn*{ new Fn( ::std::forward<F>(f) ) };
+        vtable_ = &heap_target<Fn>::vtable;
+    }
+
+    void
+    move_from(inplace_function& rhs) noexcept
+    {
+        if (rhs.vtable_) {
+            rhs.vtable_->move(&storage_, &rhs.storage_);
+            vtable_ = rhs.vtable_;
+            rhs.vtable_ = nullptr;
+        }
+    }
+
+    void
+    clear() noexcept
+    {
+        if (vtable_) {
+            vtable_->destroy(&storage_);
+            vtable_ = nullptr;
+        }
+    }
+private:
+    storage_type        storage_;
+    vtable_type const*  vtable_;
+};
+
+template < typename R, typename ... Args, ::std::size_t Capacity >
+template < typename F >
+constexpr typename inplace_function< R(Args...), Capacity >::vtable_type
+inplace_function< R(Args...), Capacity >::inline_target<F>::vtable;
+
+template < typename R, typename ... Args, ::std::size_t Capacity >
+template < typename F >
+constexpr typename inplace_function< R(Args...), Capacity >::vtable_type
+inplace_function< R(Args...), Capacity >::heap_target<F>::vtable;
+
+template < typename Signature, ::std::size_t Capacity >
+void
+swap(inplace_function< Signature, Capacity >& lhs,
+        inplace_function< Signature, Capacity >& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template < typename Signature, ::std::size_t Capacity >
+bool
+operator == (inplace_function< Signature, Capacity > const& f, ::std::nullptr_t) noexcept
+{
+    return !f;
+}
+
+template < typename Signature, ::std::size_t Capacity >
+bool
+operator == (::std::nullptr_t, inplace_function< Signature, Capacity > const& f) noexcept
+{
+    return !f;
+}
+
+template < typename Signature, ::std::size_t Capacity >
+bool
+operator != (inplace_function< Signature, Capacity > const& f, ::std::nullptr_t) noexcept
+{
+    return static_cast<bool>(f);
+}
+
+template < typename Signature, ::std::size_t Capacity >
+bool
+operator != (::std::nullptr_t, inplace_function< Signature, Capacity > const& f) noexcept
+{
+    return static_cast<bool>(f);
+}
+
+}  /* namespace util */
+}  /* namespace wire */
+
+#endif /* WIRE_UTIL_INPLACE_FUNCTION_HPP_ */
@@ -8,6 +8,44 @@
 #ifndef WIRE_UTIL_IO_SERVICE_WAIT_HPP_
 #define WIRE_UTIL_IO_SERVICE_WAIT_HPP_
 
+#ifdef WITH_BOOST_FIBERS
+#include <wire/util/detail/io_service_wait_fiber.hpp>
+#else
 #include <wire/util/detail/io_service_wait_thread.hpp>
+#endif
+
+namespace wire {
+namespace util {
+
+/**
+ * Run the io_service handlers while the predicate is true.
+ */
+template < typename Pred >
+void
+run_while( asio_config::io_service_ptr svc, Pred pred )
+{
+#ifdef WITH_BOOST_FIBERS
+    detail::fiber_run_while(svc, pred);
+#else
+    detail::thread_run_while(svc, pred);
+#endif
+}
+
+/**
+ * Run the io_service handlers until the predicate is true.
+ */
+template < typename Pred >
+void
+run_until( asio_config::io_service_ptr svc, Pred pred)
+{
+#ifdef WITH_BOOST_FIBERS
+    detail::fiber_run_until(svc, pred);
+#else
+    detail::thread_run_until(svc, pred);
+#endif
+}
+
+}  /* namespace util */
+}  /* namespace wire */
 
 #endif /* WIRE_UTIL_IO_SERVICE_WAIT_HPP_ */
@@ -0,0 +1,622 @@
+/*
+ * spsc_future.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_UTIL_SPSC_FUTURE_HPP_
+#define WIRE_UTIL_SPSC_FUTURE_HPP_
+
+#include <wire/util/inplace_function.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wire {
+namespace util {
+
+/**
+ * Number of times a future checks the result before parking the waiting
+ * thread.
+ */
+constexpr ::std::size_t spsc_default_spin_count = 1024;
+
+template < typename T >
+class spsc_future;
+template < typename T >
+class spsc_promise;
+template < typename T >
+class spsc_promise_ptr;
+
+namespace detail {
+
+template < typename T >
+class spsc_value_storage {
+public:
+    spsc_value_storage() = default;
+    spsc_value_storage(spsc_value_storage const&) = delete;
+    spsc_value_storage&
+    operator = (spsc_value_storage const&) = delete;
+
+    ~spsc_value_storage()
+    {
+        if (has_value_)
+            get()->~T();
+    }
+
+    template < typename ... Args >
+    void
+    emplace(Args&& ... args)
+    {
+        new (&storage_) T( ::std::forward<Args>(args)... );
+        has_value_ = true;
+    }
+
+    T
+    take()
+    {
+        return ::std::move(*get());
+    }
+private:
+    T*
+    get()
+    { return reinterpret_cast<T*>(&storage_); }
+
+    using storage_type = typename ::std::aligned_storage<
+            sizeof(T), alignof(T) >::type;
+    storage_type    storage_;
+    bool            has_value_ = false;
+};
+
+template <>
+class spsc_value_storage<void> {
+public:
+    void
+    emplace() {}
+    void
+    take() {}
+};
+
+/**
+ * Shared state of a single producer single consumer future.
+ *
+ * The result is stored inline, readiness is an atomic flag. The consumer
+ * spins a bit waiting for the result and parks on a condition variable
+ * only if the result is still not there, the producer touches the mutex
+ * only when there is a parked consumer.
+ *
+ * The state is reference counted, producer references are counted
+ * separately so that the future gets a broken_promise error when all of
+ * the producers are gone without setting the result.
+ */
+template < typename T >
+class spsc_state {
+public:
+    using value_type        = T;
+    using continuation_type = inplace_function< void() >;
+
+    spsc_state() = default;
+    spsc_state(spsc_state const&) = delete;
+    spsc_state&
+    operator = (spsc_state const&) = delete;
+
+    //@{
+    /** @name Producer interface */
+    spsc_future<T>
+    get_future()
+    {
+        if (status_.fetch_or(retrieved, ::std::memory_order_relaxed) & retrieved)
+            throw ::std::future_error{ ::std::future_errc::future_already_retrieved };
+        return spsc_future<T>{ this };
+    }
+
+    template < typename ... Args >
+    void
+    set_value(Args&& ... args)
+    {
+        claim();
+        value_.emplace(::std::forward<Args>(args)...);
+        publish();
+    }
+
+    void
+    set_exception(::std::exception_ptr ex)
+    {
+        claim();
+        exception_ = ::std::move(ex);
+        publish();
+    }
+    //@}
+
+    //@{
+    /** @name Consumer interface */
+    bool
+    is_ready() const noexcept
+    {
+        return status_.load(::std::memory_order_acquire) & ready;
+    }
+
+    void
+    wait(::std::size_t spin_count)
+    {
+        for (::std::size_t n = 0; n < spin_count; ++n) {
+            if (is_ready())
+                return;
+        }
+        lock_type lock{mtx_};
+        if (park())
+            return;
+        cond_.wait(lock, [this](){ return is_ready(); });
+    }
+
+    template < typename Clock, typename Duration >
+    ::std::future_status
+    wait_until(::std::chrono::time_point<Clock, Duration> const& tp)
+    {
+        if (is_ready())
+            return ::std::future_status::ready;
+        lock_type lock{mtx_};
+        if (park())
+            return ::std::future_status::ready;
+        return cond_.wait_until(lock, tp, [this](){ return is_ready(); })
+                ? ::std::future_status::ready : ::std::future_status::timeout;
+    }
+
+    /**
+     * Get the result, must be called only after the state is ready
+     */
+    T
+    take()
+    {
+        if (exception_)
+            ::std::rethrow_exception(exception_);
+        return value_.take();
+    }
+
+    /**
+     * Set a function to call when the result is ready. If the result is
+     * already there the function is called immediately.
+     * Takes over the caller's reference to the state, the reference is
+     * released after the function is called.
+     */
+    void
+    then(continuation_type&& cont)
+    {
+        continuation_ = ::std::move(cont);
+        if (status_.fetch_or(has_continuation, ::std::memory_order_acq_rel) & ready)
+            run_continuation();
+    }
+    //@}
+
+    //@{
+    /** @name Reference counting */
+    void
+    add_ref() noexcept
+    {
+        refs_.fetch_add(1, ::std::memory_order_relaxed);
+    }
+    void
+    release() noexcept
+    {
+        if (refs_.fetch_sub(1, ::std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+    void
+    add_producer() noexcept
+    {
+        producers_.fetch_add(1, ::std::memory_order_relaxed);
+        add_ref();
+    }
+    void
+    release_producer() noexcept
+    {
+        if (producers_.fetch_sub(1, ::std::memory_order_acq_rel) == 1
+                && !(status_.fetch_or(satisfied, ::std::memory_order_relaxed) & satisfied)) {
+            exception_ = ::std::make_exception_ptr(
+                    ::std::future_error{ ::std::future_errc::broken_promise });
+            publish();
+        }
+        release();
+    }
+    //@}
+private:
+    using mutex_type    = ::std::mutex;
+    using lock_type     = ::std::unique_lock< mutex_type >;
+
+    enum status_bits : unsigned {
+        /** The producer started setting the result */
+        satisfied           = 0x01,
+        /** The result is published */
+        ready               = 0x02,
+        /** The future was retrieved */
+        retrieved           = 0x04,
+        /** The consumer is parked on the condition variable */
+        waiting             = 0x08,
+        /** The consumer set a continuation */
+        has_continuation    = 0x10
+    };
+
+    void
+    claim()
+    {
+        if (status_.fetch_or(satisfied, ::std::memory_order_relaxed) & satisfied)
+            throw ::std::future_error{ ::std::future_errc::promise_already_satisfied };
+    }
+
+    /**
+     * Mark the consumer as waiting, must be called with the mutex locked.
+     * @return true if the result is ready and the consumer must not wait
+     */
+    bool
+    park()
+    {
+        return status_.fetch_or(waiting, ::std::memory_order_acq_rel) & ready;
+    }
+
+    void
+    publish()
+    {
+        auto prev = status_.fetch_or(ready, ::std::memory_order_acq_rel);
+        if (prev & waiting) {
+            lock_type lock{mtx_};
+            cond_.notify_one();
+        }
+        if (prev & has_continuation)
+            run_continuation();
+    }
+
+    void
+    run_continuation()
+    {
+        try {
+            continuation_();
+        } catch (...) {}
+        release();
+    }
+private:
+    ::std::atomic< unsigned >       status_{0};
+    ::std::atomic< ::std::size_t >  refs_{0};
+    ::std::atomic< ::std::size_t >  producers_{0};
+    spsc_value_storage< T >         value_;
+    ::std::exception_ptr            exception_;
+    continuation_type               continuation_;
+    mutex_type                      mtx_;
+    ::std::condition_variable       cond_;
+};
+
+template < typename T >
+struct spsc_std_promise_setter {
+    static void
+    set(::std::promise<T>& promise, spsc_state<T>& state)
+    {
+        promise.set_value(state.take());
+    }
+};
+
+template <>
+struct spsc_std_promise_setter<void> {
+    static void
+    set(::std::promise<void>& promise, spsc_state<void>& state)
+    {
+        state.take();
+        promise.set_value();
+    }
+};
+
+}  /* namespace detail */
+
+/**
+ * Future for a single consumer waiting for a result from a single
+ * producer. A lightweight replacement for ::std::future, the result can
+ * be moved to a ::std::future if needed.
+ */
+template < typename T >
+class spsc_future {
+public:
+    static_assert(!::std::is_reference<T>::value,
+            "Reference results are not supported");
+    using value_type    = T;
+    using state_type    = detail::spsc_state<T>;
+
+    spsc_future() noexcept
+        : state_{nullptr} {}
+    spsc_future(spsc_future const&) = delete;
+    spsc_future(spsc_future&& rhs) noexcept
+        : state_{rhs.state_}
+    {
+        rhs.state_ = nullptr;
+    }
+    ~spsc_future()
+    {
+        if (state_)
+            state_->release();
+    }
+
+    spsc_future&
+    operator = (spsc_future const&) = delete;
+    spsc_future&
+    operator = (spsc_future&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            if (state_)
+                state_->release();
+            state_ = rhs.state_;
+            rhs.state_ = nullptr;
+        }
+        return *this;
+    }
+
+    bool
+    valid() const noexcept
+    { return state_ != nullptr; }
+
+    bool
+    is_ready() const
+    {
+        return check_state().is_ready();
+    }
+
+    /**
+     * Wait for the result, spinning spin_count times before parking
+     */
+    void
+    wait(::std::size_t spin_count = spsc_default_spin_count) const
+    {
+        check_state().wait(spin_count);
+    }
+
+    template < typename Rep, typename Period >
+    ::std::future_status
+    wait_for(::std::chrono::duration<Rep, Period> const& d) const
+    {
+        return check_state().wait_until(::std::chrono::steady_clock::now() + d);
+    }
+
+    template < typename Clock, typename Duration >
+    ::std::future_status
+    wait_until(::std::chrono::time_point<Clock, Duration> const& tp) const
+    {
+        return check_state().wait_until(tp);
+    }
+
+    /**
+     * Wait for the result and return it or throw the exception set by the
+     * producer. The future becomes invalid.
+     */
+    T
+    get()
+    {
+        wait();
+        spsc_future tmp{ ::std::move(*this) };
+        return tmp.state_->take();
+    }
+
+    /**
+     * Move the result to a ::std::future. The future becomes invalid.
+     */
+    ::std::future<T>
+    to_std_future()
+    {
+        using setter = detail::spsc_std_promise_setter<T>;
+        check_state();
+        if (state_->is_ready()) {
+            ::std::promise<T> promise;
+            set_std_promise(promise);
+            return promise.get_future();
+        }
+        auto promise = ::std::make_shared< ::std::promise<T> >();
+        auto res = promise->get_future();
+        auto st = state_;
+        state_ = nullptr;
+        st->then(
+            [promise, st]()
+            {
+                try {
+                    setter::set(*promise, *st);
+                } catch (...) {
+                    promise->set_exception(::std::current_exception());
+                }
+            });
+        return res;
+    }
+
+    operator ::std::future<T>() &&
+    {
+        return to_std_future();
+    }
+private:
+    friend class detail::spsc_state<T>;
+    explicit
+    spsc_future(state_type* st)
+        : state_{st}
+    {
+        state_->add_ref();
+    }
+
+    state_type&
+    check_state() const
+    {
+        if (!state_)
+            throw ::std::future_error{ ::std::future_errc::no_state };
+        return *state_;
+    }
+
+    void
+    set_std_promise(::std::promise<T>& promise)
+    {
+        spsc_future tmp{ ::std::move(*this) };
+        try {
+            detail::spsc_std_promise_setter<T>::set(promise, *tmp.state_);
+        } catch (...) {
+            promise.set_exception(::std::current_exception());
+        }
+    }
+private:
+    state_type*     state_;
+};
+
+/**
+ * Promise for a single producer, single consumer result.
+ *
+ * Move only, as ::std::promise. If the promise is destroyed without
+ * setting the result the future gets a broken_promise error.
+ */
+template < typename T >
+class spsc_promise {
+public:
+    using value_type    = T;
+    using state_type    = detail::spsc_state<T>;
+    using future_type   = spsc_future<T>;
+
+    spsc_promise()
+        : state_{ new state_type{} }
+    {
+        state_->add_producer();
+    }
+    spsc_promise(spsc_promise const&) = delete;
+    spsc_promise(spsc_promise&& rhs) noexcept
+        : state_{rhs.state_}
+    {
+        rhs.state_ = nullptr;
+    }
+    ~spsc_promise()
+    {
+        if (state_)
+            state_->release_producer();
+    }
+
+    spsc_promise&
+    operator = (spsc_promise const&) = delete;
+    spsc_promise&
+    operator = (spsc_promise&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            if (state_)
+                state_->release_producer();
+            state_ = rhs.state_;
+            rhs.state_ = nullptr;
+        }
+        return *this;
+    }
+
+    void
+    swap(spsc_promise& rhs) noexcept
+    {
+        ::std::swap(state_, rhs.state_);
+    }
+
+    future_type
+    get_future()
+    {
+        return check_state().get_future();
+    }
+
+    template < typename ... Args >
+    void
+    set_value(Args&& ... args)
+    {
+        check_state().set_value(::std::forward<Args>(args)...);
+    }
+
+    void
+    set_exception(::std::exception_ptr ex)
+    {
+        check_state().set_exception(::std::move(ex));
+    }
+private:
+    state_type&
+    check_state()
+    {
+        if (!state_)
+            throw ::std::future_error{ ::std::future_errc::no_state };
+        return *state_;
+    }
+private:
+    state_type*     state_;
+};
+
+/**
+ * Shared pointer to the producer side of a single producer, single
+ * consumer result. Copying the pointer doesn't allocate, so it can be
+ * captured in both result and exception callbacks of an async call
+ * without wrapping the promise in a ::std::shared_ptr.
+ */
+template < typename T >
+class spsc_promise_ptr {
+public:
+    using state_type    = detail::spsc_state<T>;
+
+    static spsc_promise_ptr
+    create()
+    {
+        return spsc_promise_ptr{ new state_type{} };
+    }
+
+    spsc_promise_ptr() noexcept
+        : state_{nullptr} {}
+    spsc_promise_ptr(spsc_promise_ptr const& rhs) noexcept
+        : state_{rhs.state_}
+    {
+        if (state_)
+            state_->add_producer();
+    }
+    spsc_promise_ptr(spsc_promise_ptr&& rhs) noexcept
+        : state_{rhs.state_}
+    {
+        rhs.state_ = nullptr;
+    }
+    ~spsc_promise_ptr()
+    {
+        if (state_)
+            state_->release_producer();
+    }
+
+    spsc_promise_ptr&
+    operator = (spsc_promise_ptr const& rhs) noexcept
+    {
+        spsc_promise_ptr tmp{rhs};
+        ::std::swap(state_, tmp.state_);
+        return *this;
+    }
+    spsc_promise_ptr&
+    operator = (spsc_promise_ptr&& rhs) noexcept
+    {
+        spsc_promise_ptr tmp{ ::std::move(rhs) };
+        ::std::swap(state_, tmp.state_);
+        return *this;
+    }
+
+    state_type*
+    operator -> () const noexcept
+    { return state_; }
+    state_type&
+    operator * () const noexcept
+    { return *state_; }
+
+    explicit
+    operator bool() const noexcept
+    { return state_ != nullptr; }
+private:
+    explicit
+    spsc_promise_ptr(state_type* st) noexcept
+        : state_{st}
+    {
+        state_->add_producer();
+    }
+private:
+    state_type*     state_;
+};
+
+}  /* namespace util */
+}  /* namespace wire */
+
+#endif /* WIRE_UTIL_SPSC_FUTURE_HPP_ */
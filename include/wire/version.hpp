@@ -11,7 +11,7 @@
 namespace wire {
 
 const uint32_t PROTOCOL_MAJOR = 0;
-const uint32_t PROTOCOL_MINOR = 1;
+const uint32_t PROTOCOL_MINOR = 2;
 
 const uint32_t ENCODING_MAJOR = 0;
 const uint32_t ENCODING_MINOR = 1;
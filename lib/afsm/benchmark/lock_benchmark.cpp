@@ -0,0 +1,191 @@
+/*
+ * lock_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <benchmark/benchmark_api.h>
+
+#include <afsm/fsm.hpp>
+
+#ifdef AFSM_BENCH_WITH_ASIO
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <atomic>
+#include <thread>
+#endif
+
+#include <mutex>
+
+namespace afsm {
+namespace bench {
+
+namespace events {
+
+struct connect {};
+struct send {};
+struct write_done {};
+struct receive {};
+
+}  /* namespace events */
+
+/**
+ * A state machine shaped like a network connection: the online state
+ * holds a write idle/busy submachine deferring sends while a write is
+ * in progress. Used to measure the cost of the state machine mutex.
+ */
+template < typename Mutex >
+struct connection_fsm_def : ::afsm::def::state_machine_def<connection_fsm_def<Mutex>> {
+    template < typename StateDef, typename ... Tags >
+    using state = ::afsm::def::state<StateDef, Tags...>;
+    template < typename MachineDef, typename ... Tags >
+    using state_machine = ::afsm::def::state_machine<MachineDef, Tags...>;
+    template < typename ... T >
+    using transition_table = ::afsm::def::transition_table<T...>;
+    template < typename Event, typename Action = none, typename Guard = none >
+    using in = ::afsm::def::internal_transition< Event, Action, Guard>;
+    template <typename SourceState, typename Event, typename TargetState,
+            typename Action = none, typename Guard = none>
+    using tr = ::afsm::def::transition<SourceState, Event, TargetState, Action, Guard>;
+    template < typename ... T >
+    using type_tuple = ::psst::meta::type_tuple<T...>;
+
+    struct unplugged : state<unplugged> {};
+    struct online : state_machine<online> {
+        struct write_idle : state<write_idle> {};
+        struct write_busy : state<write_busy> {
+            using deferred_events = type_tuple< events::send >;
+        };
+
+        using initial_state = write_idle;
+        using internal_transitions = transition_table<
+            in< events::receive >
+        >;
+        using transitions = transition_table<
+            tr< write_idle, events::send,       write_busy >,
+            tr< write_busy, events::write_done, write_idle >
+        >;
+    };
+
+    using initial_state = unplugged;
+    using transitions = transition_table<
+        tr< unplugged, events::connect, online >
+    >;
+};
+
+template < typename Mutex >
+using connection_fsm = ::afsm::state_machine<connection_fsm_def<Mutex>, Mutex>;
+
+template < typename Mutex >
+void
+ConnectionEvents(::benchmark::State& state)
+{
+    connection_fsm<Mutex> fsm;
+    fsm.process_event(events::connect{});
+
+    while(state.KeepRunning()) {
+        fsm.process_event(events::receive{});
+        fsm.process_event(events::send{});
+        fsm.process_event(events::write_done{});
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+
+template < typename Mutex >
+void
+ConnectionDeferredSends(::benchmark::State& state)
+{
+    connection_fsm<Mutex> fsm;
+    fsm.process_event(events::connect{});
+
+    while(state.KeepRunning()) {
+        fsm.process_event(events::send{});
+        for (int i = 0; i < state.range(0); ++i) {
+            fsm.process_event(events::send{});
+        }
+        for (int i = 0; i <= state.range(0); ++i) {
+            fsm.process_event(events::write_done{});
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1) * 2);
+}
+
+namespace {
+
+connection_fsm<::std::mutex> shared_fsm;
+::std::once_flag shared_fsm_connected;
+
+}  /* namespace  */
+
+/**
+ * Several threads feeding events to one state machine, the way a
+ * connection is driven by a multithreaded io_service.
+ */
+void
+ConnectionEventsContended(::benchmark::State& state)
+{
+    ::std::call_once(shared_fsm_connected,
+        [](){ shared_fsm.process_event(events::connect{}); });
+
+    while(state.KeepRunning()) {
+        shared_fsm.process_event(events::receive{});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#ifdef AFSM_BENCH_WITH_ASIO
+namespace {
+
+::boost::asio::io_service strand_svc;
+::boost::asio::io_service::work strand_work{strand_svc};
+::boost::asio::io_service::strand strand{strand_svc};
+connection_fsm<::afsm::none> strand_fsm;
+::std::once_flag strand_fsm_connected;
+::std::atomic<::std::size_t> strand_posted{0};
+::std::atomic<::std::size_t> strand_processed{0};
+
+}  /* namespace  */
+
+/**
+ * Same load as ConnectionEventsContended, but the events are serialized
+ * on an io_service strand and the machine has no mutex. The benchmark
+ * threads run the io_service, so the time includes processing of all
+ * the events posted by the thread.
+ */
+void
+ConnectionEventsContendedStrand(::benchmark::State& state)
+{
+    ::std::call_once(strand_fsm_connected,
+        [](){ strand_fsm.process_event(events::connect{}); });
+
+    while(state.KeepRunning()) {
+        ++strand_posted;
+        strand.dispatch(
+            []()
+            {
+                strand_fsm.process_event(events::receive{});
+                ++strand_processed;
+            });
+        strand_svc.poll_one();
+    }
+    auto posted = strand_posted.load();
+    while (strand_processed < posted) {
+        if (!strand_svc.poll_one())
+            ::std::this_thread::yield();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+#endif
+
+BENCHMARK_TEMPLATE(ConnectionEvents, ::std::mutex);
+BENCHMARK_TEMPLATE(ConnectionEvents, ::afsm::none);
+BENCHMARK_TEMPLATE(ConnectionDeferredSends, ::std::mutex)->Range(1, 64);
+BENCHMARK_TEMPLATE(ConnectionDeferredSends, ::afsm::none)->Range(1, 64);
+BENCHMARK(ConnectionEventsContended)->ThreadRange(1, 8);
+#ifdef AFSM_BENCH_WITH_ASIO
+BENCHMARK(ConnectionEventsContendedStrand)->ThreadRange(1, 8);
+#endif
+
+}  /* namespace bench */
+}  /* namespace afsm */
@@ -14,6 +14,7 @@
 #include <wire/core/connection_observer.hpp>
 
 #include <wire/core/detail/configuration_options.hpp>
+#include <wire/core/detail/dispatch_executor.hpp>
 #include <wire/errors/not_found.hpp>
 
 #include <wire/util/io_service_wait.hpp>
@@ -92,6 +93,8 @@ struct adapter::impl : ::std::enable_shared_from_this<impl> {
     connection_observer_set     connection_observers_;
 
     watchdog_ptr                watchdog_;
+    detail::dispatch_executor_ptr
+                                executor_;
 
     impl(connector_ptr c, identity const& id, detail::adapter_options const& options,
             connection_observer_set const& observers)
@@ -103,6 +106,10 @@ struct adapter::impl : ::std::enable_shared_from_this<impl> {
           is_active_{false}, registered_{false},
           connection_observers_{observers}
     {
+        if (options_.dispatch_threads > 0) {
+            executor_ = ::std::make_shared< detail::dispatch_executor >(
+                    options_.dispatch_threads, options_.dispatch_order);
+        }
     }
 
     void
@@ -288,7 +295,7 @@ struct adapter::impl : ::std::enable_shared_from_this<impl> {
             invocation_options const&       opts        = invocation_options::unspecified)
         -> decltype(::std::declval< _Promise<void> >().get_future())
     {
-        auto promise = ::std::make_shared<_Promise<void>>();
+        auto promise = make_promise<_Promise<void>>();
         register_adapter_async(
             [promise]()
             { promise->set_value(); },
@@ -351,7 +358,7 @@ struct adapter::impl : ::std::enable_shared_from_this<impl> {
         invocation_options const&   opts        = invocation_options::unspecified)
         -> decltype(::std::declval< _Promise<void> >().get_future())
     {
-        auto promise = ::std::make_shared<_Promise<void>>();
+        auto promise = make_promise<_Promise<void>>();
         unregister_adapter_async(
             [promise]()
             { promise->set_value(); },
@@ -654,6 +661,12 @@ adapter::options() const
     return pimpl_->options_;
 }
 
+detail::dispatch_executor_ptr
+adapter::executor() const
+{
+    return pimpl_->executor_;
+}
+
 detail::ssl_options const&
 adapter::ssl_options() const
 {
@@ -9,12 +9,15 @@
 #include <wire/core/adapter.hpp>
 #include <wire/core/detail/connection_impl.hpp>
 #include <wire/core/detail/dispatch_request.hpp>
+#include <wire/core/detail/dispatch_executor.hpp>
 #include <wire/core/detail/configuration_options.hpp>
+#include <wire/core/detail/pool_allocator.hpp>
 #include <wire/core/current.hpp>
 #include <wire/core/object.hpp>
 #include <wire/encoding/message.hpp>
 #include <wire/errors/user_exception.hpp>
 
+#include <algorithm>
 #include <cxxabi.h>
 #include <iterator>
 
@@ -30,6 +33,8 @@ const invocation_options invocation_options::unspecified{ invocation_flags::unsp
 
 namespace detail {
 
+constexpr ::std::size_t connection_implementation::max_write_batch;
+
 using tcp_connection_impl           = connection_impl< transport_type::tcp >;
 using ssl_connection_impl           = connection_impl< transport_type::ssl >;
 using socket_connection_impl        = connection_impl< transport_type::socket >;
@@ -37,6 +42,12 @@ using socket_connection_impl        = connection_impl< transport_type::socket >;
 using tcp_listen_connection_impl    = listen_connection_impl< transport_type::tcp >;
 using ssl_listen_connection_impl    = listen_connection_impl< transport_type::ssl >;
 using socket_listen_connection_impl = listen_connection_impl< transport_type::socket >;
+#ifdef WIRE_HAS_SHM_TRANSPORT
+using shm_connection_impl           = connection_impl< transport_type::shm >;
+using shm_listen_connection_impl    = listen_connection_impl< transport_type::shm >;
+#endif
+using inproc_connection_impl        = connection_impl< transport_type::inproc >;
+using inproc_listen_connection_impl = listen_connection_impl< transport_type::inproc >;
 
 const encoding::request_result_callback dispatch_request::ignore_result
     = [](encoding::outgoing&&){};
@@ -55,29 +66,28 @@ demangle(char const* type_name)
     return res;
 }
 
-} /* namespace  */
+/**
+ * Peer's protocol is compatible if the major versions are the same. Minor
+ * versions differ only in optional features, a peer doesn't use the
+ * features added after its own version.
+ */
+bool
+protocol_compatible(encoding::version const& v)
+{
+    return v.major == PROTOCOL_MAJOR;
+}
 
+/**
+ * Peer understands the urgent message flag
+ */
+bool
+supports_urgent(encoding::version const& v)
+{
+    return v.minor >= 2;
+}
+
+} /* namespace  */
 
-class invocation_foolproof_guard {
-    using atomic_flag               = ::std::atomic_flag;
-    functional::void_callback       destroy_;
-    atomic_flag                     responded_{false};
-public:
-    invocation_foolproof_guard(functional::void_callback on_destroy)
-        : destroy_{on_destroy}
-    {}
-    ~invocation_foolproof_guard()
-    {
-        if (respond() && destroy_) {
-            destroy_();
-        }
-    }
-    bool
-    respond()
-    {
-        return !responded_.test_and_set();
-    }
-};
 
 connection_impl_ptr
 connection_implementation::create_connection(adapter_ptr adptr, transport_type _type,
@@ -90,6 +100,12 @@ connection_implementation::create_connection(adapter_ptr adptr, transport_type _
             return ::std::make_shared< ssl_connection_impl >( client_side{}, adptr, on_close );
         case transport_type::socket :
             return ::std::make_shared< socket_connection_impl >( client_side{}, adptr, on_close );
+#ifdef WIRE_HAS_SHM_TRANSPORT
+        case transport_type::shm :
+            return ::std::make_shared< shm_connection_impl >( client_side{}, adptr, on_close );
+#endif
+        case transport_type::inproc :
+            return ::std::make_shared< inproc_connection_impl >( client_side{}, adptr, on_close );
         default:
             break;
     }
@@ -131,6 +147,16 @@ connection_implementation::create_listen_connection(adapter_ptr adptr, transport
             return create_listen_connection_impl<
                     socket_listen_connection_impl,
                     socket_connection_impl >(adptr, on_close);
+#ifdef WIRE_HAS_SHM_TRANSPORT
+        case transport_type::shm:
+            return create_listen_connection_impl<
+                    shm_listen_connection_impl,
+                    shm_connection_impl >(adptr, on_close);
+#endif
+        case transport_type::inproc:
+            return create_listen_connection_impl<
+                    inproc_listen_connection_impl,
+                    inproc_connection_impl >(adptr, on_close);
         default:
             break;
     }
@@ -165,45 +191,49 @@ connection_implementation::on_connect_timeout(asio_config::error_code const& ec)
 }
 
 void
-connection_implementation::set_idle_timer()
+connection_implementation::start_idle_timer()
 {
-    if (can_drop_connection()) {
-        auto const& opts = get_connector()->options();
-        #if DEBUG_OUTPUT >= 5
-        auto cancelled_events =
-        #endif
-        connection_timer_.expires_from_now(::std::chrono::milliseconds{opts.connection_idle_timeout});
-        #if DEBUG_OUTPUT >= 5
-        if (cancelled_events) {
-            ::std::ostringstream os;
-            tag(os) << " Reset timer\n";
-            ::std::cerr << os.str();
-        } else {
-            ::std::ostringstream os;
-            tag(os) << " Set timer\n";
-            ::std::cerr << os.str();
-        }
-        #endif
-        auto _this = shared_from_this();
-        connection_timer_.async_wait(
-                [_this](asio_config::error_code const& ec)
-                {
-                    _this->on_idle_timeout(ec);
-                });
+    auto const& opts = get_connector()->options();
+    if (opts.enable_connection_timeouts) {
+        mark_activity();
+        schedule_idle_check(
+                timing_wheel::duration_type{opts.connection_idle_timeout});
     }
 }
 
 void
-connection_implementation::on_idle_timeout(asio_config::error_code const& ec)
+connection_implementation::schedule_idle_check(timing_wheel::duration_type timeout)
 {
-    if (!ec) {
-        #if DEBUG_OUTPUT >= 5
-        ::std::ostringstream os;
-        tag(os) << " Timer expired\n";
-        ::std::cerr << os.str();
-        #endif
-        if (can_drop_connection())
-            process_event(events::close{});
+    ::std::weak_ptr<connection_implementation> _this = shared_from_this();
+    idle_timer_ = timers_.schedule(timeout,
+        [_this]()
+        {
+            auto conn = _this.lock();
+            if (conn)
+                conn->on_idle_timeout();
+        });
+}
+
+void
+connection_implementation::on_idle_timeout()
+{
+    if (is_terminated())
+        return;
+    timing_wheel::duration_type timeout{
+        get_connector()->options().connection_idle_timeout };
+    auto last = timing_wheel::clock_type::time_point{ timing_wheel::clock_type::duration{
+            last_activity_.load(::std::memory_order_relaxed) } };
+    auto idle = ::std::chrono::duration_cast<timing_wheel::duration_type>(
+            timing_wheel::clock_type::now() - last);
+    if (idle >= timeout) {
+        DEBUG_LOG_TAG(5, tag, "Connection is idle for " << idle.count() << "ms");
+        if (can_drop_connection()) {
+            dispatch_event(events::close{});
+            return;
+        }
+        schedule_idle_check(timeout);
+    } else {
+        schedule_idle_check(timeout - idle);
     }
 }
 
@@ -217,25 +247,36 @@ connection_implementation::can_drop_connection() const
     return false; // Turn off connection timeout
 }
 
-void
-connection_implementation::start_request_timer()
+timing_wheel::timer_id
+connection_implementation::schedule_request_timeout(request_number r_no,
+        invocation_options::timeout_type timeout)
 {
-    request_timer_.expires_from_now(::std::chrono::milliseconds{500});
-    request_timer_.async_wait(::std::bind(&connection_implementation::on_request_timeout,
-                    shared_from_this(), ::std::placeholders::_1));
+    ::std::weak_ptr<connection_implementation> _this = shared_from_this();
+    return timers_.schedule(expire_duration{timeout},
+        [_this, r_no]()
+        {
+            static errors::request_timed_out err{ "Request timed out" };
+            auto conn = _this.lock();
+            if (conn) {
+                DEBUG_LOG_TAG(3, conn->tag, "Request #" << r_no << " timed out");
+                conn->request_error(r_no, ::std::make_exception_ptr(err));
+            }
+        });
 }
 
 void
 connection_implementation::request_error(request_number r_no,
         ::std::exception_ptr ex)
 {
-    pending_replies_type::accessor acc;
-    if (pending_replies_.find(acc, r_no)) {
+    pending_reply p_rep;
+    if (take_pending(r_no, p_rep)) {
         DEBUG_LOG_TAG(3, tag, "Request #" << r_no << " connection error");
-        auto const& p_rep = acc->second;
-        auto elapsed = clock_type::now() - p_rep.start;
-        observer_.invocation_error(r_no, p_rep.target, p_rep.operation,
-                remote_endpoint(), p_rep.sent, ex, elapsed);
+        timers_.cancel(p_rep.timer);
+        if (observer_.has_observers()) {
+            observer_.invocation_error(r_no, p_rep.target, p_rep.operation,
+                    remote_endpoint(), p_rep.sent, ex,
+                    clock_type::now() - p_rep.start);
+        }
         if (p_rep.error) {
             auto err_handler = p_rep.error;
             io_service_->post(
@@ -246,27 +287,25 @@ connection_implementation::request_error(request_number r_no,
                 } catch(...) {}
             });
         }
-        pending_replies_.erase(acc);
     }
 }
 
 void
-connection_implementation::on_request_timeout(asio_config::error_code const& ec)
+connection_implementation::fail_urgent_requests(encoding::version const& peer)
 {
-    static errors::request_timed_out err{ "Request timed out" };
-
-    auto now = clock_type::now();
-    reply_expiration r_exp;
-    while (expiration_queue_.try_pop(r_exp)) {
-        if (r_exp.expires <= now) {
-            DEBUG_LOG_TAG(3, tag, "Request #" << r_exp.number << " timed out");
-            request_error(r_exp.number, ::std::make_exception_ptr(err));
-        } else {
-            expiration_queue_.push(r_exp);
-            break;
+    for (auto r_no : pending_replies_.keys()) {
+        bool urgent = false;
+        pending_replies_.modify(r_no,
+                [&urgent](pending_reply& p_rep){ urgent = p_rep.urgent; });
+        if (urgent) {
+            DEBUG_LOG_TAG(3, tag, "Request #" << r_no
+                    << " is urgent, the peer doesn't support it");
+            request_error(r_no, ::std::make_exception_ptr(
+                errors::unsupported_feature{ "Peer protocol version ",
+                    peer.major, ".", peer.minor,
+                    " doesn't support urgent requests" }));
         }
     }
-    start_request_timer();
 }
 
 void
@@ -274,7 +313,7 @@ connection_implementation::connect_async(endpoint const& ep,
         functional::void_callback cb, functional::exception_callback eb)
 {
     mode_ = client;
-    process_event(events::connect{ ep, cb, eb });
+    dispatch_event(events::connect{ ep, cb, eb });
 }
 
 void
@@ -286,7 +325,7 @@ connection_implementation::start_session()
     tag(os) << " Start server session\n";
     ::std::cerr << os.str();
     #endif
-    process_event(events::start{});
+    dispatch_event(events::start{});
 }
 
 void
@@ -306,12 +345,14 @@ connection_implementation::handle_started(asio_config::error_code const& ec)
     ::std::cerr << os.str();
     #endif
     if (!ec) {
-        process_event(events::started{});
+        dispatch_event(events::started{});
         auto adp = adapter_.lock();
         if (adp) {
             adp->connection_online(local_endpoint(), remote_endpoint());
         }
-        observer_.connect(remote_endpoint());
+        if (observer_.has_observers())
+            observer_.connect(remote_endpoint());
+        start_idle_timer();
     } else {
         connection_failure(
             ::std::make_exception_ptr(errors::connection_failed(ec.message())));
@@ -334,13 +375,14 @@ connection_implementation::handle_connected(asio_config::error_code const& ec)
     ::std::cerr << os.str();
     #endif
     if (!ec) {
-        process_event(events::connected{});
+        dispatch_event(events::connected{});
         auto adp = adapter_.lock();
         if (adp) {
             adp->connection_online(local_endpoint(), remote_endpoint());
         }
-        observer_.connect(remote_endpoint());
-        start_request_timer();
+        if (observer_.has_observers())
+            observer_.connect(remote_endpoint());
+        start_idle_timer();
     } else {
         connection_failure(
             ::std::make_exception_ptr(errors::connection_refused(ec.message())));
@@ -359,7 +401,7 @@ connection_implementation::send_validate_message()
     [_this]()
     {
         DEBUG_LOG_TAG(3, _this->tag, "Validate message sent");
-        _this->process_event(events::validate_sent{});
+        _this->dispatch_event(events::validate_sent{});
     });
 }
 
@@ -367,7 +409,7 @@ connection_implementation::send_validate_message()
 void
 connection_implementation::close()
 {
-    process_event(events::close{});
+    dispatch_event(events::close{});
 }
 
 void
@@ -384,21 +426,55 @@ void
 connection_implementation::handle_close()
 {
     DEBUG_LOG_TAG(1, tag, "Handle close");
+    terminated_ = true;
 
     errors::connection_closed err{ "Connection closed" };
     auto ex = ::std::make_exception_ptr(err);
 
     cancel_connect_timer();
-    request_timer_.cancel();
+    timers_.cancel(idle_timer_.exchange(timing_wheel::invalid_timer));
+
+    auto post_error = [this, ex](functional::exception_callback err_handler)
+        {
+            io_service_->post(
+            [err_handler, ex]()
+            {
+                try {
+                    err_handler(ex);
+                } catch(...) {}
+            });
+        };
 
-    reply_expiration r_exp;
-    while (expiration_queue_.try_pop(r_exp)) {
-        request_error(r_exp.number, ex);
+    waiting_queue waiting;
+    {
+        lock_guard lock{flow_mtx_};
+        waiting.swap(waiting_);
+    }
+    for (auto& req : waiting) {
+        if (!req.tracked && req.error) {
+            post_error(req.error);
+        }
+    }
+    // Messages queued for write will never be sent, the tracked requests
+    // among them are failed with the pending replies
+    write_queue queued;
+    queued.swap(urgent_writes_);
+    ::std::move(normal_writes_.begin(), normal_writes_.end(),
+            ::std::back_inserter(queued));
+    normal_writes_.clear();
+    for (auto& w : queued) {
+        if (w.error) {
+            post_error(w.error);
+        }
+    }
+    for (auto r_no : pending_replies_.keys()) {
+        request_error(r_no, ex);
     }
 
     if (on_close_)
         on_close_();
-    observer_.disconnect(remote_endpoint());
+    if (observer_.has_observers())
+        observer_.disconnect(remote_endpoint());
 }
 
 void
@@ -419,9 +495,10 @@ connection_implementation::handle_write(asio_config::error_code const& ec, ::std
 {
     if (!ec) {
         DEBUG_LOG_TAG(3, tag, "Write operation finished. Bytes written: " << bytes)
-        observer_.send_bytes(bytes, remote_endpoint());
-        set_idle_timer();
-        process_event(events::write_done{});
+        if (observer_.has_observers())
+            observer_.send_bytes(bytes, remote_endpoint());
+        mark_activity();
+        dispatch_event(events::write_done{});
         if (cb) cb();
     } else {
         DEBUG_LOG_TAG(2, tag, "Write failed " << ec.message());
@@ -430,6 +507,70 @@ connection_implementation::handle_write(asio_config::error_code const& ec, ::std
     }
 }
 
+void
+connection_implementation::queue_write(encoding::outgoing_ptr out,
+        functional::void_callback cb, functional::exception_callback err)
+{
+    if (out->flags() & encoding::message::urgent) {
+        urgent_writes_.push_back(queued_write{ out, cb, err });
+    } else {
+        normal_writes_.push_back(queued_write{ out, cb, err });
+    }
+}
+
+bool
+connection_implementation::has_queued_writes() const
+{
+    return !urgent_writes_.empty() || !normal_writes_.empty();
+}
+
+void
+connection_implementation::write_next()
+{
+    if (coalesce_writes() && urgent_writes_.size() + normal_writes_.size() > 1) {
+        write_batch batch;
+        ::std::size_t bytes = 0;
+        while (has_queued_writes() && bytes < max_write_batch) {
+            auto& lane = urgent_writes_.empty() ? normal_writes_ : urgent_writes_;
+            bytes += lane.front().outgoing->size();
+            batch.push_back(::std::move(lane.front()));
+            lane.pop_front();
+        }
+        write_batch_async(::std::move(batch));
+        return;
+    }
+    auto& lane = urgent_writes_.empty() ? normal_writes_ : urgent_writes_;
+    queued_write next = ::std::move(lane.front());
+    lane.pop_front();
+    write_async(next.outgoing, next.sent);
+}
+
+void
+connection_implementation::write_batch_async(write_batch&& batch)
+{
+    DEBUG_LOG_TAG(3, tag, "Send " << batch.size() << " messages in one write");
+    if (!is_terminated() && is_open()) {
+        outgoing_list outs;
+        outs.reserve(batch.size());
+        for (auto const& w : batch) {
+            outs.push_back(w.outgoing);
+        }
+        auto sent = ::std::make_shared< write_batch >(::std::move(batch));
+        auto shared_this = shared_from_this();
+        do_write_batch_async(outs,
+            [shared_this, sent](asio_config::error_code const& ec, ::std::size_t bytes)
+            {
+                shared_this->handle_write(ec, bytes,
+                    [sent]()
+                    {
+                        for (auto const& w : *sent) {
+                            if (w.sent) w.sent();
+                        }
+                    }, nullptr);
+            });
+    }
+}
+
 void
 connection_implementation::start_read()
 {
@@ -440,6 +581,31 @@ connection_implementation::start_read()
     }
 }
 
+void
+connection_implementation::continue_read()
+{
+    if (limits_.dispatch > 0 && outstanding_responses_ >= limits_.dispatch) {
+        read_paused_ = true;
+        // Responses could have been sent before the flag was set,
+        // the one who resets the flag starts the read
+        if (outstanding_responses_ >= limits_.dispatch || !read_paused_.exchange(false)) {
+            DEBUG_LOG_TAG(3, tag, "Pause reading, "
+                    << outstanding_responses_.load() << " requests in dispatch");
+            return;
+        }
+    }
+    start_read();
+}
+
+void
+connection_implementation::response_done()
+{
+    if (--outstanding_responses_ < limits_.dispatch && read_paused_.exchange(false)) {
+        DEBUG_LOG_TAG(3, tag, "Resume reading");
+        start_read();
+    }
+}
+
 void
 connection_implementation::read_async(incoming_buffer_ptr buffer)
 {
@@ -454,10 +620,11 @@ connection_implementation::handle_read(asio_config::error_code const& ec, ::std:
 {
     if (!ec) {
         DEBUG_LOG_TAG(4, tag, "Received " << bytes << " bytes");
-        observer_.receive_bytes(bytes, remote_endpoint());
-        process_event(events::receive_data{buffer, bytes});
-        start_read();
-        set_idle_timer();
+        if (observer_.has_observers())
+            observer_.receive_bytes(bytes, remote_endpoint());
+        dispatch_event(events::receive_data{buffer, bytes});
+        continue_read();
+        mark_activity();
     } else {
         DEBUG_LOG_TAG(2, tag, "Read failed " << ec.message());
         connection_failure(
@@ -475,14 +642,24 @@ connection_implementation::process_message(encoding::message m,
             if (m.size > 0) {
                 throw errors::connection_failed("Invalid validate message");
             }
-            process_event(events::receive_validate{});
+            if ((m.flags & message::protocol) && !protocol_compatible(m.protocol_version)) {
+                // With optimistic handshake the requests are already sent,
+                // they fail when the connection is closed
+                throw errors::connection_failed("Incompatible peer protocol version ",
+                        m.protocol_version.major, ".", m.protocol_version.minor);
+            }
+            if ((m.flags & message::protocol) && !supports_urgent(m.protocol_version)) {
+                peer_urgent_ = false;
+                fail_urgent_requests(m.protocol_version);
+            }
+            dispatch_event(events::receive_validate{});
             break;
         }
         case message::close : {
             if (m.size > 0) {
                 throw errors::connection_failed("Invalid close message");
             }
-            process_event(events::receive_close{});
+            dispatch_event(events::receive_close{});
             break;
         }
         default: {
@@ -575,9 +752,11 @@ connection_implementation::read_incoming_message(incoming_buffer_ptr buffer, ::s
         }
         #endif
         carry_.insert(carry_.end(), b, e);
+        dispatch_normal_requests();
     } catch (::std::exception const& e) {
         /** TODO Make it a protocol error? Can we handle it? */
         DEBUG_LOG_TAG(2, tag, "Protocol read exception: " << e.what());
+        normal_requests_.clear();
         connection_failure(::std::current_exception());
     }
 }
@@ -588,10 +767,14 @@ connection_implementation::dispatch_incoming(encoding::incoming_ptr incoming)
     using encoding::message;
     switch (incoming->type()) {
         case message::request:
-            process_event(events::receive_request{ incoming });
+            if (incoming->header().flags & message::urgent) {
+                dispatch_event(events::receive_request{ incoming });
+            } else {
+                normal_requests_.push_back(incoming);
+            }
             break;
         case message::reply:
-            process_event(events::receive_reply{ incoming });
+            dispatch_event(events::receive_reply{ incoming });
             break;
         default:
             connection_failure(
@@ -600,19 +783,28 @@ connection_implementation::dispatch_incoming(encoding::incoming_ptr incoming)
     }
 }
 
+void
+connection_implementation::dispatch_normal_requests()
+{
+    incoming_list requests;
+    requests.swap(normal_requests_);
+    for (auto& req : requests) {
+        dispatch_event(events::receive_request{ req });
+    }
+}
+
 void
 connection_implementation::request_sent(request_number r_no,
         functional::callback< bool > sent, bool one_way)
 {
     DEBUG_LOG_TAG(3, tag, "Invocation #" << r_no << " has been sent");
 
-    pending_replies_type::accessor acc;
-    if (pending_replies_.find(acc, r_no)) {
-        if (one_way) {
-            pending_replies_.erase(acc);
-        } else {
-            acc->second.sent = true;
-        }
+    if (one_way) {
+        pending_reply p_rep;
+        if (take_pending(r_no, p_rep))
+            timers_.cancel(p_rep.timer);
+    } else {
+        pending_replies_.modify(r_no, [](pending_reply& p_rep){ p_rep.sent = true; });
     }
     if (sent)
         sent(true);
@@ -629,15 +821,18 @@ connection_implementation::invoke(encoding::invocation_target const& target,
         functional::callback< bool > sent)
 {
     using encoding::request;
+    using encoding::message;
+    bool urgent = opts.is_urgent() && peer_urgent_;
     encoding::outgoing_ptr out = ::std::make_shared<encoding::outgoing>(
             get_connector(),
-            encoding::message::request);
+            urgent ? message::request | message::urgent : message::request);
     request r{
         ++request_no_,
         encoding::operation_specs{ target, op },
         request::normal
     };
-    observer_.invoke_remote(r.number, target, op, remote_endpoint());
+    if (observer_.has_observers())
+        observer_.invoke_remote(r.number, target, op, remote_endpoint());
     if (ctx.empty())
         r.mode |= request::no_context;
     if (opts.is_one_way())
@@ -651,24 +846,26 @@ connection_implementation::invoke(encoding::invocation_target const& target,
         write(::std::back_inserter(*out), ctx);
     params.close_all_encaps();
     out->insert_encapsulation(::std::move(params));
-    time_point expires = clock_type::now() + expire_duration{opts.timeout};
-    pending_replies_.insert(::std::make_pair( r.number,
-            pending_reply{ target, op, reply, exception, clock_type::now(), false } ));
-    expiration_queue_.push(reply_expiration{ r.number, expires });
+    pending_replies_.insert(r.number,
+            pending_reply{ target, op, reply, exception, clock_type::now() });
+    {
+        // The request is not sent yet, the reply cannot take the entry
+        auto timer = schedule_request_timeout(r.number, opts.timeout);
+        pending_replies_.modify(r.number,
+                [timer, urgent](pending_reply& p_rep)
+                {
+                    p_rep.timer = timer;
+                    p_rep.urgent = urgent;
+                });
+    }
     auto _this = shared_from_this();
     auto r_no = r.number;
-    bool one_way = opts.is_one_way();
-    functional::void_callback write_cb = [_this, r_no, sent, one_way]()
-        {
-            _this->request_sent(r_no, sent, one_way);
-        };
-    process_event(events::send_request{ out, write_cb });
+    queue_request(waiting_request{ r_no, out, sent, nullptr, true, opts.is_one_way() });
 
     if (opts.is_sync()) {
         // TODO Decide what to do in case of one way invocation
         util::run_while(io_service_, [_this, r_no](){
-            pending_replies_type::const_accessor acc;
-            return _this->pending_replies_.find(acc, r_no);
+            return _this->pending_replies_.contains(r_no);
         });
     }
 }
@@ -691,9 +888,11 @@ connection_implementation::send(encoding::multiple_targets const& targets,
                 ::std::move(params), nullptr, exception, sent);
     } else {
         using encoding::request;
+        using encoding::message;
         encoding::outgoing_ptr out = ::std::make_shared<encoding::outgoing>(
                 get_connector(),
-                encoding::message::request);
+                opts.is_urgent() && peer_urgent_ ?
+                        message::request | message::urgent : message::request);
         request r{
             ++request_no_,
             encoding::operation_specs{ encoding::invocation_target{}, op },
@@ -710,13 +909,7 @@ connection_implementation::send(encoding::multiple_targets const& targets,
         params.close_all_encaps();
         out->insert_encapsulation(::std::move(params));
 
-        auto _this = shared_from_this();
-        auto r_no = r.number;
-        functional::void_callback write_cb = [_this, r_no, sent]()
-            {
-                _this->request_sent(r_no, sent, true);
-            };
-        process_event(events::send_request{ out, write_cb });
+        queue_request(waiting_request{ r.number, out, sent, exception, false, true });
     }
 }
 
@@ -741,9 +934,10 @@ connection_implementation::forward(encoding::multiple_targets const& targets,
         if (opts.is_one_way()) {
             mode |= request::one_way;
         }
+        bool urgent = opts.is_urgent() && peer_urgent_;
         outgoing_ptr out = ::std::make_shared<outgoing>(
                         get_connector(),
-                        message::request);
+                        urgent ? message::request | message::urgent : message::request);
         invocation_target tgt = targets.size() == 1 ?
                 *targets.begin() : invocation_target{};
         request r{
@@ -765,23 +959,150 @@ connection_implementation::forward(encoding::multiple_targets const& targets,
         encaps.end_encaps();
 
         if (!(r.mode & request::one_way)) {
-            time_point expires = clock_type::now() + expire_duration{opts.timeout};
-            pending_replies_.insert(::std::make_pair( r.number,
+            pending_replies_.insert(r.number,
                     pending_reply{ encoding::invocation_target{}, op,
-                        reply, exception, clock_type::now(), false } ));
-            //}
-            expiration_queue_.push(reply_expiration{ r.number, expires });
+                        reply, exception, clock_type::now() });
+            auto timer = schedule_request_timeout(r.number, opts.timeout);
+            pending_replies_.modify(r.number,
+                    [timer, urgent](pending_reply& p_rep)
+                    {
+                        p_rep.timer = timer;
+                        p_rep.urgent = urgent;
+                    });
+        }
+
+        if (r.mode & request::one_way) {
+            queue_request(waiting_request{ r.number, out, sent, exception, false, true });
+        } else {
+            queue_request(waiting_request{ r.number, out, sent, nullptr, true, false });
         }
+    }
+}
+
+void
+connection_implementation::queue_request(waiting_request&& req)
+{
+    if (!limits_.window_enabled()) {
+        dispatch_event(events::send_request{ req.outgoing,
+            make_sent_callback(req, false), req.error });
+        return;
+    }
+    {
+        lock_guard lock{flow_mtx_};
+        if (waiting_.empty() && window_open(req.outgoing->size())) {
+            ++requests_in_flight_;
+            bytes_in_flight_ += req.outgoing->size();
+        } else if (limits_.queued == 0 || waiting_.size() < limits_.queued) {
+            DEBUG_LOG_TAG(3, tag, "Request #" << req.number
+                    << " waits for the request window");
+            if (req.outgoing->flags() & encoding::message::urgent) {
+                // Urgent requests wait ahead of normal ones
+                auto pos = ::std::find_if(waiting_.begin(), waiting_.end(),
+                    [](waiting_request const& w)
+                    {
+                        return !(w.outgoing->flags() & encoding::message::urgent);
+                    });
+                waiting_.insert(pos, ::std::move(req));
+            } else {
+                waiting_.push_back(::std::move(req));
+            }
+            return;
+        } else {
+            req.outgoing.reset();
+        }
+    }
+    if (req.outgoing) {
+        start_request(::std::move(req));
+        return;
+    }
+    DEBUG_LOG_TAG(2, tag, "Request #" << req.number << " overflow");
+    auto ex = ::std::make_exception_ptr(
+            errors::request_overflow{ "Too many requests queued for connection" });
+    if (req.tracked) {
+        request_error(req.number, ex);
+    } else if (req.error) {
+        functional::report_exception(req.error, ex);
+    }
+}
 
-        auto _this = shared_from_this();
-        auto r_no = r.number;
-        bool one_way = r.mode & request::one_way;
-        functional::void_callback write_cb = [_this, r_no, sent, one_way]()
+void
+connection_implementation::start_request(waiting_request&& req)
+{
+    auto size = req.outgoing->size();
+    if (req.tracked && !pending_replies_.modify(req.number,
+            [](pending_reply& p_rep){ p_rep.credited = true; })) {
+        // The request has timed out while waiting for the window
+        release_credit(1, size);
+        return;
+    }
+    dispatch_event(events::send_request{ req.outgoing,
+        make_sent_callback(req, true), req.error });
+}
+
+functional::void_callback
+connection_implementation::make_sent_callback(waiting_request const& req, bool credited)
+{
+    auto _this = shared_from_this();
+    auto r_no = req.number;
+    bool one_way = req.one_way;
+    // Untracked requests don't wait for a reply, tracked ones return
+    // the request credit when the reply arrives
+    ::std::size_t requests = credited && !req.tracked ? 1 : 0;
+    ::std::size_t bytes = credited ? req.outgoing->size() : 0;
+    if (req.sent) {
+        auto sent = req.sent;
+        return [_this, r_no, one_way, credited, requests, bytes, sent]()
             {
+                if (credited)
+                    _this->release_credit(requests, bytes);
                 _this->request_sent(r_no, sent, one_way);
             };
-        process_event(events::send_request{ out, write_cb });
     }
+    return [_this, r_no, one_way, credited, requests, bytes]()
+        {
+            if (credited)
+                _this->release_credit(requests, bytes);
+            _this->request_sent(r_no, nullptr, one_way);
+        };
+}
+
+void
+connection_implementation::release_credit(::std::size_t requests, ::std::size_t bytes)
+{
+    waiting_queue admitted;
+    {
+        lock_guard lock{flow_mtx_};
+        requests_in_flight_ -= requests;
+        bytes_in_flight_ -= bytes;
+        while (!waiting_.empty() && window_open(waiting_.front().outgoing->size())) {
+            ++requests_in_flight_;
+            bytes_in_flight_ += waiting_.front().outgoing->size();
+            admitted.push_back(::std::move(waiting_.front()));
+            waiting_.pop_front();
+        }
+    }
+    for (auto& req : admitted) {
+        start_request(::std::move(req));
+    }
+}
+
+bool
+connection_implementation::window_open(::std::size_t bytes) const
+{
+    return (limits_.requests == 0 || requests_in_flight_ < limits_.requests)
+        && (limits_.bytes == 0 || bytes_in_flight_ == 0
+                || bytes_in_flight_ + bytes <= limits_.bytes);
+}
+
+bool
+connection_implementation::take_pending(request_number r_no, pending_reply& p_rep)
+{
+    if (pending_replies_.take(r_no, p_rep)) {
+        if (p_rep.credited)
+            release_credit(1, 0);
+        return true;
+    }
+    return false;
 }
 
 void
@@ -794,11 +1115,17 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
         incoming::const_iterator e = buffer->end();
         read(b, e, rep);
         DEBUG_LOG_TAG(3, tag, "Dispatch reply #" << rep.number);
-        auto peer_ep = remote_endpoint();
-        pending_replies_type::accessor acc;
-        if (pending_replies_.find(acc, rep.number)) {
-            auto const& p_rep = acc->second;
-            auto elapsed = clock_type::now() - p_rep.start;
+        // Observer arguments are only collected when somebody listens
+        bool const observe = observer_.has_observers();
+        endpoint peer_ep;
+        if (observe)
+            peer_ep = remote_endpoint();
+        pending_reply p_rep;
+        if (take_pending(rep.number, p_rep)) {
+            // The entry is released, callbacks are invoked without any lock held
+            timers_.cancel(p_rep.timer);
+            auto elapsed = observe ?
+                    clock_type::now() - p_rep.start : duration_type{};
             switch (rep.status) {
                 case reply::success:{
                     DEBUG_LOG_TAG(3, tag, "Reply #" << rep.number << " status is success");
@@ -810,9 +1137,10 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
                         DEBUG_LOG_TAG(3, tag, "Reply encaps v" << ever.major << "." << ever.minor
                                 << " size " << encaps.size());
                         #endif
-                        observer_.invocation_ok(rep.number,
-                                p_rep.target, p_rep.operation,
-                                peer_ep, elapsed);
+                        if (observe)
+                            observer_.invocation_ok(rep.number,
+                                    p_rep.target, p_rep.operation,
+                                    peer_ep, elapsed);
                         try {
                             p_rep.reply(encaps->begin(), encaps->end());
                         } catch (...) {
@@ -824,9 +1152,10 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
                 case reply::success_no_body: {
                     DEBUG_LOG_TAG(3, tag, "Reply #" << rep.number
                             << " status is success without body");
-                    observer_.invocation_ok(rep.number,
-                            p_rep.target, p_rep.operation,
-                            peer_ep, elapsed);
+                    if (observe)
+                        observer_.invocation_ok(rep.number,
+                                p_rep.target, p_rep.operation,
+                                peer_ep, elapsed);
                     if (p_rep.reply) {
                         try {
                             p_rep.reply( incoming::const_iterator{}, incoming::const_iterator{} );
@@ -860,9 +1189,10 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
                                         op.target.facet,
                                     op.operation
                                 });
-                        observer_.invocation_error(rep.number,
-                                p_rep.target, p_rep.operation,
-                                peer_ep, p_rep.sent, ex, elapsed);
+                        if (observe)
+                            observer_.invocation_error(rep.number,
+                                    p_rep.target, p_rep.operation,
+                                    peer_ep, p_rep.sent, ex, elapsed);
                         try {
                             p_rep.error(ex);
                         } catch (...) {
@@ -889,9 +1219,10 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
                         read(b, encaps->end(), exc);
                         encaps->read_indirection_table(b);
                         auto ex = exc->make_exception_ptr();
-                        observer_.invocation_error(rep.number,
-                                p_rep.target, p_rep.operation,
-                                peer_ep, p_rep.sent, ex, elapsed);
+                        if (observe)
+                            observer_.invocation_error(rep.number,
+                                    p_rep.target, p_rep.operation,
+                                    peer_ep, p_rep.sent, ex, elapsed);
                         try {
                             p_rep.error(ex);
                         } catch (...) {
@@ -904,9 +1235,10 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
                     if (p_rep.error) {
                         auto ex = ::std::make_exception_ptr(
                                 errors::unmarshal_error{ "Unhandled reply status" } );
-                        observer_.invocation_error(rep.number,
-                                p_rep.target, p_rep.operation,
-                                peer_ep, p_rep.sent, ex, elapsed);
+                        if (observe)
+                            observer_.invocation_error(rep.number,
+                                    p_rep.target, p_rep.operation,
+                                    peer_ep, p_rep.sent, ex, elapsed);
                         try {
                             p_rep.error(ex);
                         } catch (...) {
@@ -915,7 +1247,6 @@ connection_implementation::dispatch_reply(encoding::incoming_ptr buffer)
                     }
                     break;
             }
-            pending_replies_.erase(acc);
             DEBUG_LOG_TAG(3, tag, "Pending replies: " << pending_replies_.size());
         } else {
             // else discard the reply (it can be timed out)
@@ -946,7 +1277,7 @@ connection_implementation::send_not_found(
         outgoing::encaps_guard guard{ out->begin_encapsulation() };
         write(::std::back_inserter(*out), op);
     }
-    process_event(events::send_reply{out});
+    dispatch_event(events::send_reply{out});
 }
 
 void
@@ -979,7 +1310,7 @@ connection_implementation::send_exception(request_number req_num, errors::user_e
         outgoing::encaps_guard guard{ out->begin_encapsulation() };
         e.__wire_write(o);
     }
-    process_event(events::send_reply{out});
+    dispatch_event(events::send_reply{out});
 }
 
 void
@@ -997,7 +1328,7 @@ connection_implementation::send_exception(request_number req_num, ::std::excepti
         errors::unexpected ue { demangle(typeid(e).name()), ::std::string{e.what()} };
         ue.__wire_write(o);
     }
-    process_event(events::send_reply{out});
+    dispatch_event(events::send_reply{out});
 }
 
 void
@@ -1018,18 +1349,216 @@ connection_implementation::send_unknown_exception(request_number req_num)
             "Unexpected exception not deriving from std::exception"s};
         ue.__wire_write(o);
     }
-    process_event(events::send_reply{out});
+    dispatch_event(events::send_reply{out});
+}
+
+void
+connection_implementation::schedule_request(encoding::incoming_ptr incoming)
+{
+    // The request is counted while it waits in the io_service or executor
+    // queue, so that the read window bounds the queue length.
+    ++outstanding_responses_;
+    try {
+        post_request(incoming);
+    } catch (...) {
+        response_done();
+        throw;
+    }
 }
 
+void
+connection_implementation::post_request(encoding::incoming_ptr incoming)
+{
+    adapter_ptr adp = adapter_.lock();
+    auto executor = adp ? adp->executor() : detail::dispatch_executor_ptr{};
+    if (!executor) {
+        post(&connection_implementation::dispatch_incoming_request, incoming);
+        return;
+    }
+    auto _this = shared_from_this();
+    detail::dispatch_executor::task_type task =
+        [_this, incoming]()
+        {
+            _this->dispatch_incoming_request(incoming);
+        };
+    if (incoming->header().flags & encoding::message::urgent) {
+        // Urgent requests don't wait for the normal ones queued in the
+        // executor
+        executor->post_urgent(::std::move(task));
+        return;
+    }
+    switch (executor->ordering()) {
+        case dispatch_ordering::connection:
+            executor->post(number_, ::std::move(task));
+            break;
+        case dispatch_ordering::target: {
+            // Peek the request header for the target identity, errors are
+            // reported when the request is dispatched
+            ::std::size_t key = 0;
+            try {
+                encoding::request req;
+                encoding::incoming::const_iterator b = incoming->begin();
+                encoding::incoming::const_iterator e = incoming->end();
+                read(b, e, req);
+                key = ::std::hash< identity >{}(req.operation.target.identity);
+            } catch (...) {}
+            executor->post(key, ::std::move(task));
+            break;
+        }
+        default:
+            executor->post(::std::move(task));
+            break;
+    }
+}
+
+struct connection_implementation::incoming_request {
+    using allocator_type    = pool_allocator< incoming_request >;
+    using atomic_flag       = ::std::atomic_flag;
+
+    connection_impl_ptr             conn;
+    encoding::request               req;
+    bool                            expect_reply    = false;
+    time_point                      start;
+    context_type                    context;
+    encoding::multiple_targets      targets;
+    current                         curr;
+    detail::dispatch_request        dispatch;
+    atomic_flag                     responded{false};
+
+    incoming_request(connection_impl_ptr c)
+        : conn{::std::move(c)}, start{clock_type::now()}
+    {
+    }
+
+    ~incoming_request()
+    {
+        if (expect_reply && respond()) {
+            DEBUG_LOG_TAG(3, conn->tag, "Invocation #" << req.number
+                    << " to " << req.operation.target.identity
+                    << " operation " << req.operation.operation
+                    << " failed to respond");
+            if (conn->observer_.has_observers())
+                conn->observer_.request_no_response(req.number,
+                        req.operation.target, req.operation.operation,
+                        curr.peer_endpoint, clock_type::now() - start);
+            conn->send_not_found(req.number, errors::not_found::object,
+                    req.operation);
+            conn->response_done();
+        }
+    }
+
+    bool
+    respond()
+    {
+        return !responded.test_and_set();
+    }
+
+    void
+    send_result(encoding::outgoing&& res)
+    {
+        using namespace encoding;
+        if (respond()) {
+            DEBUG_LOG_TAG(3, conn->tag,
+                    "Request #" << req.number << " success responce");
+            if (conn->observer_.has_observers())
+                conn->observer_.request_ok(req.number,
+                    req.operation.target, req.operation.operation,
+                    curr.peer_endpoint, clock_type::now() - start);
+            pool_allocator< outgoing > alloc;
+            outgoing_ptr out;
+            if (res.type() == message::reply) {
+                // The result was marshalled by the reply writer
+                auto encaps = res.current_encapsulation();
+                if (!encaps.empty()) {
+                    encaps.end_encaps();
+                    out = ::std::allocate_shared< outgoing >(alloc, ::std::move(res));
+                }
+            } else if (!res.empty()) {
+                out = ::std::allocate_shared< outgoing >(alloc, conn->get_connector(),
+                        dispatch.reply_flags);
+                write(::std::back_inserter(*out), reply{ req.number, reply::success });
+                res.close_all_encaps();
+                out->insert_encapsulation(::std::move(res));
+            }
+            if (!out) {
+                out = ::std::allocate_shared< outgoing >(alloc, conn->get_connector(),
+                        dispatch.reply_flags);
+                write(::std::back_inserter(*out), reply{ req.number, reply::success_no_body });
+            }
+            conn->dispatch_event(events::send_reply{out});
+            conn->response_done();
+        } else {
+            if (conn->observer_.has_observers())
+                conn->observer_.request_double_response(req.number,
+                    req.operation.target, req.operation.operation,
+                    curr.peer_endpoint);
+        }
+    }
+
+    void
+    send_error(::std::exception_ptr ex)
+    {
+        if (respond()) {
+            DEBUG_LOG_TAG(3, conn->tag,
+                    "Request #" << req.number << " exception responce");
+            if (conn->observer_.has_observers())
+                conn->observer_.request_error(req.number,
+                    req.operation.target, req.operation.operation,
+                    curr.peer_endpoint, ex, clock_type::now() - start);
+            try {
+                ::std::rethrow_exception(ex);
+            } catch (errors::not_found const& e) {
+                conn->send_not_found(req.number, e.subj(), req.operation);
+            } catch (errors::user_exception const& e) {
+                conn->send_exception(req.number, e);
+            } catch (::std::exception const& e) {
+                conn->send_exception(req.number, e);
+            } catch (...) {
+                conn->send_unknown_exception(req.number);
+            }
+            conn->response_done();
+        } else {
+            if (conn->observer_.has_observers())
+                conn->observer_.request_double_response(req.number,
+                    req.operation.target, req.operation.operation,
+                    curr.peer_endpoint);
+        }
+    }
+
+    /**
+     * Drop the references the request holds to itself and to the adapter.
+     * Servants that answer asynchronously keep their own copies of the
+     * callbacks.
+     */
+    void
+    release()
+    {
+        dispatch.result = nullptr;
+        dispatch.exception = nullptr;
+        curr.context.reset();
+        curr.adapter.reset();
+    }
+};
+
 void
 connection_implementation::dispatch_incoming_request(encoding::incoming_ptr buffer)
 {
     using namespace encoding;
+    // The request was counted when it was scheduled. For a two-way request
+    // the count is handed over to the reply callbacks, otherwise it is
+    // released when the function returns.
+    bool counted = true;
     try {
-        request req;
+        // The request, its context, current and the dispatch callbacks
+        // share a single pooled allocation
+        incoming_request_ptr st = ::std::allocate_shared< incoming_request >(
+                incoming_request::allocator_type{}, shared_from_this());
+        request& req = st->req;
         incoming::const_iterator b = buffer->begin();
         incoming::const_iterator e = buffer->end();
         read(b, e, req);
+        bool one_way = req.mode & request::one_way;
+        bool urgent = buffer->header().flags & message::urgent;
         //Find invocation by req.operation.identity
         adapter_ptr adp = adapter_.lock();
         if (adp) {
@@ -1044,134 +1573,69 @@ connection_implementation::dispatch_incoming_request(encoding::incoming_ptr buff
                 os << req.operation.target.identity << "\n";
             ::std::cerr << os.str();
             #endif
-            time_point req_start = clock_type::now();
-            auto peer_ep = remote_endpoint();
-            observer_.receive_request(req.number,
-                    req.operation.target, req.operation.operation, peer_ep);
-            current curr {
-                req.operation,
-                {},
-                peer_ep,
-                adp
-            };
+            current& curr = st->curr;
+            curr.operation = req.operation;
+            curr.peer_endpoint = remote_endpoint();
+            curr.adapter = adp;
+            if (observer_.has_observers())
+                observer_.receive_request(req.number,
+                        req.operation.target, req.operation.operation, curr.peer_endpoint);
             if (!(req.mode & request::no_context)) {
-                auto ctx_ptr = ::std::make_shared<context_type>();
-                read(b, e, *ctx_ptr);
-                curr.context = ctx_ptr;
+                read(b, e, st->context);
             }
 
-            ::std::shared_ptr<encoding::multiple_targets> targets;
-            if (req.mode & request::multi_target) {
-                targets = ::std::make_shared< encoding::multiple_targets >();
-                read(b, e, *targets);
+            bool multi_target = req.mode & request::multi_target;
+            if (multi_target) {
+                read(b, e, st->targets);
             }
 
             incoming::encaps_guard encaps{ buffer->begin_encapsulation(b) };
             auto const& en = encaps.encaps();
-            detail::dispatch_request r;
-            if (req.mode & request::one_way) {
-                r = detail::dispatch_request{
-                        buffer, en.begin(), en.end(), en.size(),
-                        detail::dispatch_request::ignore_result,
-                        detail::dispatch_request::ignore_exception
-                    };
+            detail::dispatch_request& r = st->dispatch;
+            r.buffer        = buffer;
+            r.encaps_start  = en.begin();
+            r.encaps_end    = en.end();
+            r.encaps_size   = en.size();
+            if (one_way) {
+                r.result        = detail::dispatch_request::ignore_result;
+                r.exception     = detail::dispatch_request::ignore_exception;
             } else {
-                auto _this = shared_from_this();
-                auto fpg = ::std::make_shared< invocation_foolproof_guard >(
-                    [_this, req, req_start]() mutable {
-                        #if DEBUG_OUTPUT >= 3
-                        ::std::ostringstream os;
-                        _this->tag(os) << " Invocation #" << req.number
-                                << " to " << req.operation.target.identity
-                                << " operation " << req.operation.operation
-                                << " failed to respond\n";
-                        ::std::cerr << os.str();
-                        #endif
-                        _this->observer_.request_no_response(req.number,
-                                req.operation.target, req.operation.operation,
-                                _this->remote_endpoint(),
-                                clock_type::now() - req_start);
-                        _this->send_not_found(req.number, errors::not_found::object,
-                                req.operation);
-                    });
-                r = detail::dispatch_request{
-                        buffer, en.begin(), en.end(), en.size(),
-                        [_this, req, fpg, req_start](outgoing&& res) mutable {
-                            if (fpg->respond()) {
-                                DEBUG_LOG_TAG(3, _this->tag,
-                                        "Request #" << req.number << " success responce");
-                                _this->observer_.request_ok(req.number,
-                                    req.operation.target, req.operation.operation,
-                                    _this->remote_endpoint(),
-                                    clock_type::now() - req_start);
-                                outgoing_ptr out =
-                                        ::std::make_shared<outgoing>(_this->get_connector(), message::reply);
-                                reply rep {
-                                    req.number,
-                                    res.empty() ? reply::success_no_body : reply::success
-                                };
-                                write(::std::back_inserter(*out), rep);
-                                if (!res.empty()) {
-                                    res.close_all_encaps();
-                                    out->insert_encapsulation(::std::move(res));
-                                }
-                                _this->process_event(events::send_reply{out});
-                            } else {
-                                _this->observer_.request_double_response(
-                                    req.number,
-                                    req.operation.target,
-                                    req.operation.operation,
-                                    _this->remote_endpoint());
-                            }
-                        },
-                        [_this, req, fpg, req_start](::std::exception_ptr ex) mutable {
-                            if (fpg->respond()) {
-                                #if DEBUG_OUTPUT >= 3
-                                ::std::ostringstream os;
-                                _this->tag(os) << " Request #" << req.number
-                                        << " exception responce\n";
-                                ::std::cerr << os.str();
-                                #endif
-                                _this->observer_.request_error(req.number,
-                                    req.operation.target, req.operation.operation,
-                                    _this->remote_endpoint(), ex,
-                                    clock_type::now() - req_start);
-                                try {
-                                    ::std::rethrow_exception(ex);
-                                } catch (errors::not_found const& e) {
-                                    _this->send_not_found(req.number, e.subj(), req.operation);
-                                } catch (errors::user_exception const& e) {
-                                    _this->send_exception(req.number, e);
-                                } catch (::std::exception const& e) {
-                                    _this->send_exception(req.number, e);
-                                } catch (...) {
-                                    _this->send_unknown_exception(req.number);
-                                }
-                            } else {
-                                _this->observer_.request_double_response(
-                                    req.number,
-                                    req.operation.target,
-                                    req.operation.operation,
-                                    _this->remote_endpoint());
-                            }
-                        }
-                };
+                st->expect_reply = true;
+                counted         = false;
+                r.number        = req.number;
+                r.reply_flags   = urgent ? message::reply | message::urgent : message::reply;
+                r.result        = [st](outgoing&& res) { st->send_result(::std::move(res)); };
+                r.exception     = [st](::std::exception_ptr ex) { st->send_error(ex); };
             }
-            if (targets) {
-                for (auto const& tgt : *targets) {
-                    curr.operation.target = tgt;
-                    adp->dispatch(r, curr);
+            if (!(req.mode & request::no_context)) {
+                curr.context = context_const_ptr{ st, &st->context };
+            }
+            bool dispatched = false;
+            try {
+                if (multi_target) {
+                    for (auto const& tgt : st->targets) {
+                        curr.operation.target = tgt;
+                        adp->dispatch(r, curr);
+                    }
+                    dispatched = true;
+                } else {
+                    dispatched = adp->dispatch(r, curr);
                 }
+            } catch (...) {
+                st->release();
+                throw;
+            }
+            st->release();
+            if (dispatched) {
+                if (counted)
+                    response_done();
                 return;
-            } else if (adp->dispatch(r, curr)) {
-                return;
-            } else {
-                #if DEBUG_OUTPUT >= 3
-                ::std::ostringstream os;
-                tag(os) << " No object\n";
-                ::std::cerr << os.str();
-                #endif
             }
+            #if DEBUG_OUTPUT >= 3
+            ::std::ostringstream os;
+            tag(os) << " No object\n";
+            ::std::cerr << os.str();
+            #endif
         } else {
             #if DEBUG_OUTPUT >= 3
             ::std::ostringstream os;
@@ -1180,17 +1644,24 @@ connection_implementation::dispatch_incoming_request(encoding::incoming_ptr buff
             #endif
         }
         // FIXME If the adapter::dispatch returns false, a no response error occurs
-        send_not_found(req.number, errors::not_found::object, req.operation);
+        if (one_way || st->respond()) {
+            send_not_found(req.number, errors::not_found::object, req.operation);
+            // Reply callbacks won't release the request any more
+            counted = true;
+        }
     } catch (...) {
         connection_failure( ::std::current_exception() );
     }
+    if (counted)
+        response_done();
 }
 
 void
 connection_implementation::connection_failure(::std::exception_ptr ex)
 {
-    process_event(events::connection_failure{ ex });
-    observer_.connection_failure(remote_endpoint(), ex);
+    dispatch_event(events::connection_failure{ ex });
+    if (observer_.has_observers())
+        observer_.connection_failure(remote_endpoint(), ex);
 }
 
 }  // namespace detail
@@ -1355,5 +1826,12 @@ connection::remote_endpoint() const
     return pimpl_->remote_endpoint();
 }
 
+::std::size_t
+connection::outstanding_requests() const
+{
+    assert(pimpl_.get() && "Connection implementation is not set");
+    return pimpl_->outstanding_requests();
+}
+
 }  // namespace core
 }  // namespace wire
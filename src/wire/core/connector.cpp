@@ -18,6 +18,8 @@
 
 #include <wire/core/detail/configuration_options.hpp>
 #include <wire/core/detail/io_service_monitor.hpp>
+#include <wire/core/detail/ssl_session_cache.hpp>
+#include <wire/core/detail/uring_service.hpp>
 #include <wire/core/detail/reference_resolver.hpp>
 
 #include <wire/util/io_service_wait.hpp>
@@ -27,6 +29,8 @@
 
 #include <tbb/concurrent_hash_map.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -41,7 +45,25 @@ struct connector::impl {
     using mutex_type            = ::std::mutex;
     using lock_guard            = ::std::lock_guard<mutex_type>;
 
-    using connection_container  = ::tbb::concurrent_hash_map<endpoint, connection_ptr>;
+    /**
+     * Connection of an endpoint pool. Requests are counted by the
+     * connection when they are invoked, callers that wait for the
+     * connection to be established are counted by the pool.
+     */
+    struct pooled_connection {
+        using counter_ptr = ::std::shared_ptr< ::std::atomic< ::std::size_t > >;
+
+        connection_ptr  conn;
+        counter_ptr     waiting;
+
+        ::std::size_t
+        load() const
+        {
+            return conn->outstanding_requests() + waiting->load();
+        }
+    };
+    using connection_pool       = ::std::vector<pooled_connection>;
+    using connection_container  = ::tbb::concurrent_hash_map<endpoint, connection_pool>;
     using connection_accessor   = connection_container::accessor;
     using connection_const_accessor = connection_container::const_accessor;
 
@@ -71,6 +93,7 @@ struct connector::impl {
     //@{
     /** @name Connections */
     connection_container        outgoing_;
+    connection_container        bulk_outgoing_;
     //@}
 
     //@{
@@ -101,6 +124,7 @@ struct connector::impl {
     {
         register_shutdown_observer();
         create_options_description();
+        init_ssl_sessions();
     }
 
     impl(asio_config::io_service_ptr svc, ::std::string const& name)
@@ -110,6 +134,7 @@ struct connector::impl {
     {
         register_shutdown_observer();
         create_options_description();
+        init_ssl_sessions();
     }
 
     void
@@ -119,6 +144,15 @@ struct connector::impl {
         default_resolver_.set_owner(cnctr);
     }
 
+    void
+    init_ssl_sessions()
+    {
+        options_.client_ssl.session_cache =
+                ::std::make_shared< detail::ssl_session_cache >();
+        options_.server_ssl.ticket_keys =
+                detail::ssl_session_cache::generate_ticket_keys();
+    }
+
     void
     register_shutdown_observer()
     {
@@ -157,6 +191,9 @@ struct connector::impl {
         ((name + ".admin.connector").c_str(),
                 po::value<identity>(&options_.admin_connector),
                 "Identity for connector admin")
+        ((name + ".io_uring").c_str(),
+                po::bool_switch(&options_.io_uring)->default_value(false),
+                "Use io_uring for tcp and socket connections when available")
         ;
         po::options_description server_ssl_opts("Server SSL Options");
         server_ssl_opts.add_options()
@@ -172,6 +209,10 @@ struct connector::impl {
         ((name + ".ssl.server.require_peer_cert").c_str(),
                 po::bool_switch(&options_.server_ssl.require_peer_cert),
                 "Require client SSL certificate")
+        ((name + ".ssl.server.ticket_key_file").c_str(),
+                po::value<::std::string>(&options_.server_ssl.ticket_key_file),
+                "File with session ticket keys. Servers sharing the keys "
+                "can resume each other's sessions. If missing, random keys are used")
         ;
         po::options_description client_ssl_opts("Client SSL Options");
         client_ssl_opts.add_options()
@@ -184,6 +225,9 @@ struct connector::impl {
         ((name + ".ssl.client.verify_file").c_str(),
                 po::value<::std::string>(&options_.client_ssl.verify_file),
                 "SSL verify file (CA root). If missing, default system certificates are used")
+        ((name + ".ssl.client.no_session_cache").c_str(),
+                po::bool_switch(&options_.no_ssl_session_cache)->default_value(false),
+                "Don't resume SSL sessions")
         ;
         po::options_description connection_mgmt_opts("Connection management options");
         connection_mgmt_opts.add_options()
@@ -196,18 +240,50 @@ struct connector::impl {
         ((name + ".cm.request_timeout").c_str(),
                 po::value<::std::size_t>(&options_.request_timeout)->default_value(5000),
                 "Request timeout, in milliseconds")
+        ((name + ".cm.pool_size").c_str(),
+                po::value<::std::size_t>(&options_.connection_pool_size)->default_value(1),
+                "Maximum number of connections to an endpoint")
+        ((name + ".cm.bulk_pool_size").c_str(),
+                po::value<::std::size_t>(&options_.bulk_pool_size)->default_value(1),
+                "Maximum number of connections to an endpoint for bulk invocations")
+        ((name + ".cm.optimistic_handshake").c_str(),
+                po::bool_switch(&options_.optimistic_handshake)->default_value(false),
+                "Send requests on a new connection without waiting for "
+                "the server's validate message")
+        ((name + ".cm.max_requests").c_str(),
+                po::value<::std::size_t>(&options_.max_outstanding_requests)->default_value(0),
+                "Maximum number of requests in flight per connection, 0 - unlimited")
+        ((name + ".cm.max_bytes").c_str(),
+                po::value<::std::size_t>(&options_.max_outstanding_bytes)->default_value(0),
+                "Maximum number of request bytes queued per connection, 0 - unlimited")
+        ((name + ".cm.max_queued").c_str(),
+                po::value<::std::size_t>(&options_.max_queued_requests)->default_value(0),
+                "Maximum number of invocations waiting for a connection's "
+                "request window, 0 - unlimited")
+        ((name + ".cm.max_dispatch").c_str(),
+                po::value<::std::size_t>(&options_.max_dispatch_requests)->default_value(0),
+                "Maximum number of incoming requests in dispatch per connection, "
+                "0 - unlimited")
+        ;
+        po::options_description monitoring_opts("Monitoring options");
+        monitoring_opts.add_options()
+        ((name + ".observers.batch").c_str(),
+                po::bool_switch(&options_.batch_observer_events)->default_value(false),
+                "Deliver connection observer events in batches")
         ;
 
         cmd_line_options_.add(cfg_opts)
                 .add(connector_options)
                 .add(server_ssl_opts)
                 .add(client_ssl_opts)
-                .add(connection_mgmt_opts);
+                .add(connection_mgmt_opts)
+                .add(monitoring_opts);
         cfg_file_options_
                 .add(connector_options)
                 .add(server_ssl_opts)
                 .add(client_ssl_opts)
-                .add(connection_mgmt_opts);
+                .add(connection_mgmt_opts)
+                .add(monitoring_opts);
     }
 
     void
@@ -257,6 +333,16 @@ struct connector::impl {
     void
     apply_options()
     {
+        if (options_.no_ssl_session_cache) {
+            options_.client_ssl.session_cache.reset();
+        }
+        if (!options_.server_ssl.ticket_key_file.empty()) {
+            options_.server_ssl.ticket_keys = detail::ssl_session_cache::read_ticket_keys(
+                    options_.server_ssl.ticket_key_file);
+        }
+        if (options_.io_uring && !detail::uring_service::enable(*io_service_)) {
+            DEBUG_LOG_TAG(1, tag, "io_uring is not available, using the default reactor");
+        }
         if (!options_.admin_endpoints.empty()) {
             create_connector_admin();
         }
@@ -348,6 +434,18 @@ struct connector::impl {
                 "Locator proxy")
         ;
 
+        ::std::string dispatch_order;
+        po::options_description adapter_dispatch_opts(name + " Adapter Dispatch Options");
+        adapter_dispatch_opts.add_options()
+        ((name + ".dispatch.threads").c_str(),
+                po::value<::std::size_t>(&aopts.dispatch_threads)->default_value(0),
+                "Number of threads dispatching requests, 0 - dispatch in the I/O threads. "
+                "Queued requests are bounded by the connector's cm.max_dispatch")
+        ((name + ".dispatch.order").c_str(),
+                po::value<::std::string>(&dispatch_order)->default_value("connection"),
+                "Order of dispatched requests: unordered, connection or target")
+        ;
+
         po::options_description adapter_ssl_opts(name + " Adapter SSL Options");
         adapter_ssl_opts.add_options()
         ((name + ".ssl.certificate").c_str(),
@@ -367,11 +465,23 @@ struct connector::impl {
                 "Don't require client SSL certificate (for overloading connector's settings)")
         ;
 
-        adapter_opts.add(adapter_general_opts).add(adapter_ssl_opts);
+        adapter_opts.add(adapter_general_opts).add(adapter_dispatch_opts)
+                .add(adapter_ssl_opts);
 
         po::variables_map vm;
         configure_options(adapter_opts, vm);
 
+        if (dispatch_order == "unordered") {
+            aopts.dispatch_order = detail::dispatch_ordering::unordered;
+        } else if (dispatch_order == "connection") {
+            aopts.dispatch_order = detail::dispatch_ordering::connection;
+        } else if (dispatch_order == "target") {
+            aopts.dispatch_order = detail::dispatch_ordering::target;
+        } else {
+            throw errors::runtime_error("Invalid dispatch order ", dispatch_order,
+                    " for adapter ", name);
+        }
+
         if (vm.count(name + ".ssl.no_require_peer_cert")) {
             aopts.adapter_ssl.require_peer_cert = false;
         }
@@ -773,28 +883,44 @@ struct connector::impl {
             functional::report_exception(exception, errors::runtime_error{ "Invalid endpoint data" });
             return;
         }
+        bool bulk = opts.is_bulk();
+        auto& container = bulk ? bulk_outgoing_ : outgoing_;
+        ::std::size_t pool_size = ::std::max< ::std::size_t >(1,
+                bulk ? options_.bulk_pool_size : options_.connection_pool_size);
         bool new_conn = false;
         connection_ptr conn;
+        pooled_connection::counter_ptr waiting;
         {
             connection_accessor acc;
-            if (outgoing_.find(acc, ep)) {
-                conn = acc->second;
-            } else {
+            container.insert(acc, ep);
+            auto& pool = acc->second;
+            // Pick the connection with the least requests in flight or
+            // waiting for it
+            ::std::size_t least = 0;
+            for (auto const& c : pool) {
+                auto load = c.load();
+                if (!conn || load < least) {
+                    conn = c.conn;
+                    least = load;
+                }
+            }
+            if (!conn || (least > 0 && pool.size() < pool_size)) {
                 conn = ::std::make_shared< connection >(
                         client_side{}, bidir_adapter(), ep.transport(),
-                        [this, ep](connection const* c)
+                        [this, ep, bulk](connection const* c)
                         {
-                            erase_outgoing(ep);
+                            erase_outgoing(ep, c, bulk);
                         });
-                new_conn = outgoing_.emplace(acc, ep, conn);
-                conn = acc->second;
+                waiting = ::std::make_shared< ::std::atomic< ::std::size_t > >(1);
+                pool.push_back(pooled_connection{ conn, waiting });
+                new_conn = true;
             }
         }
         if (new_conn) {
             auto done = ::std::make_shared< ::std::atomic<bool> >(false);
             DEBUG_LOG_TAG(2, tag, "Start connection to " << ep);
             conn->connect_async(ep,
-                [on_get, conn, done, ep]()
+                [on_get, conn, done, waiting, ep]()
                 {
                     DEBUG_LOG_TAG(2, tag, "Connected to " << ep);
                     *done = true;
@@ -803,11 +929,15 @@ struct connector::impl {
                     } catch(...) {
                         DEBUG_LOG_TAG(1, tag, "Exception while setting connection");
                     }
+                    // The caller has invoked on the connection by now, the
+                    // request is counted by the connection
+                    --*waiting;
                 },
-                [exception, done, ep](::std::exception_ptr ex)
+                [exception, done, waiting, ep](::std::exception_ptr ex)
                 {
                     DEBUG_LOG_TAG(2, tag, "Failed to connect to " << ep);
                     *done = true;
+                    --*waiting;
                     functional::report_exception(exception, ex);
                 });
 
@@ -825,13 +955,19 @@ struct connector::impl {
     }
 
     void
-    erase_outgoing(endpoint ep)
+    erase_outgoing(endpoint ep, connection const* conn, bool bulk)
     {
         DEBUG_LOG_TAG(1, tag, "Outgoing connection to " << ep << " closed");
+        auto& container = bulk ? bulk_outgoing_ : outgoing_;
         connection_accessor acc;
-        if (outgoing_.find(acc, ep)) {
-            DEBUG_LOG_TAG(1, tag, "Erase connection to " << ep);
-            outgoing_.erase(acc);
+        if (container.find(acc, ep)) {
+            auto& pool = acc->second;
+            pool.erase(::std::remove_if(pool.begin(), pool.end(),
+                [conn](pooled_connection const& c){ return c.conn.get() == conn; }), pool.end());
+            if (pool.empty()) {
+                DEBUG_LOG_TAG(1, tag, "Erase connection to " << ep);
+                container.erase(acc);
+            }
         }
     }
 
@@ -16,6 +16,9 @@
 
 #include <wire/core/detail/configuration_options.hpp>
 #include <wire/core/detail/observer_container.hpp>
+#include <wire/core/detail/timing_wheel.hpp>
+#include <wire/core/detail/request_table.hpp>
+#include <wire/core/detail/write_aggregator.hpp>
 
 #include <wire/encoding/buffers.hpp>
 
@@ -28,11 +31,9 @@
 
 #include <afsm/fsm.hpp>
 
-#include <tbb/concurrent_hash_map.h>
-#include <tbb/concurrent_priority_queue.h>
-
 #include <iostream>
 #include <atomic>
+#include <deque>
 #include <map>
 #include <mutex>
 
@@ -85,6 +86,7 @@ struct receive_data{
 struct send_request{
     encoding::outgoing_ptr              outgoing;
     functional::void_callback           sent;
+    functional::exception_callback      error   = nullptr;
 };
 struct send_reply{
     encoding::outgoing_ptr              outgoing;
@@ -112,6 +114,8 @@ struct connection_fsm_def :
     using transition_table = ::afsm::def::transition_table<T...>;
     template < typename Predicate >
     using not_ = ::psst::meta::not_<Predicate>;
+    template < typename ... Predicates >
+    using and_ = ::psst::meta::and_<Predicates...>;
 
     using none = ::afsm::none;
 
@@ -155,6 +159,26 @@ struct connection_fsm_def :
             return fsm->is_stream_oriented();
         }
     };
+    /**
+     * Client connection doesn't wait for the server's validate message
+     * before sending requests
+     */
+    struct is_optimistic {
+        template < typename FSM, typename State >
+        bool
+        operator()(FSM const& fsm, State const&)
+        {
+            return root_machine(fsm)->optimistic_handshake();
+        }
+    };
+    struct has_queued_writes {
+        template < typename FSM, typename State >
+        bool
+        operator()(FSM const& fsm, State const&)
+        {
+            return root_machine(fsm)->has_queued_writes();
+        }
+    };
     //@}
     //@{
     /** @name Actions */
@@ -187,6 +211,22 @@ struct connection_fsm_def :
             DEBUG_LOG_TAG(3, root_machine(fsm)->tag, "on_connected action (receive_validate)")
         }
     };
+    /**
+     * Optimistic handshake, the client sends its validate message right
+     * after connect. The connection goes online when the message is
+     * written, the server's validate message is checked when it arrives.
+     */
+    struct on_connected_optimistic {
+        template < typename FSM >
+        void
+        operator()(events::connected const& evt, FSM& fsm,
+                connecting& from, wait_validate& to)
+        {
+            DEBUG_LOG_TAG(3, root_machine(fsm)->tag, "on_connected action (optimistic)")
+            on_connected{}(evt, fsm, from, to);
+            root_machine(fsm)->send_validate_message();
+        }
+    };
     struct server_start {
         template < typename Event, typename FSM, typename SourceState, typename TargetState >
         void
@@ -230,6 +270,28 @@ struct connection_fsm_def :
             root_machine(fsm)->write_async(rep.outgoing);
         }
     };
+    struct queue_write {
+        template < typename FSM, typename SourceState, typename TargetState >
+        void
+        operator()(events::send_request const& req, FSM& fsm, SourceState&, TargetState&)
+        {
+            root_machine(fsm)->queue_write(req.outgoing, req.sent, req.error);
+        }
+        template < typename FSM, typename SourceState, typename TargetState >
+        void
+        operator()(events::send_reply const& rep, FSM& fsm, SourceState&, TargetState&)
+        {
+            root_machine(fsm)->queue_write(rep.outgoing, nullptr);
+        }
+    };
+    struct write_next {
+        template < typename FSM, typename SourceState, typename TargetState >
+        void
+        operator()(events::write_done const&, FSM& fsm, SourceState&, TargetState&)
+        {
+            root_machine(fsm)->write_next();
+        }
+    };
     struct process_incoming {
         template < typename FSM, typename SourceState, typename TargetState >
         void
@@ -243,7 +305,7 @@ struct connection_fsm_def :
         void
         operator()(events::receive_request const& req, FSM& fsm, SourceState&, TargetState&)
         {
-            root_machine(fsm)->post(&concrete_type::dispatch_incoming_request, req.incoming);
+            root_machine(fsm)->schedule_request(req.incoming);
         }
     };
     struct dispatch_reply {
@@ -299,7 +361,10 @@ struct connection_fsm_def :
             /* Event                    |   Action          |   Guard   */
             in< events::receive_data    , process_incoming  , none              >,
             in< events::validate_sent   , none              , is_server         >,
-            in< events::receive_validate, send_validate     , not_<is_server>   >
+            in< events::receive_validate, send_validate     ,
+                    and_< not_<is_server>, not_<is_optimistic> >                >,
+            in< events::receive_validate, none              ,
+                    and_< not_<is_server>, is_optimistic >                      >
         >;
 
         wait_validate()
@@ -341,19 +406,23 @@ struct connection_fsm_def :
 
     struct online : state_machine< online > {
         struct write_idle : state<write_idle> {};
-        struct write_busy : state<write_busy> {
-            using deferred_events = type_tuple<
-                events::send_request, events::send_reply
-            >;
-        };
+        /**
+         * Messages sent while a write is in progress are queued by the
+         * connection in urgent and normal lanes, urgent messages are
+         * written first.
+         */
+        struct write_busy : state<write_busy> {};
         using initial_state = write_idle;
         using transitions = transition_table <
-            /*  Start           Event                   Next            Action       */
-            /* Writing to socket                                                     */
-            /*----------------+-----------------------+---------------+--------------*/
-            tr< write_idle    , events::send_request  , write_busy    , send_request >,
-            tr< write_idle    , events::send_reply    , write_busy    , send_reply   >,
-            tr< write_busy    , events::write_done    , write_idle    , none         >
+            /*  Start           Event                   Next            Action          Guard                       */
+            /* Writing to socket                                                                                    */
+            /*----------------+-----------------------+---------------+---------------+-----------------------------*/
+            tr< write_idle    , events::send_request  , write_busy    , send_request  , none                        >,
+            tr< write_idle    , events::send_reply    , write_busy    , send_reply    , none                        >,
+            tr< write_busy    , events::send_request  , write_busy    , queue_write   , none                        >,
+            tr< write_busy    , events::send_reply    , write_busy    , queue_write   , none                        >,
+            tr< write_busy    , events::write_done    , write_busy    , write_next    , has_queued_writes           >,
+            tr< write_busy    , events::write_done    , write_idle    , none          , not_<has_queued_writes>     >
         >;
         using internal_transitions = transition_table<
             /* Event                    |   Action          |   Guard   */
@@ -365,7 +434,8 @@ struct connection_fsm_def :
             in< events::receive_validate,   none            ,   none    >,
             /* Miscellaneous                                            */
             /*--------------------------+-------------------+-----------*/
-            in< events::connected       ,   none            ,   none    >
+            in< events::connected       ,   none            ,   none    >,
+            in< events::validate_sent   ,   none            ,   none    >
         >;
         template < typename FSM, typename Event >
         void
@@ -392,7 +462,10 @@ struct connection_fsm_def :
         /*  Start           Event                       Next                Action          Guard                       */
         /* Start client connection */
         tr< unplugged,      events::connect,            connecting,         connect,        none                        >,
-        tr< connecting,     events::connected,          wait_validate,      on_connected,   is_stream_oriented          >,
+        tr< connecting,     events::connected,          wait_validate,      on_connected,
+                and_< is_stream_oriented, not_<is_optimistic> >                                             >,
+        tr< connecting,     events::connected,          wait_validate,      on_connected_optimistic,
+                and_< is_stream_oriented, is_optimistic >                                                   >,
         tr< connecting,     events::connected,          online,             none,           not_<is_stream_oriented>    >,
         /* Start server connection */
         tr< unplugged,      events::start,              connecting,         server_start,   is_stream_oriented          >,
@@ -428,8 +501,19 @@ struct connection_fsm_def :
     connection_mode mode_;
 };
 
+#ifdef WIRE_CONNECTION_STRAND
+/**
+ * All events of a connection are serialized on the connection's strand,
+ * the state machine doesn't need a mutex.
+ */
+using connection_fsm_mutex = ::afsm::none;
+#else
+using connection_fsm_mutex = ::std::mutex;
+#endif
+
 using connection_fsm = ::afsm::state_machine<
-        connection_fsm_def<::std::mutex, connection_implementation>, ::std::mutex
+        connection_fsm_def<connection_fsm_mutex, connection_implementation>,
+        connection_fsm_mutex
 #if DEBUG_OUTPUT >= 3
         , detail::conection_fsm_observer
 #endif
@@ -450,21 +534,76 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
         encoding::reply_callback                reply;
         functional::exception_callback          error;
         time_point                              start;
-        bool                                    sent;
+        bool                                    sent    = false;
+        /** The request holds a slot in the request window */
+        bool                                    credited = false;
+        /** The request was sent with the urgent flag */
+        bool                                    urgent  = false;
+        timing_wheel::timer_id                  timer   = timing_wheel::invalid_timer;
     };
-    struct reply_expiration {
+
+    using pending_replies_type  = request_table<pending_reply>;
+
+    /**
+     * Request waiting for the connection's request window. Tracked requests
+     * have an entry in the pending replies table, errors are reported
+     * via the entry.
+     */
+    struct waiting_request {
         request_number                  number;
-        time_point                      expires;
+        encoding::outgoing_ptr          outgoing;
+        functional::callback< bool >    sent;
+        functional::exception_callback  error;
+        bool                            tracked;
+        bool                            one_way;
+    };
+    using waiting_queue         = ::std::deque<waiting_request>;
 
-        bool
-        operator < (reply_expiration const& rhs) const
-        {
-            return expires > rhs.expires;
-        }
+    struct queued_write {
+        encoding::outgoing_ptr          outgoing;
+        functional::void_callback       sent;
+        functional::exception_callback  error;
     };
+    using write_queue           = ::std::deque<queued_write>;
+    using write_batch           = ::std::vector<queued_write>;
+    using outgoing_list         = ::std::vector<encoding::outgoing_ptr>;
+    /**
+     * Maximum size of queued messages coalesced into one write
+     */
+    static constexpr ::std::size_t max_write_batch = 64 * 1024;
 
-    using pending_replies_type  = ::tbb::concurrent_hash_map<request_number, pending_reply>;
-    using pending_replies_expire_queue = ::tbb::concurrent_priority_queue<reply_expiration>;
+    /**
+     * Per-connection flow control limits, zero means no limit
+     */
+    struct flow_limits {
+        ::std::size_t   requests;
+        ::std::size_t   bytes;
+        ::std::size_t   queued;
+        ::std::int32_t  dispatch;
+
+        flow_limits(connector_options const& opts)
+            : requests{opts.max_outstanding_requests},
+              bytes{opts.max_outstanding_bytes},
+              queued{opts.max_queued_requests},
+              dispatch{static_cast<::std::int32_t>(opts.max_dispatch_requests)}
+        {}
+
+        bool
+        window_enabled() const
+        { return requests > 0 || bytes > 0; }
+    };
+    /**
+     * Number of pending replies the request table is sized for. Replies
+     * are tracked for the requests in flight and for the ones waiting for
+     * the request window.
+     */
+    static ::std::size_t
+    expected_replies(connector_options const& opts)
+    {
+        if (opts.max_outstanding_requests == 0)
+            return 0;
+        return opts.max_outstanding_requests + opts.max_queued_requests;
+    }
 
     using mutex_type            = ::std::mutex;
     using lock_guard            = ::std::lock_guard<mutex_type>;
@@ -483,12 +622,24 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
           number_{ ++conn_counter_ },
           connector_{adptr->get_connector()},
           io_service_{adptr->io_service()},
+          strand_{*io_service_},
           connection_timer_{*io_service_},
           request_no_{0},
-          request_timer_{*io_service_},
+          timers_{asio_ns::use_service<timing_wheel>(*io_service_)},
+          idle_timer_{timing_wheel::invalid_timer},
+          last_activity_{0},
+          pending_replies_{ expected_replies(adptr->get_connector()->options()) },
           outstanding_responses_{0},
+          read_paused_{false},
+          terminated_{false},
+          peer_urgent_{true},
+          limits_{adptr->get_connector()->options()},
+          optimistic_handshake_{adptr->get_connector()->options().optimistic_handshake},
+          requests_in_flight_{0},
+          bytes_in_flight_{0},
           on_close_{ on_close },
-          observer_{adptr->io_service(), adptr->connection_observers()}
+          observer_{adptr->io_service(), adptr->connection_observers(),
+                adptr->get_connector()->options().batch_observer_events}
     {
         mode_ = client;
         DEBUG_LOG_TAG(1, tag, "Create client connection instance")
@@ -503,12 +654,24 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
           number_{ ++conn_counter_ },
           connector_{adptr->get_connector()},
           io_service_{adptr->io_service()},
+          strand_{*io_service_},
           connection_timer_{*io_service_},
           request_no_{0},
-          request_timer_{*io_service_},
+          timers_{asio_ns::use_service<timing_wheel>(*io_service_)},
+          idle_timer_{timing_wheel::invalid_timer},
+          last_activity_{0},
+          pending_replies_{ expected_replies(adptr->get_connector()->options()) },
           outstanding_responses_{0},
+          read_paused_{false},
+          terminated_{false},
+          peer_urgent_{true},
+          limits_{adptr->get_connector()->options()},
+          optimistic_handshake_{false},
+          requests_in_flight_{0},
+          bytes_in_flight_{0},
           on_close_{ on_close },
-          observer_{adptr->io_service(), adptr->connection_observers()}
+          observer_{adptr->io_service(), adptr->connection_observers(),
+                adptr->get_connector()->options().batch_observer_events}
     {
         mode_ = server;
         DEBUG_LOG_TAG(1, tag, "Create server connection instance")
@@ -521,7 +684,6 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
     virtual ~connection_implementation()
     {
         connection_timer_.cancel();
-        request_timer_.cancel();
         DEBUG_LOG_TAG(1, tag, "Destroy connection instance")
     }
 
@@ -532,10 +694,19 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
     virtual bool
     is_stream_oriented() const = 0;
 
+    bool
+    optimistic_handshake() const
+    { return optimistic_handshake_; }
+
+    /**
+     * Can be called from any thread, doesn't touch the state machine.
+     * Under WIRE_CONNECTION_STRAND the machine has no mutex and can be
+     * queried only from the strand.
+     */
     bool
     is_terminated() const
     {
-        return connection_fsm::is_in_state< connection_fsm_def::terminated >();
+        return terminated_;
     }
 
     virtual bool
@@ -548,19 +719,42 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
     void
     on_connect_timeout(asio_config::error_code const& ec);
 
+    //@{
+    /** @name Idle connection detection */
+    /**
+     * Schedule idle check in the shared timing wheel, if connection
+     * timeouts are enabled. Called once when the connection goes online.
+     */
+    void
+    start_idle_timer();
+    void
+    schedule_idle_check(timing_wheel::duration_type timeout);
     void
-    set_idle_timer();
+    on_idle_timeout();
+    /**
+     * Record the time of last I/O activity. Costs a single relaxed store.
+     */
     void
-    on_idle_timeout(asio_config::error_code const& ec);
+    mark_activity()
+    {
+        last_activity_.store(
+            timing_wheel::clock_type::now().time_since_epoch().count(),
+            ::std::memory_order_relaxed);
+    }
     bool
     can_drop_connection() const;
+    //@}
 
-    void
-    start_request_timer();
-    void
-    on_request_timeout(asio_config::error_code const& ec);
+    timing_wheel::timer_id
+    schedule_request_timeout(request_number r_no, invocation_options::timeout_type timeout);
     void
     request_error(request_number r_no, ::std::exception_ptr ex);
+    /**
+     * Fail the pending urgent requests, the peer's protocol version
+     * doesn't have the urgent flag
+     */
+    void
+    fail_urgent_requests(encoding::version const& peer);
 
     void
     connect_async(endpoint const&,
@@ -581,6 +775,17 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
         observer_.remove_observer(observer);
     }
 
+    /**
+     * Number of requests waiting for replies. Includes the requests that
+     * are not sent yet, waiting for the request window or for the
+     * connection to be established.
+     */
+    ::std::size_t
+    outstanding_requests() const
+    {
+        return pending_replies_.size();
+    }
+
     //@{
     /** @name Server-side session */
     /**
@@ -617,8 +822,39 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
     handle_write(asio_config::error_code const& ec, ::std::size_t bytes,
             functional::void_callback cb, encoding::outgoing_ptr);
 
+    //@{
+    /** @name Write lanes */
+    /**
+     * Queue a message while a write is in progress. If the connection is
+     * closed before the message is written the error callback is called
+     * instead of the sent callback.
+     */
+    void
+    queue_write(encoding::outgoing_ptr, functional::void_callback cb,
+            functional::exception_callback err = nullptr);
+    bool
+    has_queued_writes() const;
+    /**
+     * Write the next queued message, urgent ones first. If the transport
+     * can coalesce writes, all queued messages up to max_write_batch bytes
+     * are written in one operation.
+     */
+    void
+    write_next();
+    void
+    write_batch_async(write_batch&&);
+    //@}
+
     void
     start_read();
+    /**
+     * Start next read unless too many incoming requests are queued for
+     * dispatch or wait for responses. The limit is checked per buffer
+     * read, so it can be exceeded by the number of requests in a single
+     * buffer.
+     */
+    void
+    continue_read();
     void
     read_async(incoming_buffer_ptr);
     void
@@ -630,11 +866,34 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
     void
     process_message(encoding::message m,
             incoming_buffer::iterator& b, incoming_buffer::iterator e);
+    /**
+     * Urgent requests are dispatched immediately, normal requests are
+     * dispatched after the whole buffer is read
+     */
     void
     dispatch_incoming(encoding::incoming_ptr);
+    void
+    dispatch_normal_requests();
 
     void
     dispatch_reply(encoding::incoming_ptr);
+    /**
+     * Count the request against the dispatch limit and hand it to the
+     * adapter's dispatch executor, or post it to the io_service if the
+     * adapter has no executor. Urgent requests go to the executor's
+     * urgent lane.
+     */
+    void
+    schedule_request(encoding::incoming_ptr);
+    void
+    post_request(encoding::incoming_ptr);
+    /**
+     * State of an incoming request being dispatched. The request, its
+     * context, current and the dispatch callbacks share one allocation
+     * taken from a pool.
+     */
+    struct incoming_request;
+    using incoming_request_ptr = ::std::shared_ptr< incoming_request >;
     void
     dispatch_incoming_request(encoding::incoming_ptr);
 
@@ -688,6 +947,74 @@ struct connection_implementation : ::std::enable_shared_from_this<connection_imp
     void
     request_sent(request_number r_no, functional::callback< bool > sent, bool one_way);
 
+    //@{
+    /** @name Flow control */
+    /**
+     * Send the request if the request window allows, otherwise put it to
+     * the waiting queue. The request fails with request_overflow if the
+     * waiting queue is full.
+     */
+    void
+    queue_request(waiting_request&&);
+    /**
+     * Send a request that has acquired its credit
+     */
+    void
+    start_request(waiting_request&&);
+    /**
+     * Make the write callback of a request. The callback is built once,
+     * capturing the caller's sent callback only if there is one, so that
+     * it is not wrapped in another callback and fits the inline storage.
+     * @param req
+     * @param credited The request holds a credit in the request window
+     */
+    functional::void_callback
+    make_sent_callback(waiting_request const& req, bool credited);
+    /**
+     * Return credits to the request window and start waiting requests
+     */
+    void
+    release_credit(::std::size_t requests, ::std::size_t bytes);
+    /**
+     * Check if a request of the size fits into the request window,
+     * must be called with the flow mutex locked
+     */
+    bool
+    window_open(::std::size_t bytes) const;
+    /**
+     * Take the pending reply entry and return its credit
+     */
+    bool
+    take_pending(request_number r_no, pending_reply& p_rep);
+    /**
+     * Called when a response to an incoming request is sent or a one-way
+     * request is dispatched, resumes reading if it was paused
+     */
+    void
+    response_done();
+    //@}
+
+    /**
+     * Feed an event to the state machine. When built with
+     * WIRE_CONNECTION_STRAND the event is dispatched via the connection's
+     * strand, otherwise it is processed in the calling thread.
+     */
+    template < typename Event >
+    void
+    dispatch_event( Event&& event )
+    {
+        #ifdef WIRE_CONNECTION_STRAND
+        auto shared_this = shared_from_this();
+        strand_.dispatch(
+            [shared_this, evt = ::std::decay_t<Event>{ ::std::forward<Event>(event) }]() mutable
+            {
+                shared_this->process_event(::std::move(evt));
+            });
+        #else
+        process_event(::std::forward<Event>(event));
+        #endif
+    }
+
     template < typename Handler >
     void
     post( Handler&& handler )
@@ -757,6 +1084,19 @@ private:
     }
     virtual void
     do_write_async(encoding::outgoing_ptr, asio_config::asio_rw_callback) = 0;
+    /**
+     * @return true if the transport packs several messages into one write
+     */
+    virtual bool
+    coalesce_writes() const
+    {
+        return false;
+    }
+    virtual void
+    do_write_batch_async(outgoing_list const&, asio_config::asio_rw_callback)
+    {
+        throw ::std::logic_error("do_write_batch_async is not implemented");
+    }
     virtual void
     do_read_async(incoming_buffer_ptr, asio_config::asio_rw_callback) = 0;
 
@@ -765,18 +1105,39 @@ public:
     ::std::size_t const             number_;
 protected:
     using carry_buffer_type = ::std::vector<unsigned char>;
+    using incoming_list     = ::std::vector<encoding::incoming_ptr>;
     connector_weak_ptr              connector_;
     asio_config::io_service_ptr     io_service_;
+    asio_ns::io_service::strand     strand_;
     asio_config::system_timer       connection_timer_;
 
     atomic_counter                  request_no_;
-    asio_config::system_timer       request_timer_;
+    timing_wheel&                   timers_;
+    ::std::atomic<timing_wheel::timer_id>
+                                    idle_timer_;
+    ::std::atomic<timing_wheel::clock_type::rep>
+                                    last_activity_;
     pending_replies_type            pending_replies_;
-    pending_replies_expire_queue    expiration_queue_;
 
     encoding::incoming_ptr          incoming_;
     carry_buffer_type               carry_;
+    incoming_list                   normal_requests_;
     ::std::atomic<::std::int32_t>   outstanding_responses_;
+    ::std::atomic<bool>             read_paused_;
+    ::std::atomic<bool>             terminated_;
+    /** The peer understands the urgent flag, until its validate says otherwise */
+    ::std::atomic<bool>             peer_urgent_;
+
+    flow_limits const               limits_;
+    bool const                      optimistic_handshake_;
+    mutex_type                      flow_mtx_;
+    ::std::size_t                   requests_in_flight_;
+    ::std::size_t                   bytes_in_flight_;
+    waiting_queue                   waiting_;
+
+    write_queue                     urgent_writes_;
+    write_queue                     normal_writes_;
+
     functional::void_callback       on_close_;
 
     observer_container              observer_;
@@ -791,24 +1152,52 @@ struct is_secure : ::std::false_type {};
 template <>
 struct is_secure< ssl_transport > : ::std::true_type {};
 
+/**
+ * Transport requires a server-side start after accepting
+ */
+template < typename T >
+struct has_session_start : is_secure< T > {};
+/** Attach the accepted socket to the io_uring backend */
+template <>
+struct has_session_start< tcp_transport > : ::std::true_type {};
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+template <>
+struct has_session_start< socket_transport > : ::std::true_type {};
+#endif
+#ifdef WIRE_HAS_SHM_TRANSPORT
+template <>
+struct has_session_start< shm_transport > : ::std::true_type {};
+#endif
+
+struct no_write_aggregator {
+    template < typename Transport >
+    no_write_aggregator(Transport&) {}
+};
+
 template < transport_type _type >
 struct connection_impl : connection_implementation {
     using transport_traits    = transport_type_traits< _type >;
     using transport_type    = typename transport_traits::type;
     using socket_type        = typename transport_traits::listen_socket_type;
+    using writer_type       = typename ::std::conditional<
+            is_secure< transport_type >::value,
+            write_aggregator< transport_type >,
+            no_write_aggregator >::type;
 
     template < typename T = transport_type >
     connection_impl(client_side const& c, adapter_ptr adptr,
             functional::void_callback on_close,
             typename ::std::enable_if< !is_secure< T >::value, void >::type* = nullptr)
-        : connection_implementation{c, adptr, on_close}, transport_{ io_service_ }
+        : connection_implementation{c, adptr, on_close}, transport_{ io_service_ },
+          writer_{ transport_ }
     {
     }
     template < typename T = transport_type >
     connection_impl(server_side const& s, adapter_ptr adptr,
             functional::void_callback on_close,
             typename ::std::enable_if< !is_secure< T >::value, void >::type* = nullptr)
-        : connection_implementation{s, adptr, on_close}, transport_{ io_service_ }
+        : connection_implementation{s, adptr, on_close}, transport_{ io_service_ },
+          writer_{ transport_ }
     {
     }
     template < typename T = transport_type >
@@ -817,7 +1206,8 @@ struct connection_impl : connection_implementation {
             detail::adapter_options const& opts = {},
             typename ::std::enable_if< is_secure< T >::value, void >::type* = nullptr)
         : connection_implementation{c, adptr, on_close},
-          transport_{ io_service_, adptr->ssl_options() }
+          transport_{ io_service_, adptr->ssl_options() },
+          writer_{ transport_ }
     {
         // TODO Add verification handler for storing certificate chain
         DEBUG_LOG_TAG(3, tag, "create client-side secure connection")
@@ -828,7 +1218,8 @@ struct connection_impl : connection_implementation {
             detail::adapter_options const& opts = {},
             typename ::std::enable_if< is_secure< T >::value, void >::type* = nullptr)
         : connection_implementation{s, adptr, on_close},
-          transport_{ io_service_, adptr->ssl_options() }
+          transport_{ io_service_, adptr->ssl_options() },
+          writer_{ transport_ }
     {
         // TODO Add verification handler for storing certificate chain
         DEBUG_LOG_TAG(3, tag, "create server-side secure connection")
@@ -896,13 +1287,13 @@ private:
     }
 
     template < typename T = transport_type >
-    typename ::std::enable_if<is_secure< T >::value, void>::type
+    typename ::std::enable_if<has_session_start< T >::value, void>::type
     do_start_session_impl(asio_config::asio_callback cb)
     {
         transport_.start(cb);
     }
     template < typename T = transport_type >
-    typename ::std::enable_if<!is_secure< T >::value, void>::type
+    typename ::std::enable_if<!has_session_start< T >::value, void>::type
     do_start_session_impl(asio_config::asio_callback cb)
     {
         if (cb) cb(asio_config::error_code{});
@@ -914,6 +1305,50 @@ private:
     }
     void
     do_write_async(encoding::outgoing_ptr buffer, asio_config::asio_rw_callback cb) override
+    {
+        do_write_async_impl(buffer, cb);
+    }
+    template < typename T = transport_type >
+    typename ::std::enable_if<is_secure< T >::value, void>::type
+    do_write_async_impl(encoding::outgoing_ptr buffer, asio_config::asio_rw_callback cb)
+    {
+        // Pack the message into record-sized chunks
+        writer_.write(*buffer->to_buffers(), cb, shared_from_this());
+    }
+    bool
+    coalesce_writes() const override
+    {
+        return is_secure< transport_type >::value;
+    }
+    void
+    do_write_batch_async(outgoing_list const& batch, asio_config::asio_rw_callback cb) override
+    {
+        do_write_batch_impl(batch, cb);
+    }
+    template < typename T = transport_type >
+    typename ::std::enable_if<is_secure< T >::value, void>::type
+    do_write_batch_impl(outgoing_list const& batch, asio_config::asio_rw_callback cb)
+    {
+        // Consecutive messages share records
+        for (auto const& out : batch) {
+            writer_.append(*out->to_buffers());
+        }
+        writer_.flush(cb, shared_from_this());
+    }
+    template < typename T = transport_type >
+    typename ::std::enable_if<!is_secure< T >::value, void>::type
+    do_write_batch_impl(outgoing_list const&, asio_config::asio_rw_callback)
+    {
+        throw ::std::logic_error("Transport doesn't coalesce writes");
+    }
+    template < typename T = transport_type >
+    typename ::std::enable_if<!is_secure< T >::value, void>::type
+    do_write_async_impl(encoding::outgoing_ptr buffer, asio_config::asio_rw_callback cb)
+    {
+        write_buffers(buffer, cb);
+    }
+    void
+    write_buffers(encoding::outgoing_ptr buffer, asio_config::asio_rw_callback cb)
     {
         auto buff = buffer->to_buffers();
         transport_.async_write( *buff,
@@ -931,6 +1366,7 @@ private:
     optional_endpoint mutable   local_endpoint_;
 
     transport_type  transport_;
+    writer_type     writer_;
 };
 
 template < transport_type _type >
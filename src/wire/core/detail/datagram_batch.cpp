@@ -0,0 +1,131 @@
+/*
+ * datagram_batch.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/datagram_batch.hpp>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+constexpr ::std::size_t datagram_batch::default_batch_size;
+constexpr ::std::size_t datagram_batch::default_datagram_size;
+
+namespace {
+
+bool
+would_block(int err)
+{
+    return err == EAGAIN || err == EWOULDBLOCK;
+}
+
+}  /* namespace  */
+
+datagram_batch::datagram_batch(::std::size_t batch_size, ::std::size_t datagram_size)
+    : datagram_size_{datagram_size},
+      storage_(batch_size * datagram_size),
+      sizes_(batch_size, 0),
+      senders_(batch_size),
+      truncated_(batch_size, false)
+#ifdef __linux__
+      , headers_(batch_size), iovecs_(batch_size)
+#endif
+{
+}
+
+::std::size_t
+datagram_batch::receive(asio_config::udp::socket& socket, asio_config::error_code& ec)
+{
+    ec = asio_config::error_code{};
+    count_ = 0;
+#ifdef __linux__
+    for (::std::size_t i = 0; i < capacity(); ++i) {
+        iovecs_[i].iov_base = &storage_[i * datagram_size_];
+        iovecs_[i].iov_len  = datagram_size_;
+        auto& hdr = headers_[i].msg_hdr;
+        hdr = ::msghdr{};
+        hdr.msg_iov         = &iovecs_[i];
+        hdr.msg_iovlen      = 1;
+        hdr.msg_name        = senders_[i].data();
+        hdr.msg_namelen     = senders_[i].capacity();
+        headers_[i].msg_len = 0;
+    }
+    int res = ::recvmmsg(socket.native_handle(), headers_.data(), capacity(),
+            MSG_DONTWAIT, nullptr);
+    if (res < 0) {
+        if (!would_block(errno))
+            ec = asio_config::error_code{ errno, ::boost::system::system_category() };
+        return 0;
+    }
+    for (int i = 0; i < res; ++i) {
+        sizes_[i]       = headers_[i].msg_len;
+        truncated_[i]   = headers_[i].msg_hdr.msg_flags & MSG_TRUNC;
+        senders_[i].resize(headers_[i].msg_hdr.msg_namelen);
+    }
+    count_ = res;
+#else
+    socket.non_blocking(true, ec);
+    while (!ec && count_ < capacity()) {
+        auto sz = socket.receive_from(
+                asio_ns::buffer(&storage_[count_ * datagram_size_], datagram_size_),
+                senders_[count_], 0, ec);
+        if (!ec) {
+            sizes_[count_]      = sz;
+            truncated_[count_]  = false;
+            ++count_;
+        }
+    }
+    if (ec == asio_config::error::would_block)
+        ec = asio_config::error_code{};
+#endif
+    return count_;
+}
+
+::std::size_t
+datagram_batch::send(asio_config::udp::socket& socket,
+        datagram_list::const_iterator first, datagram_list::const_iterator last,
+        asio_config::error_code& ec)
+{
+    ec = asio_config::error_code{};
+#ifdef __linux__
+    static constexpr ::std::size_t max_send = 64;
+    ::std::size_t n = ::std::min< ::std::size_t >(last - first, max_send);
+    ::mmsghdr headers[max_send] = {};
+    ::iovec iovecs[max_send];
+    for (::std::size_t i = 0; i < n; ++i, ++first) {
+        iovecs[i].iov_base = const_cast<void*>(
+                asio_ns::buffer_cast< void const* >(*first));
+        iovecs[i].iov_len  = asio_ns::buffer_size(*first);
+        headers[i].msg_hdr.msg_iov    = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    int res = ::sendmmsg(socket.native_handle(), headers, n, MSG_DONTWAIT);
+    if (res < 0) {
+        if (!would_block(errno))
+            ec = asio_config::error_code{ errno, ::boost::system::system_category() };
+        return 0;
+    }
+    return res;
+#else
+    ::std::size_t sent = 0;
+    socket.non_blocking(true, ec);
+    for (; !ec && first != last; ++first) {
+        socket.send(asio_ns::buffer(*first), 0, ec);
+        if (!ec)
+            ++sent;
+    }
+    if (ec == asio_config::error::would_block)
+        ec = asio_config::error_code{};
+    return sent;
+#endif
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
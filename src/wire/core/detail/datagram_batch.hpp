@@ -0,0 +1,116 @@
+/*
+ * datagram_batch.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_DATAGRAM_BATCH_HPP_
+#define WIRE_CORE_DETAIL_DATAGRAM_BATCH_HPP_
+
+#include <wire/asio_config.hpp>
+
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * List of datagrams to send, one wire message per datagram
+ */
+using datagram_list = ::std::vector< asio_ns::const_buffer >;
+
+/**
+ * Receive buffers for a batch of datagrams.
+ *
+ * Every datagram gets a separate fixed-size slot, so one datagram carries
+ * exactly one wire message and there is no carry over between reads.
+ * On Linux the whole batch is received with a single recvmmsg call.
+ */
+class datagram_batch {
+public:
+    using endpoint_type     = asio_config::udp::endpoint;
+
+    static constexpr ::std::size_t default_batch_size      = 32;
+    static constexpr ::std::size_t default_datagram_size   = asio_config::incoming_buffer_size;
+public:
+    explicit
+    datagram_batch(::std::size_t batch_size = default_batch_size,
+            ::std::size_t datagram_size = default_datagram_size);
+
+    datagram_batch(datagram_batch const&) = delete;
+    datagram_batch&
+    operator = (datagram_batch const&) = delete;
+
+    /**
+     * Maximum number of datagrams received at once
+     */
+    ::std::size_t
+    capacity() const
+    { return senders_.size(); }
+    ::std::size_t
+    datagram_size() const
+    { return datagram_size_; }
+    /**
+     * Number of datagrams received by the last operation
+     */
+    ::std::size_t
+    size() const
+    { return count_; }
+    bool
+    empty() const
+    { return count_ == 0; }
+
+    asio_ns::const_buffer
+    operator[](::std::size_t i) const
+    { return asio_ns::buffer(&storage_[i * datagram_size_], sizes_[i]); }
+    endpoint_type const&
+    sender(::std::size_t i) const
+    { return senders_[i]; }
+    /**
+     * Datagram was larger than the slot and was cut
+     */
+    bool
+    truncated(::std::size_t i) const
+    { return truncated_[i]; }
+
+    /**
+     * Receive available datagrams from a non-blocking socket.
+     * @return Number of datagrams received, 0 if none are available
+     */
+    ::std::size_t
+    receive(asio_config::udp::socket& socket, asio_config::error_code& ec);
+
+    /**
+     * Send datagrams starting from the first one via a non-blocking
+     * connected socket, on Linux using a single sendmmsg call.
+     * @return Number of datagrams sent, less than requested if the socket
+     *      buffer is full.
+     */
+    static ::std::size_t
+    send(asio_config::udp::socket& socket,
+            datagram_list::const_iterator first, datagram_list::const_iterator last,
+            asio_config::error_code& ec);
+private:
+    ::std::size_t const                 datagram_size_;
+    ::std::vector< unsigned char >      storage_;
+    ::std::vector< ::std::size_t >      sizes_;
+    ::std::vector< endpoint_type >      senders_;
+    ::std::vector< bool >               truncated_;
+    ::std::size_t                       count_ = 0;
+#ifdef __linux__
+    ::std::vector< ::mmsghdr >          headers_;
+    ::std::vector< ::iovec >            iovecs_;
+#endif
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_DATAGRAM_BATCH_HPP_ */
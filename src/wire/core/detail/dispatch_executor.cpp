@@ -0,0 +1,345 @@
+/*
+ * dispatch_executor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/dispatch_executor.hpp>
+#include <wire/errors/exceptions.hpp>
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#include <tbb/concurrent_queue.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+constexpr ::std::size_t dispatch_executor::queue_count;
+constexpr ::std::size_t dispatch_executor::queue_batch;
+
+namespace {
+
+/**
+ * Plain thread pool for executors with more threads than the TBB
+ * scheduler has workers. An arena cannot have more workers than the
+ * scheduler allows, and raising the limit affects the whole process.
+ */
+class worker_threads {
+public:
+    using task_type     = ::std::function< void() >;
+
+    worker_threads(::std::size_t threads)
+        : state_{ ::std::make_shared< state >() }
+    {
+        for (::std::size_t i = 0; i < threads; ++i) {
+            auto st = state_;
+            workers_.emplace_back([st](){ st->run(); });
+        }
+    }
+    ~worker_threads()
+    {
+        {
+            lock_guard lock{state_->mtx};
+            state_->stop = true;
+        }
+        state_->cv.notify_all();
+        for (auto& t : workers_) {
+            // The last task can destroy the pool from a worker
+            if (t.get_id() == ::std::this_thread::get_id()) {
+                t.detach();
+            } else {
+                t.join();
+            }
+        }
+    }
+
+    void
+    enqueue(task_type&& task)
+    {
+        {
+            lock_guard lock{state_->mtx};
+            state_->tasks.push_back(::std::move(task));
+        }
+        state_->cv.notify_one();
+    }
+private:
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+    using unique_lock   = ::std::unique_lock<mutex_type>;
+
+    /** Shared with the workers, so that a detached worker can finish */
+    struct state {
+        mutex_type                  mtx;
+        ::std::condition_variable   cv;
+        ::std::deque< task_type >   tasks;
+        bool                        stop = false;
+
+        void
+        run()
+        {
+            while (true) {
+                task_type task;
+                {
+                    unique_lock lock{mtx};
+                    cv.wait(lock, [this](){ return stop || !tasks.empty(); });
+                    if (tasks.empty())
+                        return;
+                    task = ::std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+    };
+    using state_ptr     = ::std::shared_ptr< state >;
+
+    state_ptr                       state_;
+    ::std::vector< ::std::thread >  workers_;
+};
+
+/**
+ * Number of worker threads the TBB scheduler allows, the thread that
+ * initialises the scheduler is counted in the allowed parallelism.
+ */
+::std::size_t
+tbb_worker_limit()
+{
+    auto parallelism = ::tbb::global_control::active_value(
+            ::tbb::global_control::max_allowed_parallelism);
+    return parallelism > 1 ? parallelism - 1 : 0;
+}
+
+}  /* namespace  */
+
+struct dispatch_executor::impl : ::std::enable_shared_from_this<impl> {
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+    using unique_lock   = ::std::unique_lock<mutex_type>;
+
+    struct serial_queue {
+        mutex_type                  mtx;
+        ::std::deque< task_type >   tasks;
+        bool                        running = false;
+    };
+    using serial_queues = ::std::unique_ptr< serial_queue[] >;
+
+    /** Executor running a task in the current thread */
+    static thread_local impl const* current;
+
+    ::std::size_t const             threads_;
+    dispatch_ordering const         order_;
+    // The arena is used when the scheduler has workers for all the
+    // threads, no slots are reserved for external threads, all the threads
+    // are workers. Otherwise the executor runs its own threads.
+    ::std::unique_ptr< ::tbb::task_arena >  arena_;
+    ::std::unique_ptr< worker_threads >     workers_;
+    serial_queues                   queues_;
+    ::tbb::concurrent_queue< task_type >    urgent_;
+
+    mutex_type                      mtx_;
+    ::std::condition_variable       done_;
+    ::std::size_t                   pending_;
+
+    impl(::std::size_t threads, dispatch_ordering order)
+        : threads_{threads}, order_{order},
+          queues_{ new serial_queue[queue_count] },
+          pending_{0}
+    {
+        if (threads <= tbb_worker_limit()) {
+            arena_.reset(new ::tbb::task_arena{ static_cast<int>(threads), 0 });
+        } else {
+            workers_.reset(new worker_threads{ threads });
+        }
+    }
+
+    template < typename Func >
+    void
+    spawn(Func&& func)
+    {
+        if (arena_) {
+            arena_->enqueue(::std::forward<Func>(func));
+        } else {
+            workers_->enqueue(::std::forward<Func>(func));
+        }
+    }
+
+    void
+    enqueue(task_type&& task)
+    {
+        {
+            lock_guard lock{mtx_};
+            ++pending_;
+        }
+        auto _this = shared_from_this();
+        spawn(
+            [_this, task]()
+            {
+                _this->run_urgent();
+                _this->run(task);
+            });
+    }
+
+    void
+    post_urgent(task_type&& task)
+    {
+        {
+            lock_guard lock{mtx_};
+            // The task and the runner, the executor waits for the runner
+            // too, as it holds the implementation
+            pending_ += 2;
+        }
+        urgent_.push(::std::move(task));
+        // Runs the urgent lane if no worker gets to it earlier
+        auto _this = shared_from_this();
+        spawn(
+            [_this]()
+            {
+                _this->run_urgent();
+                _this->finish();
+            });
+    }
+
+    void
+    run_urgent()
+    {
+        task_type task;
+        while (urgent_.try_pop(task)) {
+            run(task);
+        }
+    }
+
+    void
+    run(task_type const& task)
+    {
+        auto prev = current;
+        current = this;
+        try {
+            task();
+        } catch (...) {
+            // Tasks report their errors themselves
+        }
+        current = prev;
+        finish();
+    }
+
+    void
+    finish()
+    {
+        lock_guard lock{mtx_};
+        if (--pending_ == 0)
+            done_.notify_all();
+    }
+
+    void
+    post(key_type key, task_type&& task)
+    {
+        serial_queue& q = queues_[key % queue_count];
+        {
+            lock_guard lock{q.mtx};
+            q.tasks.push_back(::std::move(task));
+            if (q.running)
+                return;
+            q.running = true;
+        }
+        enqueue([this, &q](){ drain(q); });
+    }
+
+    void
+    drain(serial_queue& q)
+    {
+        for (::std::size_t n = 0; n < queue_batch; ++n) {
+            task_type task;
+            {
+                lock_guard lock{q.mtx};
+                if (q.tasks.empty()) {
+                    q.running = false;
+                    return;
+                }
+                task = ::std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            run_urgent();
+            try {
+                task();
+            } catch (...) {}
+        }
+        // Let other tasks run, continue the queue later
+        enqueue([this, &q](){ drain(q); });
+    }
+
+    void
+    wait()
+    {
+        if (current == this) {
+            throw errors::logic_error("Cannot wait for dispatch executor from its task");
+        }
+        unique_lock lock{mtx_};
+        done_.wait(lock, [this](){ return pending_ == 0; });
+    }
+};
+
+thread_local dispatch_executor::impl const* dispatch_executor::impl::current = nullptr;
+
+dispatch_executor::dispatch_executor(::std::size_t threads, dispatch_ordering order)
+{
+    if (threads == 0) {
+        throw errors::logic_error("Dispatch executor requires at least one thread");
+    }
+    pimpl_ = ::std::make_shared<impl>(threads, order);
+}
+
+dispatch_executor::~dispatch_executor()
+{
+    // The tasks hold the implementation, so if the executor is destroyed
+    // from a task the rest of the tasks still can run
+    if (impl::current != pimpl_.get())
+        pimpl_->wait();
+}
+
+dispatch_ordering
+dispatch_executor::ordering() const
+{
+    return pimpl_->order_;
+}
+
+::std::size_t
+dispatch_executor::threads() const
+{
+    return pimpl_->threads_;
+}
+
+void
+dispatch_executor::post(task_type&& task)
+{
+    pimpl_->enqueue(::std::move(task));
+}
+
+void
+dispatch_executor::post(key_type key, task_type&& task)
+{
+    pimpl_->post(key, ::std::move(task));
+}
+
+void
+dispatch_executor::post_urgent(task_type&& task)
+{
+    pimpl_->post_urgent(::std::move(task));
+}
+
+void
+dispatch_executor::wait()
+{
+    pimpl_->wait();
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
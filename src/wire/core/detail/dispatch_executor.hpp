@@ -0,0 +1,91 @@
+/*
+ * dispatch_executor.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_DISPATCH_EXECUTOR_HPP_
+#define WIRE_CORE_DETAIL_DISPATCH_EXECUTOR_HPP_
+
+#include <wire/core/detail/dispatch_executor_fwd.hpp>
+#include <wire/core/functional.hpp>
+
+#include <memory>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Thread pool dispatching incoming requests outside of the I/O threads.
+ *
+ * Tasks run in a TBB task arena with the configured number of worker
+ * threads, idle workers steal tasks from busy ones. If more threads are
+ * configured than the TBB scheduler has workers (e.g. for servants that
+ * block), the executor runs its own thread pool instead, as the arena's
+ * concurrency is bounded by the scheduler's process-wide limit. Tasks
+ * posted with a key run in the order they were posted relative to other
+ * tasks with the same key. Keys are mapped to a fixed set of serial queues, so
+ * tasks with different keys can occasionally be serialized as well.
+ *
+ * Urgent tasks are kept in a separate lane, a worker runs the urgent tasks
+ * before picking the next task from the queue, so they don't wait for the
+ * backlog of normal tasks.
+ *
+ * The destructor waits for the posted tasks to complete, unless it is
+ * called from a task of the executor.
+ */
+class dispatch_executor {
+public:
+    using task_type     = functional::void_callback;
+    using key_type      = ::std::size_t;
+
+    static constexpr ::std::size_t queue_count  = 256;
+    /** Number of tasks a serial queue runs before yielding the thread */
+    static constexpr ::std::size_t queue_batch  = 16;
+public:
+    dispatch_executor(::std::size_t threads, dispatch_ordering order);
+    ~dispatch_executor();
+
+    dispatch_executor(dispatch_executor const&) = delete;
+    dispatch_executor&
+    operator = (dispatch_executor const&) = delete;
+
+    dispatch_ordering
+    ordering() const;
+    ::std::size_t
+    threads() const;
+
+    /**
+     * Run the task without any ordering guarantees
+     */
+    void
+    post(task_type&&);
+    /**
+     * Run the task after the tasks posted earlier with the same key
+     */
+    void
+    post(key_type key, task_type&&);
+    /**
+     * Run the task before the normal tasks waiting in the executor.
+     * Urgent tasks are not ordered with the keyed tasks.
+     */
+    void
+    post_urgent(task_type&&);
+    /**
+     * Wait until all posted tasks are completed
+     */
+    void
+    wait();
+private:
+    struct impl;
+    using pimpl = ::std::shared_ptr<impl>;
+    pimpl pimpl_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_DISPATCH_EXECUTOR_HPP_ */
@@ -12,27 +12,60 @@
 #include <wire/core/connection_observer.hpp>
 
 #include <boost/thread/shared_mutex.hpp>
+#include <tbb/concurrent_queue.h>
 
+#include <atomic>
 
 namespace wire {
 namespace core {
 namespace detail {
 
+/**
+ * Connection observer that forwards events to a set of observers.
+ *
+ * By default every event is posted to the io_service separately for
+ * each observer. In batched mode events are put to a lock-free queue and
+ * are delivered by a single handler that drains the queue, byte counts are
+ * accumulated between deliveries and reported as a single event.
+ *
+ * When the library is built with WIRE_NO_CONNECTION_OBSERVERS has_observers()
+ * is always false. Call sites check it before calling the event functions,
+ * so that the event arguments are not evaluated at all.
+ */
 struct observer_container : connection_observer {
     using mutex_type        = ::boost::shared_mutex;
     using shared_lock       = ::boost::shared_lock<mutex_type>;
     using exclusive_lock    = ::std::lock_guard<mutex_type>;
 
-    observer_container(asio_config::io_service_ptr io_svc)
-        : io_svc_{io_svc} {}
+    observer_container(asio_config::io_service_ptr io_svc, bool batch = false)
+        : io_svc_{io_svc}, count_{0},
+          batch_{ batch ? ::std::make_shared<batch_state>() : nullptr } {}
     observer_container(asio_config::io_service_ptr io_svc,
-            connection_observer_set&& observers)
-        : io_svc_{io_svc}, observers_{::std::move(observers)} {}
+            connection_observer_set&& observers, bool batch = false)
+        : io_svc_{io_svc}, observers_{::std::move(observers)},
+          count_{ observers_.size() },
+          batch_{ batch ? ::std::make_shared<batch_state>() : nullptr } {}
     virtual ~observer_container() {}
 
+    bool
+    has_observers() const
+    {
+        #ifdef WIRE_NO_CONNECTION_OBSERVERS
+        return false;
+        #else
+        return count_.load(::std::memory_order_relaxed) > 0;
+        #endif
+    }
+
     void
     send_bytes(::std::size_t bytes, endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            add_bytes(batch_->sent, observer_event::send_bytes, bytes, ep);
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -48,6 +81,12 @@ struct observer_container : connection_observer {
     void
     receive_bytes(::std::size_t bytes, endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            add_bytes(batch_->received, observer_event::receive_bytes, bytes, ep);
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -65,6 +104,12 @@ struct observer_container : connection_observer {
             invocation_target const& id, operation_id const& op,
             endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::invoke_remote, req_no, id, op, ep });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -81,6 +126,13 @@ struct observer_container : connection_observer {
             invocation_target const& id, operation_id const& op,
             endpoint const& ep, duration_type et) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::invocation_ok, req_no, id, op, ep,
+                false, nullptr, et });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -98,6 +150,13 @@ struct observer_container : connection_observer {
             endpoint const& ep, bool sent,
             ::std::exception_ptr ex, duration_type et) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::invocation_error, req_no, id, op, ep,
+                sent, ex, et });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -115,6 +174,12 @@ struct observer_container : connection_observer {
             invocation_target const& id, operation_id const& op,
             endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::receive_request, req_no, id, op, ep });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -132,6 +197,13 @@ struct observer_container : connection_observer {
             endpoint const& ep,
             duration_type et) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::request_ok, req_no, id, op, ep,
+                false, nullptr, et });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -149,6 +221,13 @@ struct observer_container : connection_observer {
             endpoint const& ep, ::std::exception_ptr ex,
             duration_type et) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::request_error, req_no, id, op, ep,
+                false, ex, et });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -165,6 +244,13 @@ struct observer_container : connection_observer {
             invocation_target const& id, operation_id const& op,
             endpoint const& ep, duration_type et) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::request_no_response, req_no, id, op, ep,
+                false, nullptr, et });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -181,6 +267,12 @@ struct observer_container : connection_observer {
             invocation_target const& id, operation_id const& op,
             endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::request_double_response, req_no, id, op, ep });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -196,6 +288,12 @@ struct observer_container : connection_observer {
     void
     connect(endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::connect, 0, {}, {}, ep });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -210,6 +308,13 @@ struct observer_container : connection_observer {
     void
     connection_failure(endpoint const& ep, ::std::exception_ptr ex) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::connection_failure, 0, {}, {}, ep,
+                false, ex });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -224,6 +329,12 @@ struct observer_container : connection_observer {
     void
     disconnect(endpoint const& ep) const noexcept override
     {
+        if (!has_observers())
+            return;
+        if (batch_) {
+            enqueue({ observer_event::disconnect, 0, {}, {}, ep });
+            return;
+        }
         shared_lock lock{mutex_};
         endpoint ep_cp{ep};
         for (auto o : observers_) {
@@ -241,6 +352,7 @@ struct observer_container : connection_observer {
     {
         exclusive_lock lock{mutex_};
         observers_.insert(observer);
+        count_ = observers_.size();
     }
 
     void
@@ -248,11 +360,164 @@ struct observer_container : connection_observer {
     {
         exclusive_lock lock{mutex_};
         observers_.erase(observer);
+        count_ = observers_.size();
     }
 private:
+    struct observer_event {
+        enum event_type {
+            send_bytes,
+            receive_bytes,
+            invoke_remote,
+            invocation_ok,
+            invocation_error,
+            receive_request,
+            request_ok,
+            request_error,
+            request_no_response,
+            request_double_response,
+            connect,
+            connection_failure,
+            disconnect
+        };
+        event_type              type;
+        request_number          req_no;
+        invocation_target       id;
+        operation_id            op;
+        endpoint                ep;
+        bool                    sent        = false;
+        ::std::exception_ptr    ex          = nullptr;
+        duration_type           et          = duration_type{};
+        ::std::size_t           bytes       = 0;
+
+        void
+        deliver(connection_observer const& o) const noexcept
+        {
+            switch (type) {
+                case send_bytes:
+                    o.send_bytes(bytes, ep);
+                    break;
+                case receive_bytes:
+                    o.receive_bytes(bytes, ep);
+                    break;
+                case invoke_remote:
+                    o.invoke_remote(req_no, id, op, ep);
+                    break;
+                case invocation_ok:
+                    o.invocation_ok(req_no, id, op, ep, et);
+                    break;
+                case invocation_error:
+                    o.invocation_error(req_no, id, op, ep, sent, ex, et);
+                    break;
+                case receive_request:
+                    o.receive_request(req_no, id, op, ep);
+                    break;
+                case request_ok:
+                    o.request_ok(req_no, id, op, ep, et);
+                    break;
+                case request_error:
+                    o.request_error(req_no, id, op, ep, ex, et);
+                    break;
+                case request_no_response:
+                    o.request_no_response(req_no, id, op, ep, et);
+                    break;
+                case request_double_response:
+                    o.request_double_response(req_no, id, op, ep);
+                    break;
+                case connect:
+                    o.connect(ep);
+                    break;
+                case connection_failure:
+                    o.connection_failure(ep, ex);
+                    break;
+                case disconnect:
+                    o.disconnect(ep);
+                    break;
+            }
+        }
+    };
+    using event_queue = ::tbb::concurrent_queue<observer_event>;
+    /**
+     * State shared with the drain handler, outlives the container if
+     * the connection is destroyed before the handler runs.
+     */
+    struct batch_state {
+        event_queue                     events;
+        ::std::atomic<::std::size_t>    sent{0};
+        ::std::atomic<::std::size_t>    received{0};
+        ::std::atomic_flag              scheduled = ATOMIC_FLAG_INIT;
+    };
+    using batch_state_ptr = ::std::shared_ptr<batch_state>;
+
+    void
+    enqueue(observer_event&& evt) const noexcept
+    {
+        batch_->events.push(::std::move(evt));
+        schedule_drain();
+    }
+
+    void
+    add_bytes(::std::atomic<::std::size_t>& counter, observer_event::event_type type,
+            ::std::size_t bytes, endpoint const& ep) const noexcept
+    {
+        if (bytes == 0)
+            return;
+        // Only the first report since the last delivery enqueues an event,
+        // the rest just add to the counter
+        if (counter.fetch_add(bytes, ::std::memory_order_relaxed) == 0) {
+            enqueue({ type, 0, {}, {}, ep });
+        }
+    }
+
+    void
+    schedule_drain() const noexcept
+    {
+        if (!batch_->scheduled.test_and_set(::std::memory_order_acq_rel)) {
+            auto state = batch_;
+            // Copy observers once per batch instead of once per event
+            connection_observer_set observers;
+            {
+                shared_lock lock{mutex_};
+                observers = observers_;
+            }
+            io_svc_->post(
+                [state, observers]()
+                {
+                    drain(*state, observers);
+                });
+        }
+    }
+
+    static void
+    drain(batch_state& state, connection_observer_set const& observers) noexcept
+    {
+        // The flag stays set while the queue is being drained, so that
+        // only one drain handler runs at a time and events are delivered
+        // in order.
+        observer_event evt;
+        do {
+            while (state.events.try_pop(evt)) {
+                if (evt.type == observer_event::send_bytes) {
+                    evt.bytes = state.sent.exchange(0, ::std::memory_order_relaxed);
+                } else if (evt.type == observer_event::receive_bytes) {
+                    evt.bytes = state.received.exchange(0, ::std::memory_order_relaxed);
+                }
+                for (auto const& o : observers) {
+                    evt.deliver(*o);
+                }
+            }
+            state.scheduled.clear(::std::memory_order_seq_cst);
+            // An event pushed after the last pop could have seen the flag
+            // still set and skipped scheduling, pick it up here unless
+            // another drain has been scheduled already.
+        } while (!state.events.empty()
+                && !state.scheduled.test_and_set(::std::memory_order_acq_rel));
+    }
+
     mutex_type mutable              mutex_;
     asio_config::io_service_ptr     io_svc_;
     connection_observer_set         observers_;
+    ::std::atomic<::std::size_t>    count_;
+    batch_state_ptr                 batch_;
 };
 
 
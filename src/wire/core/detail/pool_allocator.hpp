@@ -0,0 +1,300 @@
+/*
+ * pool_allocator.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_POOL_ALLOCATOR_HPP_
+#define WIRE_CORE_DETAIL_POOL_ALLOCATOR_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Free lists of fixed size memory blocks.
+ *
+ * Each thread keeps its own list. Every block remembers the thread pool it
+ * was allocated from, a block released in the owning thread goes to the
+ * owner's list, a block released in another thread is pushed to the
+ * owner's lock-free return list. The owner takes the returned blocks back
+ * when its own list runs empty. So when requests are dispatched in
+ * executor threads (adapter's dispatch.threads > 0) the blocks allocated
+ * in an I/O thread come back to the I/O thread.
+ *
+ * Lists are bounded, the blocks over the limit are returned to the heap.
+ * When a thread exits its free blocks are released, the blocks still in
+ * use are released to the heap by the threads that free them. Blocks
+ * allocated after the thread's pool was destroyed (e.g. from other thread
+ * local destructors) bypass the pool.
+ */
+template < ::std::size_t BlockSize >
+class block_pool {
+public:
+    static constexpr ::std::size_t block_size   = BlockSize;
+    static constexpr ::std::size_t max_free     = 1024;
+
+    static void*
+    allocate()
+    {
+        thread_pool* pool = get_pool();
+        if (pool) {
+            if (block* b = pool->take()) {
+                return b + 1;
+            }
+            pool->add_ref();
+        }
+        block* b = static_cast<block*>(::operator new(header_size + block_size));
+        b->owner = pool;
+        return b + 1;
+    }
+
+    static void
+    deallocate(void* p) noexcept
+    {
+        block* b = static_cast<block*>(p) - 1;
+        thread_pool* owner = b->owner;
+        if (!owner) {
+            ::operator delete(b);
+        } else if (owner == current_pool()) {
+            owner->put(b);
+        } else {
+            owner->put_remote(b);
+        }
+    }
+
+    /**
+     * Number of free blocks in the current thread's list, not counting
+     * the blocks returned by other threads and not taken back yet
+     */
+    static ::std::size_t
+    free_blocks()
+    {
+        thread_pool* pool = current_pool();
+        return pool ? pool->size : 0;
+    }
+private:
+    struct thread_pool;
+    /**
+     * Block header, the memory handed out follows it
+     */
+    struct alignas(::std::max_align_t) block {
+        thread_pool*    owner;
+        block*          next;
+    };
+    static constexpr ::std::size_t header_size = sizeof(block);
+
+    /**
+     * Pool of a thread. Reference counted by the owning thread and by the
+     * blocks allocated from it, so that a block can be released after
+     * the owning thread has exited.
+     */
+    struct thread_pool {
+        block*                      head = nullptr;
+        ::std::size_t               size = 0;
+        ::std::atomic< block* >     returned{nullptr};
+        ::std::atomic< bool >       orphaned{false};
+        ::std::atomic< ::std::size_t > refs{1};
+
+        block*
+        take()
+        {
+            if (!head && returned.load(::std::memory_order_relaxed)) {
+                block* b = returned.exchange(nullptr);
+                while (b) {
+                    block* next = b->next;
+                    put(b);
+                    b = next;
+                }
+            }
+            block* b = head;
+            if (b) {
+                head = b->next;
+                --size;
+            }
+            return b;
+        }
+
+        void
+        put(block* b) noexcept
+        {
+            if (size < max_free) {
+                b->next = head;
+                head = b;
+                ++size;
+            } else {
+                ::operator delete(b);
+                release(1);
+            }
+        }
+
+        /**
+         * Return a block from a thread other than the owner
+         */
+        void
+        put_remote(block* b) noexcept
+        {
+            // Keep the pool while checking if the owner is gone
+            add_ref();
+            block* h = returned.load(::std::memory_order_relaxed);
+            do {
+                b->next = h;
+            } while (!returned.compare_exchange_weak(h, b));
+            ::std::size_t n = 0;
+            if (orphaned.load()) {
+                n = delete_blocks(returned.exchange(nullptr));
+            }
+            release(n + 1);
+        }
+
+        /**
+         * Called when the owning thread exits
+         */
+        void
+        orphan() noexcept
+        {
+            orphaned.store(true);
+            ::std::size_t n = delete_blocks(head)
+                    + delete_blocks(returned.exchange(nullptr));
+            head = nullptr;
+            size = 0;
+            release(n + 1);
+        }
+
+        void
+        add_ref() noexcept
+        {
+            refs.fetch_add(1, ::std::memory_order_relaxed);
+        }
+
+        void
+        release(::std::size_t n) noexcept
+        {
+            if (refs.fetch_sub(n, ::std::memory_order_acq_rel) == n)
+                delete this;
+        }
+
+        static ::std::size_t
+        delete_blocks(block* b) noexcept
+        {
+            ::std::size_t n = 0;
+            while (b) {
+                block* next = b->next;
+                ::operator delete(b);
+                b = next;
+                ++n;
+            }
+            return n;
+        }
+    };
+
+    /**
+     * Trivially destructible, so it can be read after the thread's
+     * destructors have run
+     */
+    struct thread_state {
+        thread_pool*    pool;
+        bool            destroyed;
+    };
+
+    /**
+     * Orphans the thread's pool on thread exit
+     */
+    struct pool_guard {
+        ~pool_guard()
+        {
+            thread_state& st = get_state();
+            st.destroyed = true;
+            if (st.pool) {
+                st.pool->orphan();
+                st.pool = nullptr;
+            }
+        }
+    };
+
+    static thread_state&
+    get_state()
+    {
+        static thread_local thread_state st{ nullptr, false };
+        return st;
+    }
+
+    static thread_pool*
+    current_pool()
+    {
+        return get_state().pool;
+    }
+
+    static thread_pool*
+    get_pool()
+    {
+        thread_state& st = get_state();
+        if (!st.pool && !st.destroyed) {
+            static thread_local pool_guard guard;
+            (void)guard;
+            st.pool = new thread_pool{};
+        }
+        return st.pool;
+    }
+};
+
+/**
+ * Allocator taking single objects from a block pool, arrays are allocated
+ * in the heap. Used with allocate_shared to keep an object and its
+ * control block in one pooled allocation.
+ */
+template < typename T >
+class pool_allocator {
+public:
+    using value_type    = T;
+    using pool_type     = block_pool<
+            (sizeof(T) + alignof(::std::max_align_t) - 1)
+                & ~(alignof(::std::max_align_t) - 1) >;
+
+    pool_allocator() noexcept {}
+    template < typename U >
+    pool_allocator(pool_allocator<U> const&) noexcept {}
+
+    T*
+    allocate(::std::size_t n)
+    {
+        if (n == 1)
+            return static_cast<T*>(pool_type::allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, ::std::size_t n) noexcept
+    {
+        if (n == 1) {
+            pool_type::deallocate(p);
+        } else {
+            ::operator delete(p);
+        }
+    }
+};
+
+template < typename T, typename U >
+bool
+operator == (pool_allocator<T> const&, pool_allocator<U> const&)
+{
+    return true;
+}
+
+template < typename T, typename U >
+bool
+operator != (pool_allocator<T> const&, pool_allocator<U> const&)
+{
+    return false;
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_POOL_ALLOCATOR_HPP_ */
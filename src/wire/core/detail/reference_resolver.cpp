@@ -7,6 +7,7 @@
 
 #include <wire/core/detail/reference_resolver.hpp>
 #include <wire/core/detail/configuration_options.hpp>
+#include <wire/core/detail/staggered_connect.hpp>
 #include <wire/core/connector.hpp>
 #include <wire/core/reference.hpp>
 #include <wire/core/proxy.hpp>
@@ -35,7 +36,6 @@ struct reference_resolver::impl {
     using endpoint_cache            = ::tbb::concurrent_hash_map<hash_value_type, endpoint_cache_item>;
     using endpoint_accessor         = endpoint_cache::accessor;
     using endpoint_const_accessor   = endpoint_cache::const_accessor;
-    using shared_count              = ::std::shared_ptr< ::std::size_t >;
 
     connector_weak_ptr          connector_;
 
@@ -188,48 +188,6 @@ struct reference_resolver::impl {
         locator_        = loc;
     }
 
-    // TODO Make the member static and pass connector_ptr as argument
-    static void
-    get_connection(
-            connector_ptr                       connector,
-            endpoint_rotation_ptr               ep_rot,
-            functional::callback<connection_ptr> result,
-            functional::exception_callback      exception,
-            shared_count                        retries,
-            invocation_options const&           opts)
-    {
-        using functional::report_exception;
-        if (!connector) {
-            report_exception(exception,
-                    errors::connector_destroyed{"Connector was already destroyed"});
-        }
-
-        ++(*retries);
-        connector->get_outgoing_connection_async(
-                ep_rot->next(), result,
-                [connector, ep_rot, result, exception, retries, opts](::std::exception_ptr ex)
-                {
-                    // Check retry count
-                    if (*retries < ep_rot->size()) {
-                        // Rethrow the exception
-                        try {
-                            ::std::rethrow_exception(ex);
-                        } catch (errors::connection_refused const& ex) {
-                            // Retry if the exception is connection_refused
-                            // and retry count doesn't exceed retry count
-                            get_connection(connector, ep_rot, result,
-                                    exception, retries, opts);
-                        } catch (...) {
-                            // Other exceptions are not retryable at this level
-                            report_exception(exception, ::std::current_exception());
-                        }
-                    } else {
-                        // Out of endpoint variants
-                        report_exception(exception, ex);
-                    }
-                },
-                opts);
-    }
     void
     get_connection(endpoint_rotation_ptr            ep_rot,
             functional::callback<connection_ptr>    result,
@@ -237,8 +195,7 @@ struct reference_resolver::impl {
             invocation_options const&               opts)
 
     {
-        auto retries = ::std::make_shared<::std::size_t>(0);
-        get_connection(connector_.lock(), ep_rot, result, exception, retries, opts);
+        staggered_connect::start(connector_.lock(), ep_rot, result, exception, opts);
     }
     bool
     get_connection(endpoint_const_accessor const&   eps,
@@ -250,7 +207,6 @@ struct reference_resolver::impl {
             endpoint_rotation_ptr ep_rot = eps->second;
             if (!ep_rot)
                 return false;
-            auto retries = ::std::make_shared<::std::size_t>(0);
             get_connection(ep_rot, result, exception, opts);
             return true;
         }
@@ -0,0 +1,281 @@
+/*
+ * request_table.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_REQUEST_TABLE_HPP_
+#define WIRE_CORE_DETAIL_REQUEST_TABLE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Table of pending requests keyed by monotonically increasing request numbers.
+ *
+ * Entries live in a slot array indexed by request number modulo capacity.
+ * A slot's state holds the full request number, so a stale or duplicate
+ * key never matches a slot that was reused (the number is the generation).
+ * Completion takes the entry out of the slot with a single CAS, callers
+ * invoke callbacks after the entry has been released.
+ *
+ * The number of slots is set at construction from the expected number of
+ * requests in flight, Capacity is the minimum. When a slot is still
+ * occupied by an older request (more requests in flight than expected)
+ * the entry goes to an overflow map guarded by a mutex. The slot array is
+ * allocated on first insert.
+ *
+ * Request number 0 is reserved.
+ */
+template < typename T, ::std::size_t Capacity = 128 >
+class request_table {
+public:
+    using key_type          = ::std::uint64_t;
+    using value_type        = T;
+    using key_list          = ::std::vector<key_type>;
+
+    static constexpr ::std::size_t min_capacity = Capacity;
+    static_assert((min_capacity & (min_capacity - 1)) == 0,
+            "Request table capacity must be a power of two");
+public:
+    /**
+     * @param expected Expected maximum number of entries, the table has
+     *      at least twice as many slots so that a slow request doesn't
+     *      push the following ones out of the slot array
+     */
+    explicit
+    request_table(::std::size_t expected = 0)
+        : capacity_{ slot_count(expected) }, mask_{ capacity_ - 1 },
+          slots_{nullptr}, size_{0} {}
+    request_table(request_table const&) = delete;
+    request_table&
+    operator = (request_table const&) = delete;
+    ~request_table()
+    {
+        delete [] slots_.load();
+    }
+
+    /**
+     * Insert a value. The key must not be present in the table.
+     */
+    void
+    insert(key_type key, value_type&& val)
+    {
+        slot& s = get_slot(key);
+        key_type expected = free_slot;
+        if (s.state.compare_exchange_strong(expected, key | busy,
+                ::std::memory_order_acquire)) {
+            s.value = ::std::move(val);
+            s.state.store(key, ::std::memory_order_release);
+        } else {
+            ::std::lock_guard<::std::mutex> lock{overflow_mtx_};
+            overflow_.emplace(key, ::std::move(val));
+            overflow_size_.fetch_add(1, ::std::memory_order_relaxed);
+        }
+        size_.fetch_add(1, ::std::memory_order_relaxed);
+    }
+
+    /**
+     * Remove the value from the table. Only one of concurrent callers
+     * for the same key succeeds.
+     * @param key
+     * @param val Receives the value
+     * @return true if the value was found
+     */
+    bool
+    take(key_type key, value_type& val)
+    {
+        slot* s = find_slot(key);
+        if (s && lock_slot(*s, key)) {
+            val = ::std::move(s->value);
+            s->value = value_type{};
+            s->state.store(free_slot, ::std::memory_order_release);
+            size_.fetch_sub(1, ::std::memory_order_relaxed);
+            return true;
+        }
+        if (overflow_size_.load(::std::memory_order_relaxed) > 0) {
+            ::std::lock_guard<::std::mutex> lock{overflow_mtx_};
+            auto f = overflow_.find(key);
+            if (f != overflow_.end()) {
+                val = ::std::move(f->second);
+                overflow_.erase(f);
+                overflow_size_.fetch_sub(1, ::std::memory_order_relaxed);
+                size_.fetch_sub(1, ::std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Remove the value from the table and discard it
+     */
+    bool
+    erase(key_type key)
+    {
+        value_type tmp;
+        return take(key, tmp);
+    }
+
+    /**
+     * Modify the value in place. The entry is locked for the duration of
+     * the call, the function must be short.
+     * @return true if the value was found
+     */
+    template < typename Func >
+    bool
+    modify(key_type key, Func&& func)
+    {
+        slot* s = find_slot(key);
+        if (s && lock_slot(*s, key)) {
+            func(s->value);
+            s->state.store(key, ::std::memory_order_release);
+            return true;
+        }
+        if (overflow_size_.load(::std::memory_order_relaxed) > 0) {
+            ::std::lock_guard<::std::mutex> lock{overflow_mtx_};
+            auto f = overflow_.find(key);
+            if (f != overflow_.end()) {
+                func(f->second);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    contains(key_type key) const
+    {
+        slot const* s = find_slot(key);
+        if (s && (s->state.load(::std::memory_order_acquire) & ~busy) == key)
+            return true;
+        if (overflow_size_.load(::std::memory_order_relaxed) > 0) {
+            ::std::lock_guard<::std::mutex> lock{overflow_mtx_};
+            return overflow_.count(key) > 0;
+        }
+        return false;
+    }
+
+    /**
+     * Snapshot of keys currently in the table
+     */
+    key_list
+    keys() const
+    {
+        key_list res;
+        slot const* slots = slots_.load(::std::memory_order_acquire);
+        if (slots) {
+            for (::std::size_t i = 0; i < capacity_; ++i) {
+                key_type k = slots[i].state.load(::std::memory_order_acquire) & ~busy;
+                if (k != free_slot)
+                    res.push_back(k);
+            }
+        }
+        ::std::lock_guard<::std::mutex> lock{overflow_mtx_};
+        for (auto const& v : overflow_) {
+            res.push_back(v.first);
+        }
+        return res;
+    }
+
+    ::std::size_t
+    size() const
+    { return size_.load(::std::memory_order_relaxed); }
+    ::std::size_t
+    capacity() const
+    { return capacity_; }
+    bool
+    empty() const
+    { return size() == 0; }
+private:
+    static constexpr key_type free_slot = 0;
+    static constexpr key_type busy      = key_type{1} << 63;
+
+    struct slot {
+        ::std::atomic<key_type> state{ free_slot };
+        value_type              value;
+    };
+    using overflow_map = ::std::unordered_map<key_type, value_type>;
+
+    static ::std::size_t
+    slot_count(::std::size_t expected)
+    {
+        ::std::size_t res = min_capacity;
+        while (res < expected * 2)
+            res <<= 1;
+        return res;
+    }
+
+    slot&
+    get_slot(key_type key)
+    {
+        slot* slots = slots_.load(::std::memory_order_acquire);
+        if (!slots) {
+            slot* new_slots = new slot[capacity_];
+            if (slots_.compare_exchange_strong(slots, new_slots,
+                    ::std::memory_order_acq_rel)) {
+                slots = new_slots;
+            } else {
+                delete [] new_slots;
+            }
+        }
+        return slots[key & mask_];
+    }
+
+    slot*
+    find_slot(key_type key) const
+    {
+        slot* slots = slots_.load(::std::memory_order_acquire);
+        return slots ? slots + (key & mask_) : nullptr;
+    }
+
+    /**
+     * Acquire the slot for exclusive access. Waits while the slot is being
+     * modified for the same key, fails if the slot holds another key.
+     */
+    static bool
+    lock_slot(slot& s, key_type key)
+    {
+        key_type expected = key;
+        while (!s.state.compare_exchange_weak(expected, key | busy,
+                ::std::memory_order_acquire)) {
+            if (expected != key && expected != (key | busy))
+                return false;
+            if (expected == (key | busy))
+                ::std::this_thread::yield();
+            expected = key;
+        }
+        return true;
+    }
+
+    ::std::size_t const             capacity_;
+    key_type const                  mask_;
+    ::std::atomic<slot*>            slots_;
+    ::std::atomic<::std::size_t>    size_;
+
+    mutable ::std::mutex            overflow_mtx_;
+    overflow_map                    overflow_;
+    ::std::atomic<::std::size_t>    overflow_size_{0};
+};
+
+template < typename T, ::std::size_t Capacity >
+constexpr ::std::size_t request_table<T, Capacity>::min_capacity;
+template < typename T, ::std::size_t Capacity >
+constexpr typename request_table<T, Capacity>::key_type request_table<T, Capacity>::free_slot;
+template < typename T, ::std::size_t Capacity >
+constexpr typename request_table<T, Capacity>::key_type request_table<T, Capacity>::busy;
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_REQUEST_TABLE_HPP_ */
@@ -0,0 +1,294 @@
+/*
+ * shm_ring.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/shm_ring.hpp>
+#include <wire/errors/exceptions.hpp>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+namespace {
+
+::std::size_t
+header_size()
+{
+    // Keep data area cache line aligned
+    return (sizeof(shm_ring_header) + 63) & ~::std::size_t{63};
+}
+
+asio_config::error_code
+last_error()
+{
+    return asio_config::error_code{ errno, ::boost::system::system_category() };
+}
+
+bool
+valid_capacity(::std::uint64_t capacity)
+{
+    return capacity != 0 && (capacity & (capacity - 1)) == 0;
+}
+
+asio_config::error_code
+invalid_segment()
+{
+    return asio_config::make_error_code(asio_config::error::invalid_argument);
+}
+
+struct segment_info {
+    ::std::uint64_t ring_capacity;
+};
+
+constexpr int segment_fd_count = 3;
+
+}  /* namespace  */
+
+//----------------------------------------------------------------------------
+//    Ring
+//----------------------------------------------------------------------------
+::std::size_t
+shm_ring::memory_size(::std::size_t capacity)
+{
+    return header_size() + capacity;
+}
+
+shm_ring::shm_ring(void* mem, ::std::size_t capacity, bool init)
+    : hdr_{ static_cast<shm_ring_header*>(mem) },
+      data_{ static_cast<char*>(mem) + header_size() },
+      capacity_{ capacity }
+{
+    if (!valid_capacity(capacity)) {
+        throw errors::logic_error("Shared memory ring capacity must be a power of two");
+    }
+    if (init) {
+        new (hdr_) shm_ring_header{};
+        hdr_->capacity = capacity;
+    } else if (hdr_->capacity != capacity) {
+        throw errors::runtime_error("Shared memory ring capacity mismatch");
+    }
+}
+
+void
+shm_ring::copy_in(::std::uint64_t pos, char const* src, ::std::size_t size)
+{
+    auto offset = pos & (capacity_ - 1);
+    auto first = ::std::min(size, capacity_ - offset);
+    ::std::memcpy(data_ + offset, src, first);
+    if (first < size)
+        ::std::memcpy(data_, src + first, size - first);
+}
+
+::std::size_t
+shm_ring::read(void* dst, ::std::size_t size)
+{
+    auto tail = hdr_->tail.load(::std::memory_order_relaxed);
+    auto head = hdr_->head.load(::std::memory_order_acquire);
+    ::std::size_t n = ::std::min< ::std::size_t >(size, head - tail);
+    if (n == 0)
+        return 0;
+    auto offset = tail & (capacity_ - 1);
+    auto first = ::std::min(n, capacity_ - offset);
+    ::std::memcpy(dst, data_ + offset, first);
+    if (first < n)
+        ::std::memcpy(static_cast<char*>(dst) + first, data_, n - first);
+    hdr_->tail.store(tail + n, ::std::memory_order_seq_cst);
+    return n;
+}
+
+//----------------------------------------------------------------------------
+//    Segment
+//----------------------------------------------------------------------------
+constexpr ::std::size_t shm_segment::default_ring_capacity;
+
+shm_segment::~shm_segment()
+{
+    if (mem_) {
+        ::munmap(mem_, mem_size_);
+    }
+    close_fds();
+}
+
+void
+shm_segment::close_fds()
+{
+    for (int* fd : { &mem_fd_, &wake_fd_[0], &wake_fd_[1] }) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void
+shm_segment::create(::std::size_t ring_capacity)
+{
+    asio_config::error_code ec;
+    create(ring_capacity, ec);
+    if (ec) {
+        throw errors::runtime_error("Failed to create shared memory segment: ",
+                ec.message());
+    }
+}
+
+void
+shm_segment::create(::std::size_t ring_capacity, asio_config::error_code& ec)
+{
+    ec = asio_config::error_code{};
+    if (!valid_capacity(ring_capacity)) {
+        ec = invalid_segment();
+        return;
+    }
+    int fd = ::memfd_create("wire.shm", MFD_CLOEXEC);
+    if (fd < 0) {
+        ec = last_error();
+        return;
+    }
+    mem_fd_ = fd;
+    if (::ftruncate(fd, 2 * shm_ring::memory_size(ring_capacity)) != 0) {
+        ec = last_error();
+        return;
+    }
+    for (auto& wfd : wake_fd_) {
+        wfd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wfd < 0) {
+            ec = last_error();
+            return;
+        }
+    }
+    map(fd, ring_capacity, ec);
+    if (ec)
+        return;
+    client_to_server_ = shm_ring{ mem_, ring_capacity, true };
+    server_to_client_ = shm_ring{
+        static_cast<char*>(mem_) + shm_ring::memory_size(ring_capacity),
+        ring_capacity, true };
+}
+
+void
+shm_segment::map(int fd, ::std::size_t ring_capacity, asio_config::error_code& ec)
+{
+    mem_size_ = 2 * shm_ring::memory_size(ring_capacity);
+    void* mem = ::mmap(nullptr, mem_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        ec = last_error();
+        return;
+    }
+    mem_ = mem;
+}
+
+void
+shm_segment::send(int socket_fd, asio_config::error_code& ec) const
+{
+    segment_info info{ client_to_server_.capacity() };
+    ::iovec iov{ &info, sizeof(info) };
+
+    char control[CMSG_SPACE(sizeof(int) * segment_fd_count)] = {};
+    ::msghdr msg{};
+    msg.msg_iov         = &iov;
+    msg.msg_iovlen      = 1;
+    msg.msg_control     = control;
+    msg.msg_controllen  = sizeof(control);
+
+    ::cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level    = SOL_SOCKET;
+    cmsg->cmsg_type     = SCM_RIGHTS;
+    cmsg->cmsg_len      = CMSG_LEN(sizeof(int) * segment_fd_count);
+    int fds[segment_fd_count] = { mem_fd_, wake_fd_[server], wake_fd_[client] };
+    ::std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ec = asio_config::error_code{};
+    if (::sendmsg(socket_fd, &msg, MSG_NOSIGNAL) != sizeof(info)) {
+        ec = last_error();
+    }
+}
+
+void
+shm_segment::receive(int socket_fd, asio_config::error_code& ec)
+{
+    segment_info info{ 0 };
+    ::iovec iov{ &info, sizeof(info) };
+
+    char control[CMSG_SPACE(sizeof(int) * segment_fd_count)] = {};
+    ::msghdr msg{};
+    msg.msg_iov         = &iov;
+    msg.msg_iovlen      = 1;
+    msg.msg_control     = control;
+    msg.msg_controllen  = sizeof(control);
+
+    ec = asio_config::error_code{};
+    auto res = ::recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC);
+    if (res < 0) {
+        ec = last_error();
+        return;
+    }
+    ::cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (res != sizeof(info) || !cmsg || cmsg->cmsg_type != SCM_RIGHTS ||
+            cmsg->cmsg_len != CMSG_LEN(sizeof(int) * segment_fd_count)) {
+        ec = asio_config::make_error_code(asio_config::error::connection_refused);
+        return;
+    }
+    int fds[segment_fd_count];
+    ::std::memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    mem_fd_             = fds[0];
+    wake_fd_[server]    = fds[1];
+    wake_fd_[client]    = fds[2];
+
+    // The capacity comes from the peer, check it against the memory that
+    // is actually there before mapping
+    if (!valid_capacity(info.ring_capacity)) {
+        ec = invalid_segment();
+        return;
+    }
+    struct ::stat st;
+    if (::fstat(mem_fd_, &st) != 0) {
+        ec = last_error();
+        return;
+    }
+    if (info.ring_capacity > static_cast< ::std::uint64_t >(st.st_size) ||
+            static_cast< ::std::uint64_t >(st.st_size) !=
+                2 * shm_ring::memory_size(info.ring_capacity)) {
+        ec = invalid_segment();
+        return;
+    }
+    map(mem_fd_, info.ring_capacity, ec);
+    if (ec)
+        return;
+    auto second = static_cast<char*>(mem_) + shm_ring::memory_size(info.ring_capacity);
+    if (static_cast<shm_ring_header*>(mem_)->capacity != info.ring_capacity ||
+            reinterpret_cast<shm_ring_header*>(second)->capacity != info.ring_capacity) {
+        ::munmap(mem_, mem_size_);
+        mem_ = nullptr;
+        ec = invalid_segment();
+        return;
+    }
+    client_to_server_ = shm_ring{ mem_, info.ring_capacity, false };
+    server_to_client_ = shm_ring{ second, info.ring_capacity, false };
+}
+
+void
+shm_segment::notify(side s) const
+{
+    ::std::uint64_t one = 1;
+    // The counter can only overflow if nobody reads it, ignore errors
+    auto res = ::write(wake_fd_[s], &one, sizeof(one));
+    (void)res;
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,243 @@
+/*
+ * shm_ring.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_SHM_RING_HPP_
+#define WIRE_CORE_DETAIL_SHM_RING_HPP_
+
+#include <wire/asio_config.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Control block of a single producer single consumer byte ring placed in
+ * shared memory. Positions grow monotonically, the offset in the data
+ * area is position modulo capacity.
+ */
+struct shm_ring_header {
+    alignas(64) ::std::atomic< ::std::uint64_t >    head;
+    alignas(64) ::std::atomic< ::std::uint64_t >    tail;
+    alignas(64) ::std::atomic< ::std::uint32_t >    reader_waiting;
+    ::std::atomic< ::std::uint32_t >                writer_waiting;
+    ::std::atomic< ::std::uint32_t >                closed;
+    ::std::uint64_t                                 capacity;
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+        "Shared memory ring requires lock-free atomics");
+
+class shm_ring {
+public:
+    /**
+     * Size of the memory required for a ring of the capacity
+     */
+    static ::std::size_t
+    memory_size(::std::size_t capacity);
+
+    shm_ring() = default;
+    /**
+     * @param mem Memory of memory_size(capacity) bytes
+     * @param capacity Data capacity, must be a power of two
+     * @param init Initialise the header, done by the segment creator
+     */
+    shm_ring(void* mem, ::std::size_t capacity, bool init);
+
+    //@{
+    /** @name Producer side */
+    /**
+     * Copy as much of the buffer sequence as fits.
+     * @param offset Number of bytes of the sequence already written
+     * @return Number of bytes written
+     */
+    template < typename BufferSequence >
+    ::std::size_t
+    write(BufferSequence const& buffers, ::std::size_t offset)
+    {
+        ::std::size_t written = 0;
+        auto head = hdr_->head.load(::std::memory_order_relaxed);
+        auto tail = hdr_->tail.load(::std::memory_order_acquire);
+        ::std::size_t space = capacity_ - (head - tail);
+        for (auto const& b : buffers) {
+            if (space == 0)
+                break;
+            auto size = asio_ns::buffer_size(b);
+            if (offset >= size) {
+                offset -= size;
+                continue;
+            }
+            auto data = asio_ns::buffer_cast< char const* >(b) + offset;
+            size -= offset;
+            offset = 0;
+            auto n = ::std::min(size, space);
+            copy_in(head + written, data, n);
+            written += n;
+            space -= n;
+        }
+        if (written > 0)
+            hdr_->head.store(head + written, ::std::memory_order_seq_cst);
+        return written;
+    }
+    /**
+     * Mark the writer as waiting for space. Data must be checked again
+     * after setting the flag.
+     */
+    void
+    set_writer_waiting()
+    { hdr_->writer_waiting.store(1, ::std::memory_order_seq_cst); }
+    /**
+     * Reader is waiting for data and must be woken up, clears the flag
+     */
+    bool
+    take_reader_waiting()
+    {
+        return hdr_->reader_waiting.load(::std::memory_order_seq_cst) &&
+                hdr_->reader_waiting.exchange(0, ::std::memory_order_seq_cst);
+    }
+    //@}
+
+    //@{
+    /** @name Consumer side */
+    /**
+     * Read up to size bytes
+     * @return Number of bytes read
+     */
+    ::std::size_t
+    read(void* dst, ::std::size_t size);
+    bool
+    empty() const
+    {
+        return hdr_->head.load(::std::memory_order_seq_cst) ==
+                hdr_->tail.load(::std::memory_order_relaxed);
+    }
+    void
+    set_reader_waiting()
+    { hdr_->reader_waiting.store(1, ::std::memory_order_seq_cst); }
+    void
+    clear_reader_waiting()
+    { hdr_->reader_waiting.store(0, ::std::memory_order_relaxed); }
+    bool
+    take_writer_waiting()
+    {
+        return hdr_->writer_waiting.load(::std::memory_order_seq_cst) &&
+                hdr_->writer_waiting.exchange(0, ::std::memory_order_seq_cst);
+    }
+    //@}
+
+    void
+    close()
+    { hdr_->closed.store(1, ::std::memory_order_seq_cst); }
+    bool
+    closed() const
+    { return hdr_->closed.load(::std::memory_order_seq_cst); }
+
+    ::std::size_t
+    capacity() const
+    { return capacity_; }
+    ::std::size_t
+    size() const
+    {
+        return hdr_->head.load(::std::memory_order_acquire) -
+                hdr_->tail.load(::std::memory_order_acquire);
+    }
+private:
+    void
+    copy_in(::std::uint64_t pos, char const* src, ::std::size_t size);
+private:
+    shm_ring_header*    hdr_        = nullptr;
+    char*               data_       = nullptr;
+    ::std::size_t       capacity_   = 0;
+};
+
+/**
+ * Shared memory segment with a pair of rings and wakeup descriptors.
+ *
+ * The segment is created by the accepting side and its descriptors are
+ * passed to the connecting side over a unix socket. Each side waits on its
+ * own eventfd, the peer signals it when it writes to the side's incoming
+ * ring or frees space in the side's outgoing ring.
+ */
+class shm_segment {
+public:
+    static constexpr ::std::size_t default_ring_capacity = 1024 * 1024;
+    enum side { server = 0, client = 1 };
+public:
+    shm_segment() = default;
+    ~shm_segment();
+
+    shm_segment(shm_segment const&) = delete;
+    shm_segment&
+    operator = (shm_segment const&) = delete;
+
+    /**
+     * Create a new segment, throws on failure
+     */
+    void
+    create(::std::size_t ring_capacity = default_ring_capacity);
+    void
+    create(::std::size_t ring_capacity, asio_config::error_code& ec);
+    /**
+     * Send descriptors over a connected unix socket
+     */
+    void
+    send(int socket_fd, asio_config::error_code& ec) const;
+    /**
+     * Receive descriptors from a connected unix socket and map the segment
+     */
+    void
+    receive(int socket_fd, asio_config::error_code& ec);
+
+    bool
+    valid() const
+    { return mem_ != nullptr; }
+
+    /**
+     * Ring the side reads from
+     */
+    shm_ring&
+    incoming(side s)
+    { return s == server ? client_to_server_ : server_to_client_; }
+    /**
+     * Ring the side writes to
+     */
+    shm_ring&
+    outgoing(side s)
+    { return s == server ? server_to_client_ : client_to_server_; }
+
+    /**
+     * Descriptor the side waits on
+     */
+    int
+    wait_fd(side s) const
+    { return wake_fd_[s]; }
+    /**
+     * Wake up the side
+     */
+    void
+    notify(side s) const;
+private:
+    void
+    map(int fd, ::std::size_t ring_capacity, asio_config::error_code& ec);
+    void
+    close_fds();
+private:
+    int             mem_fd_         = -1;
+    int             wake_fd_[2]     = {-1, -1};
+    void*           mem_            = nullptr;
+    ::std::size_t   mem_size_       = 0;
+    shm_ring        client_to_server_;
+    shm_ring        server_to_client_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_SHM_RING_HPP_ */
@@ -0,0 +1,147 @@
+/*
+ * ssl_session_cache.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/ssl_session_cache.hpp>
+#include <wire/errors/exceptions.hpp>
+
+#include <openssl/rand.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+namespace {
+
+void
+session_up_ref(SSL_SESSION* session)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    SSL_SESSION_up_ref(session);
+#else
+    CRYPTO_add(&session->references, 1, CRYPTO_LOCK_SSL_SESSION);
+#endif
+}
+
+}  /* namespace  */
+
+constexpr ::std::size_t ssl_session_cache::default_max_size;
+
+ssl_session_cache::ssl_session_cache(::std::size_t max_size)
+    : max_size_{max_size}
+{
+}
+
+ssl_session_cache::~ssl_session_cache()
+{
+    for (auto& s : recent_) {
+        SSL_SESSION_free(s.second);
+    }
+}
+
+SSL_SESSION*
+ssl_session_cache::get(key_type const& key) const
+{
+    lock_guard lock{mtx_};
+    auto f = sessions_.find(key);
+    if (f == sessions_.end())
+        return nullptr;
+    recent_.splice(recent_.begin(), recent_, f->second);
+    session_up_ref(f->second->second);
+    return f->second->second;
+}
+
+void
+ssl_session_cache::put(key_type const& key, SSL_SESSION* session)
+{
+    SSL_SESSION* old = nullptr;
+    {
+        lock_guard lock{mtx_};
+        auto f = sessions_.find(key);
+        if (f != sessions_.end()) {
+            old = f->second->second;
+            f->second->second = session;
+            recent_.splice(recent_.begin(), recent_, f->second);
+        } else {
+            if (sessions_.size() >= max_size_ && !recent_.empty()) {
+                old = recent_.back().second;
+                sessions_.erase(recent_.back().first);
+                recent_.pop_back();
+            }
+            recent_.emplace_front(key, session);
+            sessions_.emplace(key, recent_.begin());
+        }
+    }
+    if (old)
+        SSL_SESSION_free(old);
+}
+
+void
+ssl_session_cache::erase(key_type const& key)
+{
+    SSL_SESSION* old = nullptr;
+    {
+        lock_guard lock{mtx_};
+        auto f = sessions_.find(key);
+        if (f != sessions_.end()) {
+            old = f->second->second;
+            recent_.erase(f->second);
+            sessions_.erase(f);
+        }
+    }
+    if (old)
+        SSL_SESSION_free(old);
+}
+
+::std::size_t
+ssl_session_cache::size() const
+{
+    lock_guard lock{mtx_};
+    return sessions_.size();
+}
+
+::std::size_t
+ssl_session_cache::ticket_keys_size()
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    return 80;
+#else
+    return 48;
+#endif
+}
+
+::std::string
+ssl_session_cache::generate_ticket_keys()
+{
+    ::std::string keys(ticket_keys_size(), '\0');
+    if (RAND_bytes(reinterpret_cast<unsigned char*>(&keys[0]), keys.size()) != 1) {
+        throw errors::runtime_error("Failed to generate SSL session ticket keys");
+    }
+    return keys;
+}
+
+::std::string
+ssl_session_cache::read_ticket_keys(::std::string const& file_name)
+{
+    ::std::ifstream file{file_name, ::std::ios_base::binary};
+    if (!file) {
+        throw errors::runtime_error("Failed to open SSL ticket key file ", file_name);
+    }
+    ::std::string keys{ ::std::istreambuf_iterator<char>{file},
+        ::std::istreambuf_iterator<char>{} };
+    if (keys.size() != ticket_keys_size()) {
+        throw errors::runtime_error("SSL ticket key file ", file_name,
+                " must be exactly ", ticket_keys_size(), " bytes long");
+    }
+    return keys;
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
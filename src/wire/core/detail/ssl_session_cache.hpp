@@ -0,0 +1,104 @@
+/*
+ * ssl_session_cache.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_SSL_SESSION_CACHE_HPP_
+#define WIRE_CORE_DETAIL_SSL_SESSION_CACHE_HPP_
+
+#include <wire/core/detail/ssl_options.hpp>
+
+#include <openssl/ssl.h>
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Client-side TLS session cache keyed by peer endpoint.
+ *
+ * Stores the last resumable session received from a peer, either a
+ * TLS 1.2 session id/ticket or a TLS 1.3 PSK ticket. The cache holds a
+ * reference to each session.
+ *
+ * When the cache is full, the least recently used session is evicted.
+ * Both get and put count as a use.
+ */
+class ssl_session_cache {
+public:
+    using key_type      = ::std::string;
+
+    static constexpr ::std::size_t default_max_size = 1024;
+public:
+    explicit
+    ssl_session_cache(::std::size_t max_size = default_max_size);
+    ~ssl_session_cache();
+
+    ssl_session_cache(ssl_session_cache const&) = delete;
+    ssl_session_cache&
+    operator = (ssl_session_cache const&) = delete;
+
+    /**
+     * Get a session for the key.
+     * @param key
+     * @return Session with incremented reference count, the caller must
+     *      free it, or nullptr.
+     */
+    SSL_SESSION*
+    get(key_type const& key) const;
+    /**
+     * Store a session, the cache takes ownership of one reference.
+     */
+    void
+    put(key_type const& key, SSL_SESSION* session);
+    void
+    erase(key_type const& key);
+
+    ::std::size_t
+    size() const;
+
+    //@{
+    /** @name Server-side ticket keys */
+    /**
+     * Size of ticket keys accepted by OpenSSL
+     */
+    static ::std::size_t
+    ticket_keys_size();
+    /**
+     * Generate random ticket keys
+     */
+    static ::std::string
+    generate_ticket_keys();
+    /**
+     * Read ticket keys from a file. Throws if the file cannot be read or
+     * has wrong size.
+     */
+    static ::std::string
+    read_ticket_keys(::std::string const& file_name);
+    //@}
+private:
+    /** Sessions ordered by recency, most recently used first */
+    using session_list  = ::std::list< ::std::pair< key_type, SSL_SESSION* > >;
+    using session_map   = ::std::unordered_map< key_type, session_list::iterator >;
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+
+    ::std::size_t const     max_size_;
+    mutable mutex_type      mtx_;
+    mutable session_list    recent_;
+    session_map             sessions_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_SSL_SESSION_CACHE_HPP_ */
@@ -0,0 +1,154 @@
+/*
+ * staggered_connect.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/staggered_connect.hpp>
+#include <wire/core/connector.hpp>
+#include <wire/errors/exceptions.hpp>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+constexpr ::std::chrono::milliseconds staggered_connect::default_delay;
+
+void
+staggered_connect::start(connector_ptr cntr, rotation_ptr rotation,
+        functional::callback< connection_ptr >  result,
+        functional::exception_callback          exception,
+        invocation_options const&               opts,
+        delay_type                              delay)
+{
+    start(cntr, rotation,
+        result_callback{
+            [result](connection_ptr conn, endpoint const&)
+            {
+                result(conn);
+            }
+        }, ::std::move(exception), opts, delay);
+}
+
+void
+staggered_connect::start(connector_ptr cntr, rotation_ptr rotation,
+        result_callback                         result,
+        functional::exception_callback          exception,
+        invocation_options const&               opts,
+        delay_type                              delay)
+{
+    if (!cntr) {
+        functional::report_exception(exception,
+                errors::connector_destroyed{"Connector was already destroyed"});
+        return;
+    }
+    auto conn = ::std::make_shared< staggered_connect >(cntr, rotation,
+            ::std::move(result), ::std::move(exception), opts, delay);
+    conn->try_next();
+}
+
+staggered_connect::staggered_connect(connector_ptr cntr, rotation_ptr rotation,
+        result_callback                         result,
+        functional::exception_callback          exception,
+        invocation_options const&               opts,
+        delay_type                              delay)
+    : connector_{cntr}, rotation_{rotation},
+      result_{::std::move(result)}, exception_{::std::move(exception)},
+      // Attempts must not block each other
+      opts_{opts - invocation_flags::sync}, delay_{delay},
+      timer_{*cntr->io_service()},
+      order_{rotation->connect_order()}
+{
+}
+
+void
+staggered_connect::try_next()
+{
+    endpoint ep;
+    {
+        lock_guard lock{mtx_};
+        if (done_ || next_ >= order_.size())
+            return;
+        ep = order_[next_++];
+        ++pending_;
+        if (next_ < order_.size()) {
+            auto _this = shared_from_this();
+            timer_.expires_from_now(delay_);
+            timer_.async_wait(
+                [_this](asio_config::error_code const& ec)
+                {
+                    if (!ec)
+                        _this->try_next();
+                });
+        }
+    }
+    auto cntr = connector_.lock();
+    if (!cntr) {
+        failed(ep, ::std::make_exception_ptr(
+                errors::connector_destroyed{"Connector was already destroyed"}));
+        return;
+    }
+    auto _this = shared_from_this();
+    auto start = clock_type::now();
+    cntr->get_outgoing_connection_async(ep,
+        [_this, ep, start](connection_ptr conn)
+        {
+            _this->connected(ep, start, conn);
+        },
+        [_this, ep](::std::exception_ptr ex)
+        {
+            _this->failed(ep, ex);
+        }, opts_);
+}
+
+void
+staggered_connect::connected(endpoint const& ep, clock_type::time_point start,
+        connection_ptr conn)
+{
+    rotation_->connected(ep, ::std::chrono::duration_cast< rotation_type::duration_type >(
+            clock_type::now() - start));
+    {
+        lock_guard lock{mtx_};
+        --pending_;
+        if (done_)
+            return;
+        done_ = true;
+        asio_config::error_code ignore;
+        timer_.cancel(ignore);
+    }
+    result_(conn, ep);
+}
+
+void
+staggered_connect::failed(endpoint const& ep, ::std::exception_ptr ex)
+{
+    rotation_->failed(ep);
+    bool start_next = false;
+    {
+        lock_guard lock{mtx_};
+        --pending_;
+        if (done_)
+            return;
+        last_error_ = ex;
+        if (next_ < order_.size()) {
+            // Don't wait for the delay
+            asio_config::error_code ignore;
+            timer_.cancel(ignore);
+            start_next = true;
+        } else if (pending_ == 0) {
+            done_ = true;
+        } else {
+            return;
+        }
+    }
+    if (start_next) {
+        try_next();
+    } else {
+        functional::report_exception(exception_, ex);
+    }
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,99 @@
+/*
+ * staggered_connect.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_STAGGERED_CONNECT_HPP_
+#define WIRE_CORE_DETAIL_STAGGERED_CONNECT_HPP_
+
+#include <wire/asio_config.hpp>
+#include <wire/core/connector_fwd.hpp>
+#include <wire/core/connection_fwd.hpp>
+#include <wire/core/endpoint.hpp>
+#include <wire/core/functional.hpp>
+#include <wire/core/invocation_options.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Connect to the first available endpoint of a rotation.
+ *
+ * Connection attempts are started one after another with a short delay,
+ * without waiting for the previous attempt to time out. A failed attempt
+ * starts the next one immediately. The first established connection is
+ * reported, no more attempts are started after it. Connect latencies are
+ * recorded in the rotation, so that fast endpoints are tried first next time.
+ */
+class staggered_connect : public ::std::enable_shared_from_this< staggered_connect > {
+public:
+    using rotation_type     = endpoint_rotation< endpoint_list >;
+    using rotation_ptr      = ::std::shared_ptr< rotation_type >;
+    using clock_type        = ::std::chrono::steady_clock;
+    using timer_type        = asio_config::system_timer;
+    using delay_type        = timer_type::duration;
+    using result_callback   = functional::callback< connection_ptr, endpoint const& >;
+
+    static constexpr ::std::chrono::milliseconds default_delay{250};
+public:
+    static void
+    start(connector_ptr, rotation_ptr,
+            functional::callback< connection_ptr >  result,
+            functional::exception_callback          exception,
+            invocation_options const&               opts,
+            delay_type                              delay = default_delay);
+    /**
+     * Start connecting, the result callback also receives the endpoint
+     * the connection was established to.
+     */
+    static void
+    start(connector_ptr, rotation_ptr,
+            result_callback                         result,
+            functional::exception_callback          exception,
+            invocation_options const&               opts,
+            delay_type                              delay = default_delay);
+
+    staggered_connect(connector_ptr, rotation_ptr,
+            result_callback                         result,
+            functional::exception_callback          exception,
+            invocation_options const&               opts,
+            delay_type                              delay);
+private:
+    void
+    try_next();
+    void
+    connected(endpoint const& ep, clock_type::time_point start, connection_ptr conn);
+    void
+    failed(endpoint const& ep, ::std::exception_ptr ex);
+private:
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard< mutex_type >;
+
+    connector_weak_ptr                      connector_;
+    rotation_ptr                            rotation_;
+    result_callback                         result_;
+    functional::exception_callback          exception_;
+    invocation_options const                opts_;
+    delay_type const                        delay_;
+
+    mutex_type                              mtx_;
+    timer_type                              timer_;
+    ::std::vector< endpoint >               order_;
+    ::std::size_t                           next_       = 0;
+    ::std::size_t                           pending_    = 0;
+    bool                                    done_       = false;
+    ::std::exception_ptr                    last_error_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_STAGGERED_CONNECT_HPP_ */
@@ -0,0 +1,311 @@
+/*
+ * timing_wheel.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/timing_wheel.hpp>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+asio_ns::io_service::id timing_wheel::id;
+
+constexpr timing_wheel::timer_id    timing_wheel::invalid_timer;
+constexpr ::std::size_t             timing_wheel::wheel_size;
+
+static_assert((timing_wheel::wheel_size & (timing_wheel::wheel_size - 1)) == 0,
+        "Wheel size must be a power of two");
+
+struct timing_wheel::impl {
+    using mutex_type        = ::std::mutex;
+    using lock_guard        = ::std::lock_guard<mutex_type>;
+    using index_type        = ::std::uint32_t;
+    using tick_type         = ::std::uint64_t;
+    using handler_list      = ::std::vector<functional::void_callback>;
+
+    static constexpr index_type     npos        = ~index_type{0};
+    static constexpr tick_type      wheel_mask  = wheel_size - 1;
+
+    struct node {
+        index_type                  prev        = npos;
+        index_type                  next        = npos;
+        ::std::uint32_t             generation  = 1;
+        bool                        used        = false;
+        tick_type                   rounds      = 0;
+        tick_type                   deadline    = 0;
+        functional::void_callback   handler;
+    };
+
+    impl(asio_ns::io_service& owner)
+        : timer_{owner}, start_{clock_type::now()}
+    {
+        slots_.fill(npos);
+    }
+
+    tick_type
+    now_tick() const
+    {
+        return ::std::chrono::duration_cast<duration_type>(
+                clock_type::now() - start_).count();
+    }
+
+    timer_id
+    schedule(duration_type timeout, functional::void_callback handler)
+    {
+        lock_guard lock{mtx_};
+        if (shutdown_)
+            return invalid_timer;
+        tick_type ticks = timeout.count() > 0 ? timeout.count() : 1;
+        tick_type now = now_tick();
+        if (size_ == 0) {
+            // The wheel was idle, skip the empty ticks so that the next
+            // advance doesn't walk them
+            current_tick_ = ::std::max(now, current_tick_);
+        }
+        tick_type base = ::std::max(now, current_tick_);
+        tick_type deadline = base + ticks;
+
+        index_type idx = allocate();
+        node& n = nodes_[idx];
+        n.handler   = ::std::move(handler);
+        n.deadline  = deadline;
+        n.rounds    = (deadline - current_tick_ - 1) / wheel_size;
+        link(idx, deadline & wheel_mask);
+        ++size_;
+
+        if (!armed_ || deadline < armed_tick_)
+            arm(deadline);
+        return (static_cast<timer_id>(n.generation) << 32) | idx;
+    }
+
+    bool
+    cancel(timer_id timer)
+    {
+        functional::void_callback handler;
+        {
+            lock_guard lock{mtx_};
+            index_type idx = static_cast<index_type>(timer & 0xffffffff);
+            ::std::uint32_t gen = static_cast<::std::uint32_t>(timer >> 32);
+            if (idx >= nodes_.size())
+                return false;
+            node& n = nodes_[idx];
+            if (!n.used || n.generation != gen)
+                return false;
+            unlink(idx, n.deadline & wheel_mask);
+            handler = ::std::move(n.handler);
+            release(idx);
+            --size_;
+        }
+        // The handler is destroyed outside of the lock, it can hold the last
+        // reference to an object that cancels its timers in destructor
+        return true;
+    }
+
+    void
+    on_tick(asio_config::error_code const& ec)
+    {
+        if (ec == asio_ns::error::operation_aborted)
+            return;
+        handler_list expired;
+        {
+            lock_guard lock{mtx_};
+            if (shutdown_)
+                return;
+            armed_ = false;
+            advance(now_tick(), expired);
+            if (size_ > 0)
+                arm(next_tick());
+        }
+        for (auto& h : expired) {
+            try {
+                h();
+            } catch (...) {
+                // Ignore handler error
+            }
+        }
+    }
+
+    void
+    shutdown()
+    {
+        ::std::vector<node> nodes;
+        {
+            lock_guard lock{mtx_};
+            shutdown_ = true;
+            timer_.cancel();
+            nodes.swap(nodes_);
+            slots_.fill(npos);
+            free_ = npos;
+            size_ = 0;
+        }
+    }
+
+    ::std::size_t
+    size() const
+    {
+        lock_guard lock{mtx_};
+        return size_;
+    }
+private:
+    index_type
+    allocate()
+    {
+        index_type idx = free_;
+        if (idx == npos) {
+            idx = static_cast<index_type>(nodes_.size());
+            nodes_.emplace_back();
+        } else {
+            free_ = nodes_[idx].next;
+        }
+        nodes_[idx].used = true;
+        return idx;
+    }
+
+    void
+    release(index_type idx)
+    {
+        node& n = nodes_[idx];
+        n.used = false;
+        n.prev = npos;
+        n.next = free_;
+        if (++n.generation == 0)
+            n.generation = 1;
+        free_ = idx;
+    }
+
+    void
+    link(index_type idx, tick_type slot)
+    {
+        node& n = nodes_[idx];
+        n.prev = npos;
+        n.next = slots_[slot];
+        if (n.next != npos)
+            nodes_[n.next].prev = idx;
+        slots_[slot] = idx;
+    }
+
+    void
+    unlink(index_type idx, tick_type slot)
+    {
+        node& n = nodes_[idx];
+        if (n.prev != npos)
+            nodes_[n.prev].next = n.next;
+        else
+            slots_[slot] = n.next;
+        if (n.next != npos)
+            nodes_[n.next].prev = n.prev;
+    }
+
+    void
+    advance(tick_type now, handler_list& expired)
+    {
+        if (size_ == 0) {
+            current_tick_ = ::std::max(now, current_tick_);
+            return;
+        }
+        while (current_tick_ < now && size_ > 0) {
+            ++current_tick_;
+            tick_type slot = current_tick_ & wheel_mask;
+            index_type idx = slots_[slot];
+            while (idx != npos) {
+                node& n = nodes_[idx];
+                index_type next = n.next;
+                if (n.rounds == 0) {
+                    unlink(idx, slot);
+                    expired.push_back(::std::move(n.handler));
+                    release(idx);
+                    --size_;
+                } else {
+                    --n.rounds;
+                }
+                idx = next;
+            }
+        }
+        current_tick_ = ::std::max(now, current_tick_);
+    }
+
+    tick_type
+    next_tick() const
+    {
+        for (tick_type t = current_tick_ + 1; t <= current_tick_ + wheel_size; ++t) {
+            if (slots_[t & wheel_mask] != npos)
+                return t;
+        }
+        return current_tick_ + wheel_size;
+    }
+
+    void
+    arm(tick_type tick)
+    {
+        armed_      = true;
+        armed_tick_ = tick;
+        timer_.expires_at(start_ + duration_type{tick});
+        timer_.async_wait(
+            [this](asio_config::error_code const& ec)
+            {
+                on_tick(ec);
+            });
+    }
+
+    asio_ns::steady_timer                   timer_;
+    clock_type::time_point const            start_;
+
+    mutable mutex_type                      mtx_;
+    ::std::vector<node>                     nodes_;
+    ::std::array<index_type, wheel_size>    slots_;
+    index_type                              free_           = npos;
+    ::std::size_t                           size_           = 0;
+    tick_type                               current_tick_   = 0;
+    tick_type                               armed_tick_     = 0;
+    bool                                    armed_          = false;
+    bool                                    shutdown_       = false;
+};
+
+constexpr timing_wheel::impl::index_type    timing_wheel::impl::npos;
+constexpr timing_wheel::impl::tick_type     timing_wheel::impl::wheel_mask;
+
+timing_wheel::timing_wheel(asio_ns::io_service& owner)
+    : asio_ns::io_service::service{owner}, pimpl_{ new impl{owner} }
+{
+}
+
+timing_wheel::~timing_wheel()
+{
+}
+
+void
+timing_wheel::shutdown_service()
+{
+    pimpl_->shutdown();
+}
+
+timing_wheel::timer_id
+timing_wheel::schedule(duration_type timeout, functional::void_callback handler)
+{
+    return pimpl_->schedule(timeout, ::std::move(handler));
+}
+
+bool
+timing_wheel::cancel(timer_id timer)
+{
+    if (timer == invalid_timer)
+        return false;
+    return pimpl_->cancel(timer);
+}
+
+::std::size_t
+timing_wheel::size() const
+{
+    return pimpl_->size();
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
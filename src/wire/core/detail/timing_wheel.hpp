@@ -0,0 +1,81 @@
+/*
+ * timing_wheel.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_TIMING_WHEEL_HPP_
+#define WIRE_CORE_DETAIL_TIMING_WHEEL_HPP_
+
+#include <wire/asio_config.hpp>
+#include <wire/core/functional.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Hashed timing wheel shared by all connections running on an io_service.
+ * Resolution is one millisecond, scheduling and cancelling a timer are O(1).
+ * The underlying asio timer is armed only when there are timers in the wheel.
+ *
+ * Handlers are invoked in a thread running the io_service, outside of the
+ * wheel's lock, so a handler may schedule or cancel other timers.
+ */
+class timing_wheel : public asio_ns::io_service::service {
+public:
+    using clock_type        = ::std::chrono::steady_clock;
+    using duration_type     = ::std::chrono::milliseconds;
+    /**
+     * Opaque timer handle. Contains a slot index and a generation so that a
+     * stale handle never cancels a timer that reused the slot.
+     */
+    using timer_id          = ::std::uint64_t;
+
+    static constexpr timer_id           invalid_timer   = 0;
+    static constexpr ::std::size_t      wheel_size      = 512;
+
+    static asio_ns::io_service::id id;
+    timing_wheel(asio_ns::io_service& owner);
+    virtual ~timing_wheel();
+
+    void
+    shutdown_service() override;
+
+    /**
+     * Schedule a handler to be invoked after the timeout
+     * @param timeout
+     * @param handler
+     * @return Handle to cancel the timer
+     */
+    timer_id
+    schedule(duration_type timeout, functional::void_callback handler);
+    /**
+     * Cancel the timer. The handler is destroyed without being invoked.
+     * @param timer
+     * @return true if the timer was pending
+     */
+    bool
+    cancel(timer_id timer);
+
+    /**
+     * Number of pending timers
+     */
+    ::std::size_t
+    size() const;
+private:
+    struct impl;
+    typedef ::std::unique_ptr<impl> pimpl;
+    pimpl pimpl_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_TIMING_WHEEL_HPP_ */
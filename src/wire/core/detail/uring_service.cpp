@@ -0,0 +1,1042 @@
+/*
+ * uring_service.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/uring_service.hpp>
+#include <wire/errors/exceptions.hpp>
+
+#ifdef WIRE_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#endif
+
+namespace wire {
+namespace core {
+namespace detail {
+
+asio_ns::io_service::id uring_service::id;
+
+constexpr unsigned      uring_service::default_entries;
+constexpr ::std::size_t uring_service::recv_buffer_size;
+constexpr ::std::size_t uring_service::recv_buffer_count;
+
+#ifdef WIRE_HAS_IO_URING
+namespace {
+
+int
+sys_setup(unsigned entries, ::io_uring_params* p)
+{
+    return ::syscall(__NR_io_uring_setup, entries, p);
+}
+
+int
+sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int
+sys_register(int fd, unsigned opcode, void* arg, unsigned nr_args)
+{
+    return ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+template < typename T >
+T*
+ring_ptr(void* base, unsigned offset)
+{
+    return reinterpret_cast< T* >(static_cast< char* >(base) + offset);
+}
+
+asio_config::error_code
+make_error(int err)
+{
+    return asio_config::error_code{ err, ::boost::system::system_category() };
+}
+
+/**
+ * Submission and completion queues shared with the kernel
+ */
+class ring {
+public:
+    ring() = default;
+    ~ring()
+    {
+        reset();
+    }
+    ring(ring const&) = delete;
+    ring&
+    operator = (ring const&) = delete;
+
+    /**
+     * @return 0 on success, negated errno on failure
+     */
+    int
+    setup(unsigned entries)
+    {
+        ::io_uring_params params;
+        ::std::memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CLAMP;
+        int fd = sys_setup(entries, &params);
+        if (fd < 0)
+            return -errno;
+        fd_ = fd;
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_size_ = cq_size_ = ::std::max(sq_size_, cq_size_);
+        }
+        sq_ptr_ = map(sq_size_, IORING_OFF_SQ_RING);
+        if (!sq_ptr_)
+            return fail();
+        if (single_mmap) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            cq_ptr_ = map(cq_size_, IORING_OFF_CQ_RING);
+            if (!cq_ptr_)
+                return fail();
+        }
+        sqes_size_ = params.sq_entries * sizeof(::io_uring_sqe);
+        sqes_ = static_cast< ::io_uring_sqe* >(map(sqes_size_, IORING_OFF_SQES));
+        if (!sqes_)
+            return fail();
+
+        sq_head_    = ring_ptr<unsigned>(sq_ptr_, params.sq_off.head);
+        sq_tail_    = ring_ptr<unsigned>(sq_ptr_, params.sq_off.tail);
+        sq_flags_   = ring_ptr<unsigned>(sq_ptr_, params.sq_off.flags);
+        sq_mask_    = *ring_ptr<unsigned>(sq_ptr_, params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+        auto array  = ring_ptr<unsigned>(sq_ptr_, params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries_; ++i) {
+            array[i] = i;
+        }
+        cq_head_    = ring_ptr<unsigned>(cq_ptr_, params.cq_off.head);
+        cq_tail_    = ring_ptr<unsigned>(cq_ptr_, params.cq_off.tail);
+        cq_mask_    = *ring_ptr<unsigned>(cq_ptr_, params.cq_off.ring_mask);
+        cqes_       = ring_ptr< ::io_uring_cqe >(cq_ptr_, params.cq_off.cqes);
+
+        local_tail_ = submitted_ = *sq_tail_;
+        return 0;
+    }
+
+    void
+    reset()
+    {
+        if (sqes_)
+            ::munmap(sqes_, sqes_size_);
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_)
+            ::munmap(cq_ptr_, cq_size_);
+        if (sq_ptr_)
+            ::munmap(sq_ptr_, sq_size_);
+        sqes_ = nullptr;
+        sq_ptr_ = cq_ptr_ = nullptr;
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+    }
+
+    int
+    fd() const
+    { return fd_; }
+
+    bool
+    valid() const
+    { return fd_ >= 0; }
+
+    /**
+     * Number of free submission entries
+     */
+    unsigned
+    space() const
+    {
+        return sq_entries_ - (local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE));
+    }
+
+    /**
+     * @return Zeroed submission entry or nullptr if the queue is full
+     */
+    ::io_uring_sqe*
+    get_sqe()
+    {
+        if (space() == 0)
+            return nullptr;
+        auto sqe = &sqes_[local_tail_ & sq_mask_];
+        ++local_tail_;
+        ::std::memset(sqe, 0, sizeof(::io_uring_sqe));
+        return sqe;
+    }
+
+    /**
+     * Pass queued entries to the kernel
+     * @return Number of entries submitted or negated errno
+     */
+    int
+    submit()
+    {
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        unsigned to_submit = local_tail_ - submitted_;
+        if (to_submit == 0)
+            return 0;
+        int res = sys_enter(fd_, to_submit, 0, 0);
+        if (res < 0)
+            return -errno;
+        submitted_ += res;
+        return res;
+    }
+
+    /**
+     * Call the function for every available completion
+     */
+    template < typename Func >
+    unsigned
+    reap(Func func)
+    {
+        unsigned count = 0;
+        unsigned head = *cq_head_;
+        while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+            ::io_uring_cqe cqe = cqes_[head & cq_mask_];
+            ++head;
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            func(cqe);
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * Completions didn't fit the queue and are kept by the kernel
+     */
+    bool
+    cq_overflow() const
+    {
+        return __atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW;
+    }
+    void
+    flush_overflow()
+    {
+        sys_enter(fd_, 0, 0, IORING_ENTER_GETEVENTS);
+    }
+
+    int
+    register_op(unsigned opcode, void* arg, unsigned nr_args)
+    {
+        return sys_register(fd_, opcode, arg, nr_args) < 0 ? -errno : 0;
+    }
+private:
+    void*
+    map(::std::size_t size, unsigned long long offset)
+    {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+    int
+    fail()
+    {
+        int err = -errno;
+        reset();
+        return err;
+    }
+private:
+    int                 fd_         = -1;
+    void*               sq_ptr_     = nullptr;
+    ::std::size_t       sq_size_    = 0;
+    void*               cq_ptr_     = nullptr;
+    ::std::size_t       cq_size_    = 0;
+    ::io_uring_sqe*     sqes_       = nullptr;
+    ::std::size_t       sqes_size_  = 0;
+
+    unsigned*           sq_head_    = nullptr;
+    unsigned*           sq_tail_    = nullptr;
+    unsigned*           sq_flags_   = nullptr;
+    unsigned            sq_mask_    = 0;
+    unsigned            sq_entries_ = 0;
+    unsigned            local_tail_ = 0;
+    unsigned            submitted_  = 0;
+
+    unsigned*           cq_head_    = nullptr;
+    unsigned*           cq_tail_    = nullptr;
+    unsigned            cq_mask_    = 0;
+    ::io_uring_cqe*     cqes_       = nullptr;
+};
+
+bool
+probe_ops(ring& r)
+{
+    static constexpr unsigned max_ops = 256;
+    ::std::vector< char > mem(sizeof(::io_uring_probe) + max_ops * sizeof(::io_uring_probe_op));
+    auto probe = reinterpret_cast< ::io_uring_probe* >(mem.data());
+    if (r.register_op(IORING_REGISTER_PROBE, probe, max_ops) != 0)
+        return false;
+    for (unsigned op : { IORING_OP_RECV, IORING_OP_SENDMSG,
+            IORING_OP_PROVIDE_BUFFERS, IORING_OP_ASYNC_CANCEL }) {
+        if (op >= probe->ops_len || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+            return false;
+    }
+    return true;
+}
+
+constexpr unsigned short    buffer_group        = 0;
+constexpr unsigned          max_send_chain      = 32;
+
+}  /* namespace  */
+
+using handler_list = ::std::vector< ::std::function< void() > >;
+using deferred_list = ::std::deque< ::std::function< void() > >;
+
+class uring_service::stream {
+public:
+    struct chunk {
+        unsigned short  bid;
+        unsigned        offset;
+        unsigned        size;
+    };
+    struct message {
+        buffer_list                     buffers;
+        asio_config::asio_rw_callback   cb;
+    };
+
+    stream(int fd) : fd{fd} {}
+
+    int const                       fd;
+    bool                            closed          = false;
+    bool                            recv_armed      = false;
+    bool                            recv_cancelled  = false;
+    bool                            starved         = false;
+    bool                            eof             = false;
+    asio_config::error_code         error;
+    void*                           recv_op         = nullptr;
+
+    ::std::deque< chunk >           received;
+    asio_ns::mutable_buffer         read_buffer;
+    asio_config::asio_rw_callback   read_cb;
+
+    ::std::deque< message >         send_queue;
+    unsigned                        sends_in_flight = 0;
+};
+
+struct uring_service::impl {
+    struct operation {
+        virtual ~operation() {}
+        /**
+         * @return true if more completions will follow
+         */
+        virtual bool
+        complete(impl&, int res, unsigned flags, handler_list& done) = 0;
+    };
+
+    struct recv_operation : operation {
+        stream_ptr  stream;
+
+        recv_operation(stream_ptr s) : stream{::std::move(s)} {}
+        bool
+        complete(impl& svc, int res, unsigned flags, handler_list& done) override
+        {
+            return svc.handle_recv(stream, res, flags, done);
+        }
+    };
+
+    struct send_operation : operation {
+        stream_ptr                      stream;
+        ::std::vector< ::iovec >        iov;
+        ::msghdr                        msg;
+        ::std::size_t                   size;
+        asio_config::asio_rw_callback   cb;
+
+        send_operation(stream_ptr s, stream::message&& m)
+            : stream{::std::move(s)}, iov{}, msg{}, size{0}, cb{::std::move(m.cb)}
+        {
+            iov.reserve(m.buffers.size());
+            for (auto const& b : m.buffers) {
+                auto sz = asio_ns::buffer_size(b);
+                if (sz == 0)
+                    continue;
+                iov.push_back(::iovec{
+                    const_cast< void* >(asio_ns::buffer_cast< void const* >(b)), sz });
+                size += sz;
+            }
+            msg.msg_iov     = iov.data();
+            msg.msg_iovlen  = iov.size();
+        }
+        bool
+        complete(impl& svc, int res, unsigned, handler_list& done) override
+        {
+            svc.handle_send(*this, res, done);
+            return false;
+        }
+    };
+
+    impl(asio_ns::io_service& svc)
+        : io_service_{svc}, wakeup_{svc}
+    {
+    }
+
+    bool
+    start(unsigned entries)
+    {
+        if (!supported())
+            return false;
+        if (ring_.setup(entries) != 0)
+            return false;
+        int efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (efd < 0) {
+            ring_.reset();
+            return false;
+        }
+        if (ring_.register_op(IORING_REGISTER_EVENTFD, &efd, 1) != 0) {
+            ::close(efd);
+            ring_.reset();
+            return false;
+        }
+        wakeup_.assign(efd);
+
+        buffers_.resize(recv_buffer_count * recv_buffer_size);
+        auto sqe = get_sqe();
+        if (!sqe) {
+            ring_.reset();
+            return false;
+        }
+        sqe->opcode     = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd         = recv_buffer_count;
+        sqe->addr       = reinterpret_cast< ::std::uint64_t >(buffers_.data());
+        sqe->len        = recv_buffer_size;
+        sqe->off        = 0;
+        sqe->buf_group  = buffer_group;
+        ring_.submit();
+
+        enabled_ = true;
+        wait_completions();
+        return true;
+    }
+
+    void
+    stop()
+    {
+        ::std::lock_guard< ::std::mutex > lock{mtx_};
+        enabled_ = false;
+        asio_config::error_code ignore;
+        wakeup_.close(ignore);
+        // Closing the ring cancels all requests
+        ring_.reset();
+        for (auto op : ops_) {
+            delete op;
+        }
+        ops_.clear();
+        deferred_.clear();
+    }
+
+    //@{
+    /** @name Completion handling */
+    void
+    wait_completions()
+    {
+        wakeup_.async_read_some(asio_ns::buffer(&wake_counter_, sizeof(wake_counter_)),
+            [this](asio_config::error_code const& ec, ::std::size_t)
+            {
+                if (!ec) {
+                    reap();
+                    wait_completions();
+                }
+            });
+    }
+
+    void
+    reap()
+    {
+        handler_list done;
+        {
+            ::std::lock_guard< ::std::mutex > lock{mtx_};
+            if (!enabled_)
+                return;
+            dispatching_ = true;
+            auto handle = [&](::io_uring_cqe const& cqe)
+                {
+                    if (cqe.user_data == 0)
+                        return;
+                    auto op = reinterpret_cast< operation* >(cqe.user_data);
+                    if (!op->complete(*this, cqe.res, cqe.flags, done)) {
+                        ops_.erase(op);
+                        delete op;
+                    }
+                };
+            ring_.reap(handle);
+            if (ring_.cq_overflow()) {
+                ring_.flush_overflow();
+                ring_.reap(handle);
+            }
+        }
+        // Operations started by the handlers go to the kernel with a single
+        // submit call. The flush must happen even if a handler throws,
+        // otherwise the dispatching flag stays set.
+        struct flush_guard {
+            impl& svc;
+            ~flush_guard() { svc.flush(); }
+        } guard{*this};
+        for (auto& h : done) {
+            h();
+        }
+    }
+
+    void
+    flush()
+    {
+        ::std::lock_guard< ::std::mutex > lock{mtx_};
+        flush_scheduled_ = false;
+        dispatching_ = false;
+        if (!enabled_)
+            return;
+        int res = ring_.submit();
+        // Run operations that didn't get a submission entry, the ones that
+        // fail again are put back to the list
+        for (auto n = deferred_.size(); n > 0 && ring_.space() > 0; --n) {
+            auto op = ::std::move(deferred_.front());
+            deferred_.pop_front();
+            op();
+        }
+        if (!deferred_.empty() && ring_.space() > 0)
+            ring_.submit();
+        if (res == -EAGAIN || res == -EBUSY || res == -EINTR || !deferred_.empty()) {
+            schedule_flush();
+        }
+    }
+
+    void
+    schedule_flush()
+    {
+        if (!flush_scheduled_ && !dispatching_) {
+            flush_scheduled_ = true;
+            io_service_.post([this](){ flush(); });
+        }
+    }
+
+    /**
+     * @return Submission entry or nullptr if the queue is still full after
+     *         passing the queued entries to the kernel
+     */
+    ::io_uring_sqe*
+    get_sqe(unsigned count = 1)
+    {
+        if (ring_.space() < count)
+            ring_.submit();
+        return ring_.get_sqe();
+    }
+
+    /**
+     * Retry an operation that didn't get a submission entry on the next flush
+     */
+    void
+    defer(::std::function< void() > op)
+    {
+        deferred_.push_back(::std::move(op));
+        schedule_flush();
+    }
+
+    void
+    post(handler_list& done)
+    {
+        for (auto& h : done) {
+            io_service_.post(::std::move(h));
+        }
+    }
+    //@}
+
+    //@{
+    /** @name Receive */
+    void
+    async_receive(stream_ptr const& s, asio_ns::mutable_buffer buffer,
+            asio_config::asio_rw_callback cb)
+    {
+        handler_list done;
+        {
+            ::std::lock_guard< ::std::mutex > lock{mtx_};
+            if (s->closed || !enabled_) {
+                done.push_back([cb](){
+                    cb(asio_config::make_error_code(asio_config::error::operation_aborted), 0);
+                });
+            } else {
+                if (s->read_cb)
+                    throw errors::logic_error("Read operation is already in progress");
+                s->read_buffer  = buffer;
+                s->read_cb      = ::std::move(cb);
+                deliver(s, done);
+            }
+        }
+        post(done);
+    }
+
+    void
+    arm_recv(stream_ptr const& s)
+    {
+        auto sqe = get_sqe();
+        if (!sqe) {
+            defer([this, s]()
+                {
+                    if (s->read_cb && !s->recv_armed && !s->starved && !s->closed)
+                        arm_recv(s);
+                });
+            return;
+        }
+        auto op = new recv_operation{s};
+        ops_.insert(op);
+        sqe->opcode     = IORING_OP_RECV;
+        sqe->fd         = s->fd;
+        sqe->flags      = IOSQE_BUFFER_SELECT;
+        sqe->buf_group  = buffer_group;
+        if (multishot_) {
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+        } else {
+            sqe->len    = recv_buffer_size;
+        }
+        sqe->user_data  = reinterpret_cast< ::std::uint64_t >(op);
+        s->recv_op          = op;
+        s->recv_armed       = true;
+        s->recv_cancelled   = false;
+        schedule_flush();
+    }
+
+    /**
+     * Stop the multishot receive of a stream that has nobody reading it.
+     * Otherwise the receive keeps taking buffers from the pool shared by
+     * all streams and the peer is never throttled by the socket buffer.
+     */
+    void
+    cancel_recv(stream_ptr const& s)
+    {
+        if (!s->recv_armed || s->recv_cancelled)
+            return;
+        auto sqe = get_sqe();
+        if (!sqe) {
+            defer([this, s]()
+                {
+                    if (s->closed || !s->read_cb)
+                        cancel_recv(s);
+                });
+            return;
+        }
+        sqe->opcode     = IORING_OP_ASYNC_CANCEL;
+        sqe->addr       = reinterpret_cast< ::std::uint64_t >(s->recv_op);
+        s->recv_cancelled = true;
+        schedule_flush();
+    }
+
+    bool
+    handle_recv(stream_ptr const& s, int res, unsigned flags, handler_list& done)
+    {
+        bool more = flags & IORING_CQE_F_MORE;
+        if (flags & IORING_CQE_F_BUFFER) {
+            unsigned short bid = flags >> IORING_CQE_BUFFER_SHIFT;
+            if (res > 0 && !s->closed) {
+                s->received.push_back(stream::chunk{ bid, 0, static_cast<unsigned>(res) });
+            } else {
+                provide_buffer(bid);
+            }
+        }
+        if (res == 0) {
+            s->eof = true;
+        } else if (res < 0) {
+            if (res == -ENOBUFS) {
+                // Wait for a buffer to be returned to the pool
+                s->starved = true;
+                starved_.push_back(s);
+            } else if (res == -EINVAL && multishot_) {
+                // Kernel without multishot receive
+                multishot_ = false;
+            } else if (res != -ECANCELED) {
+                s->error = make_error(-res);
+            }
+        }
+        if (!more) {
+            s->recv_armed       = false;
+            s->recv_cancelled   = false;
+            s->recv_op          = nullptr;
+        }
+        deliver(s, done);
+        if (more && !s->read_cb && !s->received.empty())
+            cancel_recv(s);
+        return more;
+    }
+
+    void
+    deliver(stream_ptr const& s, handler_list& done)
+    {
+        if (!s->read_cb)
+            return;
+        if (!s->received.empty()) {
+            auto dst = asio_ns::buffer_cast< char* >(s->read_buffer);
+            auto space = asio_ns::buffer_size(s->read_buffer);
+            ::std::size_t n = 0;
+            while (space > 0 && !s->received.empty()) {
+                auto& c = s->received.front();
+                auto sz = ::std::min< ::std::size_t >(space, c.size - c.offset);
+                ::std::memcpy(dst + n,
+                        buffers_.data() + c.bid * recv_buffer_size + c.offset, sz);
+                n += sz;
+                space -= sz;
+                c.offset += sz;
+                if (c.offset == c.size) {
+                    provide_buffer(c.bid);
+                    s->received.pop_front();
+                }
+            }
+            auto cb = ::std::move(s->read_cb);
+            s->read_cb = nullptr;
+            done.push_back([cb, n](){ cb(asio_config::error_code{}, n); });
+        } else if (s->error || s->eof) {
+            auto ec = s->error ? s->error :
+                    asio_config::make_error_code(asio_config::error::eof);
+            auto cb = ::std::move(s->read_cb);
+            s->read_cb = nullptr;
+            done.push_back([cb, ec](){ cb(ec, 0); });
+        } else if (!s->recv_armed && !s->starved && !s->closed) {
+            arm_recv(s);
+        }
+    }
+
+    void
+    provide_buffer(unsigned short bid)
+    {
+        if (!enabled_)
+            return;
+        auto sqe = get_sqe();
+        if (!sqe) {
+            defer([this, bid](){ provide_buffer(bid); });
+            return;
+        }
+        sqe->opcode     = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd         = 1;
+        sqe->addr       = reinterpret_cast< ::std::uint64_t >(
+                buffers_.data() + bid * recv_buffer_size);
+        sqe->len        = recv_buffer_size;
+        sqe->off        = bid;
+        sqe->buf_group  = buffer_group;
+        schedule_flush();
+        while (!starved_.empty()) {
+            auto s = starved_.front();
+            starved_.pop_front();
+            s->starved = false;
+            if (s->read_cb && !s->recv_armed && !s->closed) {
+                arm_recv(s);
+                break;
+            }
+        }
+    }
+    //@}
+
+    //@{
+    /** @name Send */
+    void
+    async_send(stream_ptr const& s, buffer_list&& buffers, asio_config::asio_rw_callback cb)
+    {
+        handler_list done;
+        {
+            ::std::lock_guard< ::std::mutex > lock{mtx_};
+            if (s->closed || !enabled_) {
+                done.push_back([cb](){
+                    cb(asio_config::make_error_code(asio_config::error::operation_aborted), 0);
+                });
+            } else {
+                s->send_queue.push_back(stream::message{ ::std::move(buffers), ::std::move(cb) });
+                if (s->sends_in_flight == 0)
+                    submit_sends(s);
+            }
+        }
+        post(done);
+    }
+
+    /**
+     * Submit queued messages as a linked chain, so that they are written
+     * in order without waiting for each other's completions.
+     */
+    void
+    submit_sends(stream_ptr const& s)
+    {
+        unsigned n = ::std::min< ::std::size_t >(s->send_queue.size(), max_send_chain);
+        if (ring_.space() < n)
+            ring_.submit();
+        // Entries of a chain must not be split by a submit
+        n = ::std::min(n, ring_.space());
+        if (n == 0) {
+            defer([this, s]()
+                {
+                    if (s->sends_in_flight == 0 && !s->send_queue.empty() && !s->closed)
+                        submit_sends(s);
+                });
+            return;
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            auto op = new send_operation{ s, ::std::move(s->send_queue.front()) };
+            s->send_queue.pop_front();
+            ops_.insert(op);
+            auto sqe = ring_.get_sqe();
+            sqe->opcode     = IORING_OP_SENDMSG;
+            sqe->fd         = s->fd;
+            sqe->addr       = reinterpret_cast< ::std::uint64_t >(&op->msg);
+            sqe->len        = 1;
+            sqe->msg_flags  = MSG_NOSIGNAL | MSG_WAITALL;
+            if (i + 1 < n)
+                sqe->flags  = IOSQE_IO_LINK;
+            sqe->user_data  = reinterpret_cast< ::std::uint64_t >(op);
+            ++s->sends_in_flight;
+        }
+        schedule_flush();
+    }
+
+    void
+    handle_send(send_operation& op, int res, handler_list& done)
+    {
+        auto& s = op.stream;
+        --s->sends_in_flight;
+        asio_config::error_code ec;
+        ::std::size_t bytes = op.size;
+        if (res < 0) {
+            ec = make_error(-res);
+            bytes = 0;
+        } else if (static_cast< ::std::size_t >(res) < op.size) {
+            ec = asio_config::make_error_code(asio_config::error::broken_pipe);
+            bytes = res;
+        }
+        if (op.cb) {
+            auto cb = ::std::move(op.cb);
+            done.push_back([cb, ec, bytes](){ cb(ec, bytes); });
+        }
+        if (s->sends_in_flight == 0 && !s->send_queue.empty() && !s->closed)
+            submit_sends(s);
+    }
+    //@}
+
+    void
+    close(stream_ptr const& s)
+    {
+        handler_list done;
+        {
+            ::std::lock_guard< ::std::mutex > lock{mtx_};
+            if (s->closed)
+                return;
+            s->closed = true;
+            if (enabled_ && (s->recv_armed || s->sends_in_flight > 0)) {
+                auto sqe = get_sqe();
+                if (sqe) {
+                    sqe->opcode     = IORING_OP_ASYNC_CANCEL;
+#ifdef IORING_ASYNC_CANCEL_FD
+                    sqe->fd             = s->fd;
+                    sqe->cancel_flags   = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+#else
+                    sqe->addr       = reinterpret_cast< ::std::uint64_t >(s->recv_op);
+#endif
+                } else if (s->recv_armed) {
+                    // The descriptor can be reused by the time the cancel
+                    // gets an entry, cancel by the operation instead
+                    s->recv_cancelled = false;
+                    cancel_recv(s);
+                }
+            }
+            auto ec = asio_config::make_error_code(asio_config::error::operation_aborted);
+            if (s->read_cb) {
+                auto cb = ::std::move(s->read_cb);
+                s->read_cb = nullptr;
+                done.push_back([cb, ec](){ cb(ec, 0); });
+            }
+            for (auto& m : s->send_queue) {
+                auto cb = ::std::move(m.cb);
+                done.push_back([cb, ec](){ cb(ec, 0); });
+            }
+            s->send_queue.clear();
+            for (auto const& c : s->received) {
+                provide_buffer(c.bid);
+            }
+            s->received.clear();
+            // The socket descriptor is closed right after, the cancel
+            // request must not wait for the flush
+            if (enabled_)
+                ring_.submit();
+        }
+        post(done);
+    }
+
+    asio_ns::io_service&                    io_service_;
+    ring                                    ring_;
+    asio_ns::posix::stream_descriptor       wakeup_;
+    ::std::uint64_t                         wake_counter_       = 0;
+    ::std::vector< char >                   buffers_;
+
+    ::std::mutex                            mtx_;
+    ::std::unordered_set< operation* >      ops_;
+    ::std::deque< stream_ptr >              starved_;
+    deferred_list                           deferred_;
+    ::std::atomic< bool >                   enabled_{false};
+    bool                                    multishot_          = true;
+    bool                                    flush_scheduled_    = false;
+    bool                                    dispatching_        = false;
+};
+
+uring_service::uring_service(asio_ns::io_service& owner)
+    : asio_ns::io_service::service{owner}, pimpl_{ new impl{owner} }
+{
+}
+
+uring_service::~uring_service()
+{
+}
+
+void
+uring_service::shutdown_service()
+{
+    pimpl_->stop();
+}
+
+bool
+uring_service::supported()
+{
+    static bool const result = []()
+        {
+            ring r;
+            return r.setup(8) == 0 && probe_ops(r);
+        }();
+    return result;
+}
+
+uring_service*
+uring_service::enable(asio_ns::io_service& svc)
+{
+    if (!supported())
+        return nullptr;
+    auto& service = asio_ns::use_service< uring_service >(svc);
+    if (!service.enabled() && !service.pimpl_->start(default_entries))
+        return nullptr;
+    return &service;
+}
+
+uring_service*
+uring_service::get(asio_ns::io_service& svc)
+{
+    if (!asio_ns::has_service< uring_service >(svc))
+        return nullptr;
+    auto& service = asio_ns::use_service< uring_service >(svc);
+    return service.enabled() ? &service : nullptr;
+}
+
+bool
+uring_service::enabled() const
+{
+    return pimpl_->enabled_;
+}
+
+uring_service::stream_ptr
+uring_service::open(int fd)
+{
+    return ::std::make_shared< stream >(fd);
+}
+
+void
+uring_service::close(stream_ptr const& s)
+{
+    pimpl_->close(s);
+}
+
+void
+uring_service::async_receive(stream_ptr const& s, asio_ns::mutable_buffer buffer,
+        asio_config::asio_rw_callback cb)
+{
+    pimpl_->async_receive(s, buffer, ::std::move(cb));
+}
+
+void
+uring_service::async_send(stream_ptr const& s, buffer_list&& buffers,
+        asio_config::asio_rw_callback cb)
+{
+    pimpl_->async_send(s, ::std::move(buffers), ::std::move(cb));
+}
+
+#else
+//----------------------------------------------------------------------------
+//    No io_uring on the platform
+//----------------------------------------------------------------------------
+class uring_service::stream {};
+
+struct uring_service::impl {};
+
+uring_service::uring_service(asio_ns::io_service& owner)
+    : asio_ns::io_service::service{owner}
+{
+}
+
+uring_service::~uring_service()
+{
+}
+
+void
+uring_service::shutdown_service()
+{
+}
+
+bool
+uring_service::supported()
+{
+    return false;
+}
+
+uring_service*
+uring_service::enable(asio_ns::io_service&)
+{
+    return nullptr;
+}
+
+uring_service*
+uring_service::get(asio_ns::io_service&)
+{
+    return nullptr;
+}
+
+bool
+uring_service::enabled() const
+{
+    return false;
+}
+
+uring_service::stream_ptr
+uring_service::open(int)
+{
+    throw errors::logic_error("io_uring is not supported");
+}
+
+void
+uring_service::close(stream_ptr const&)
+{
+}
+
+void
+uring_service::async_receive(stream_ptr const&, asio_ns::mutable_buffer,
+        asio_config::asio_rw_callback)
+{
+    throw errors::logic_error("io_uring is not supported");
+}
+
+void
+uring_service::async_send(stream_ptr const&, buffer_list&&,
+        asio_config::asio_rw_callback)
+{
+    throw errors::logic_error("io_uring is not supported");
+}
+#endif /* WIRE_HAS_IO_URING */
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
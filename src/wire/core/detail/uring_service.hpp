@@ -0,0 +1,113 @@
+/*
+ * uring_service.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_URING_SERVICE_HPP_
+#define WIRE_CORE_DETAIL_URING_SERVICE_HPP_
+
+#include <wire/asio_config.hpp>
+
+#include <memory>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WIRE_HAS_IO_URING 1
+#endif
+#endif
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * io_uring backend for stream sockets.
+ *
+ * The service is attached to an io_service and is switched on by the
+ * connector. Completions are reaped in the io_service threads when the
+ * ring's eventfd becomes readable, submissions made while handling
+ * completions or in the same handler turn are sent to the kernel with a
+ * single io_uring_enter call.
+ *
+ * Receives use multishot recv with buffers provided from a pool owned by
+ * the service. The receive is cancelled when data arrives for a stream that
+ * has no read pending, so a stream that stopped reading doesn't take the
+ * pool from the others. Sends for a socket queued while a previous send is
+ * in flight are submitted as a linked chain.
+ */
+class uring_service : public asio_ns::io_service::service {
+public:
+    static asio_ns::io_service::id id;
+
+    static constexpr unsigned       default_entries     = 256;
+    static constexpr ::std::size_t  recv_buffer_size    = asio_config::incoming_buffer_size;
+    static constexpr ::std::size_t  recv_buffer_count   = 256;
+
+    using buffer_list   = ::std::vector< asio_ns::const_buffer >;
+    class stream;
+    using stream_ptr    = ::std::shared_ptr< stream >;
+public:
+    uring_service(asio_ns::io_service& owner);
+    virtual ~uring_service();
+
+    void
+    shutdown_service() override;
+
+    /**
+     * Check if the running kernel supports the operations required
+     */
+    static bool
+    supported();
+    /**
+     * Switch on the io_uring backend for the io_service.
+     * @return Service or nullptr if io_uring is not available
+     */
+    static uring_service*
+    enable(asio_ns::io_service&);
+    /**
+     * @return Service if it was enabled for the io_service, nullptr otherwise
+     */
+    static uring_service*
+    get(asio_ns::io_service&);
+
+    bool
+    enabled() const;
+
+    /**
+     * Start using the ring for a connected socket. The socket must be kept
+     * open until the stream is closed.
+     */
+    stream_ptr
+    open(int fd);
+    /**
+     * Cancel all operations on the stream, pending handlers are called
+     * with operation_aborted
+     */
+    void
+    close(stream_ptr const&);
+
+    /**
+     * Read some data, the handler is called when at least one byte is read
+     */
+    void
+    async_receive(stream_ptr const&, asio_ns::mutable_buffer,
+            asio_config::asio_rw_callback);
+    /**
+     * Write all buffers, the handler is called when all data is sent
+     */
+    void
+    async_send(stream_ptr const&, buffer_list&&, asio_config::asio_rw_callback);
+private:
+    struct impl;
+    using pimpl = ::std::unique_ptr<impl>;
+    pimpl pimpl_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_URING_SERVICE_HPP_ */
@@ -0,0 +1,61 @@
+/*
+ * write_aggregator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <wire/core/detail/write_aggregator.hpp>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+constexpr ::std::size_t record_buffer_pool::record_size;
+constexpr ::std::size_t record_buffer_pool::max_free;
+
+record_buffer_pool&
+record_buffer_pool::instance()
+{
+    static record_buffer_pool pool_;
+    return pool_;
+}
+
+record_buffer_pool::buffer_ptr
+record_buffer_pool::acquire()
+{
+    {
+        lock_guard lock{mtx_};
+        if (!free_.empty()) {
+            auto buff = ::std::move(free_.back());
+            free_.pop_back();
+            return buff;
+        }
+    }
+    buffer_ptr buff{ new buffer_type{} };
+    buff->reserve(record_size);
+    return buff;
+}
+
+void
+record_buffer_pool::release(buffer_ptr buff)
+{
+    if (!buff)
+        return;
+    buff->clear();
+    lock_guard lock{mtx_};
+    if (free_.size() < max_free) {
+        free_.push_back(::std::move(buff));
+    }
+}
+
+::std::size_t
+record_buffer_pool::free_buffers() const
+{
+    lock_guard lock{mtx_};
+    return free_.size();
+}
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,193 @@
+/*
+ * write_aggregator.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#ifndef WIRE_CORE_DETAIL_WRITE_AGGREGATOR_HPP_
+#define WIRE_CORE_DETAIL_WRITE_AGGREGATOR_HPP_
+
+#include <wire/asio_config.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+
+/**
+ * Pool of buffers sized to the maximum TLS plaintext record
+ */
+class record_buffer_pool {
+public:
+    static constexpr ::std::size_t record_size  = 16 * 1024;
+    static constexpr ::std::size_t max_free     = 256;
+
+    using buffer_type   = ::std::vector< unsigned char >;
+    using buffer_ptr    = ::std::unique_ptr< buffer_type >;
+public:
+    static record_buffer_pool&
+    instance();
+
+    /**
+     * Get an empty buffer with record_size capacity
+     */
+    buffer_ptr
+    acquire();
+    void
+    release(buffer_ptr);
+
+    ::std::size_t
+    free_buffers() const;
+private:
+    record_buffer_pool() = default;
+private:
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+
+    mutable mutex_type          mtx_;
+    ::std::vector<buffer_ptr>   free_;
+};
+
+/**
+ * Packs outgoing messages into record-sized buffers.
+ *
+ * The SSL stream encrypts each buffer of a sequence separately, so a message
+ * consisting of many small chunks produces many small records. The aggregator
+ * copies the data into buffers of the maximum record size and writes them
+ * in one operation. Messages appended before a flush share records.
+ *
+ * The connection serializes writes, so at most one flush is in progress.
+ * A failed write closes the transport and fails all subsequent writes.
+ */
+template < typename Transport >
+class write_aggregator {
+public:
+    using transport_type    = Transport;
+    using buffer_ptr        = record_buffer_pool::buffer_ptr;
+public:
+    explicit
+    write_aggregator(transport_type& transport)
+        : transport_(transport)
+    {
+    }
+    ~write_aggregator()
+    {
+        release(batch_);
+        release(in_flight_);
+    }
+
+    /**
+     * Append a buffer sequence to the next write.
+     * @param buffers Data, it is copied before the function returns
+     * @return Size of the data
+     */
+    template < typename BufferSequence >
+    ::std::size_t
+    append(BufferSequence const& buffers)
+    {
+        ::std::size_t bytes = 0;
+        for (auto const& b : buffers) {
+            auto data = asio_ns::buffer_cast< unsigned char const* >(b);
+            auto size = asio_ns::buffer_size(b);
+            bytes += size;
+            while (size > 0) {
+                if (batch_.empty() ||
+                        batch_.back()->size() == record_buffer_pool::record_size) {
+                    batch_.push_back(record_buffer_pool::instance().acquire());
+                }
+                auto& chunk = *batch_.back();
+                auto n = ::std::min(size, record_buffer_pool::record_size - chunk.size());
+                chunk.insert(chunk.end(), data, data + n);
+                data += n;
+                size -= n;
+            }
+        }
+        batch_bytes_ += bytes;
+        return bytes;
+    }
+
+    /**
+     * Write the appended data.
+     * @param cb Callback, called with the size of the appended data when
+     *      the write finishes
+     * @param owner Object to keep alive while the write operation is pending
+     */
+    void
+    flush(asio_config::asio_rw_callback cb, ::std::shared_ptr<void> owner)
+    {
+        ::std::size_t bytes = batch_bytes_;
+        batch_bytes_ = 0;
+        if (error_) {
+            release(batch_);
+            if (cb) cb(error_, 0);
+            return;
+        }
+        in_flight_.swap(batch_);
+        flight_buffers_.clear();
+        for (auto const& c : in_flight_) {
+            flight_buffers_.push_back(asio_ns::buffer(*c));
+        }
+        transport_.async_write(flight_buffers_,
+            [this, cb, bytes, owner](asio_config::error_code const& ec, ::std::size_t)
+            {
+                handle_flush(ec, bytes, cb);
+            });
+    }
+
+    /**
+     * Write a buffer sequence.
+     * @param buffers Data, it is copied before the function returns
+     * @param cb Callback, called with the data size
+     * @param owner Object to keep alive while the write operation is pending
+     */
+    template < typename BufferSequence >
+    void
+    write(BufferSequence const& buffers, asio_config::asio_rw_callback cb,
+            ::std::shared_ptr<void> owner)
+    {
+        append(buffers);
+        flush(::std::move(cb), ::std::move(owner));
+    }
+private:
+    using chunk_list        = ::std::vector< buffer_ptr >;
+    using asio_buffers      = ::std::vector< asio_ns::const_buffer >;
+
+    void
+    handle_flush(asio_config::error_code const& ec, ::std::size_t bytes,
+            asio_config::asio_rw_callback const& cb)
+    {
+        release(in_flight_);
+        if (ec) {
+            error_ = ec;
+            transport_.close();
+        }
+        if (cb) cb(ec, ec ? 0 : bytes);
+    }
+
+    void
+    release(chunk_list& chunks)
+    {
+        for (auto& c : chunks) {
+            record_buffer_pool::instance().release(::std::move(c));
+        }
+        chunks.clear();
+    }
+private:
+    transport_type&         transport_;
+
+    asio_config::error_code error_;
+    chunk_list              batch_;
+    ::std::size_t           batch_bytes_    = 0;
+    chunk_list              in_flight_;
+    asio_buffers            flight_buffers_;
+};
+
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
+
+#endif /* WIRE_CORE_DETAIL_WRITE_AGGREGATOR_HPP_ */
@@ -33,6 +33,14 @@ static_assert(
 static_assert(
     encoding::detail::wire_type< socket_endpoint_data >::value == encoding::detail::STRUCT,
     "Wire type for socket endpoint data is STRUCT");
+
+static_assert(
+    encoding::detail::wire_type< shm_endpoint_data >::value == encoding::detail::STRUCT,
+    "Wire type for shm endpoint data is STRUCT");
+
+static_assert(
+    encoding::detail::wire_type< inproc_endpoint_data >::value == encoding::detail::STRUCT,
+    "Wire type for inproc endpoint data is STRUCT");
 }  // namespace detail
 
 static_assert(
@@ -47,6 +55,8 @@ namespace {
         { transport_type::ssl, "ssl" },
         { transport_type::udp, "udp" },
         { transport_type::socket, "socket" },
+        { transport_type::shm, "shm" },
+        { transport_type::inproc, "inproc" },
     }; // TRANSPORT_TYPE_TO_STRING
     const std::map< std::string, transport_type > STRING_TO_TRANSPORT_TYPE {
         { "empty", transport_type::empty },
@@ -54,6 +64,8 @@ namespace {
         { "ssl", transport_type::ssl },
         { "udp", transport_type::udp },
         { "socket", transport_type::socket },
+        { "shm", transport_type::shm },
+        { "inproc", transport_type::inproc },
     }; // STRING_TO_TRANSPORT_TYPE
 } // namespace
 
@@ -393,6 +405,16 @@ struct collect_published_endpoints : boost::static_visitor<> {
     {
         endpoints.emplace_back( data );
     }
+    void
+    operator()( shm_endpoint_data const& data ) const
+    {
+        endpoints.emplace_back( data );
+    }
+    void
+    operator()( inproc_endpoint_data const& data ) const
+    {
+        endpoints.emplace_back( data );
+    }
 };
 
 }  // namespace detail
@@ -450,6 +472,16 @@ endpoint::socket(std::string const& path)
 {
     return endpoint{ detail::socket_endpoint_data{ path } };
 }
+endpoint
+endpoint::shm(std::string const& path)
+{
+    return endpoint{ detail::shm_endpoint_data{ path } };
+}
+endpoint
+endpoint::inproc(std::string const& name)
+{
+    return endpoint{ detail::inproc_endpoint_data{ name } };
+}
 
 std::ostream&
 operator << (std::ostream& os, endpoint const& val)
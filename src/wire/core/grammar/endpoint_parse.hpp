@@ -83,6 +83,8 @@ struct transport_type_grammar :
             ("ssl",        transport_type::ssl)
             ("udp",        transport_type::udp)
             ("socket",    transport_type::socket)
+            ("shm",       transport_type::shm)
+            ("inproc",    transport_type::inproc)
         ;
     }
 };
@@ -114,11 +116,11 @@ struct ip_endpoint_data_grammar :
     parser_value_rule< InputIterator, uint16_t >                    port;
 };
 
-template < typename InputIterator >
-struct socket_endpoint_grammar :
-        parser_value_grammar< InputIterator, detail::socket_endpoint_data > {
-    using value_type = detail::socket_endpoint_data;
-    socket_endpoint_grammar() : socket_endpoint_grammar::base_type(main_rule)
+template < typename InputIterator, typename OutType >
+struct path_endpoint_grammar :
+        parser_value_grammar< InputIterator, OutType > {
+    using value_type = OutType;
+    path_endpoint_grammar() : path_endpoint_grammar::base_type(main_rule)
     {
         namespace qi = boost::spirit::qi;
         namespace phx = boost::phoenix;
@@ -135,6 +137,36 @@ struct socket_endpoint_grammar :
     tip::iri::grammar::parse::isegment_grammar<InputIterator>       isegment;
 };
 
+template < typename InputIterator >
+using socket_endpoint_grammar
+        = path_endpoint_grammar< InputIterator, detail::socket_endpoint_data >;
+template < typename InputIterator >
+using shm_endpoint_grammar
+        = path_endpoint_grammar< InputIterator, detail::shm_endpoint_data >;
+
+/**
+ * In-process endpoint name, a relative path
+ */
+template < typename InputIterator >
+struct inproc_endpoint_grammar :
+        parser_value_grammar< InputIterator, detail::inproc_endpoint_data > {
+    using value_type = detail::inproc_endpoint_data;
+    inproc_endpoint_grammar() : inproc_endpoint_grammar::base_type(main_rule)
+    {
+        namespace qi = boost::spirit::qi;
+        namespace phx = boost::phoenix;
+        using qi::char_;
+        using qi::_val;
+        using qi::_1;
+        name_str %= isegment_nz >> *(char_("/") >> isegment);
+        main_rule = name_str [ phx::bind( &value_type::path, _val ) = _1 ];
+    }
+    parser_value_rule< InputIterator, value_type>                   main_rule;
+    parser_value_rule< InputIterator, std::string >                 name_str;
+    tip::iri::grammar::parse::isegment_nz_grammar<InputIterator>    isegment_nz;
+    tip::iri::grammar::parse::isegment_grammar<InputIterator>       isegment;
+};
+
 template < typename InputIterator >
 struct endpoint_grammar :
         parser_value_grammar< InputIterator, endpoint > {
@@ -147,6 +179,8 @@ struct endpoint_grammar :
                 |    ( lit("ssl://") >> ssl_endpoint )
                 |    ( lit("udp://") >> udp_endpoint )
                 |    ( lit("socket://") >> socket_endpoint )
+                |    ( lit("shm://") >> shm_endpoint )
+                |    ( lit("inproc://") >> inproc_endpoint )
         ;
     }
     parser_value_rule< InputIterator, value_type >  root;
@@ -157,6 +191,8 @@ struct endpoint_grammar :
     ip_endpoint_data_grammar< InputIterator,
         detail::udp_endpoint_data >                 udp_endpoint;
     socket_endpoint_grammar< InputIterator >        socket_endpoint;
+    shm_endpoint_grammar< InputIterator >           shm_endpoint;
+    inproc_endpoint_grammar< InputIterator >        inproc_endpoint;
 };
 
 template < typename InputIterator, typename EndpointContainer >
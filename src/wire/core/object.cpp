@@ -84,7 +84,7 @@ object::__wire_is_a(detail::dispatch_request const& req, current const& c)
     decltype(b) e = req.encaps_end;
     encoding::read(b, e, arg);
     req.encaps_start.incoming_encapsulation().read_indirection_table(b);
-    encoding::outgoing out{ req.buffer->get_connector() };
+    encoding::outgoing out{ req.reply_writer() };
     encoding::write(std::back_inserter(out), wire_is_a(arg, c));
     req.result(std::move(out));
 }
@@ -100,7 +100,7 @@ object::__wire_ping(detail::dispatch_request const& req, current const& c)
 void
 object::__wire_type(detail::dispatch_request const& req, current const& c)
 {
-    encoding::outgoing out{ req.buffer->get_connector() };
+    encoding::outgoing out{ req.reply_writer() };
     encoding::write(std::back_inserter(out), wire_type(c));
     req.result(std::move(out));
 }
@@ -108,7 +108,7 @@ object::__wire_type(detail::dispatch_request const& req, current const& c)
 void
 object::__wire_types(detail::dispatch_request const& req, current const& c)
 {
-    encoding::outgoing out{ req.buffer->get_connector() };
+    encoding::outgoing out{ req.reply_writer() };
     encoding::write(std::back_inserter(out), wire_types(c));
     req.result(std::move(out));
 }
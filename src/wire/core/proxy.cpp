@@ -99,11 +99,11 @@ object_proxy::wire_is_a_async(::std::string const&  type_id,
 {
     if (opts == invocation_options::unspecified)
         opts = wire_invocation_options();
-    make_invocation(wire_get_reference(),
+    invoke_operation(wire_get_reference(),
             WIRE_CORE_OBJECT_wire_is_a_hash, ctx,
             &object::wire_is_a,
-            response, exception, sent,
-            type_id)(opts);
+            response, exception, sent, opts,
+            type_id);
 }
 
 void
@@ -116,10 +116,10 @@ object_proxy::wire_ping_async(
 {
     if (opts == invocation_options::unspecified)
         opts = wire_invocation_options();
-    make_invocation(wire_get_reference(),
+    invoke_operation(wire_get_reference(),
             WIRE_CORE_OBJECT_wire_ping_hash, ctx,
             &object::wire_ping,
-            response, exception, sent)(opts);
+            response, exception, sent, opts);
 }
 
 void
@@ -132,10 +132,10 @@ object_proxy::wire_type_async(
 {
     if (opts == invocation_options::unspecified)
         opts = wire_invocation_options();
-    make_invocation(wire_get_reference(),
+    invoke_operation(wire_get_reference(),
             WIRE_CORE_OBJECT_wire_type_hash, ctx,
             &object::wire_type,
-            response, exception, sent)(opts);
+            response, exception, sent, opts);
 }
 
 void
@@ -148,10 +148,10 @@ object_proxy::wire_types_async(
 {
     if (opts == invocation_options::unspecified)
         opts = wire_invocation_options();
-    make_invocation(wire_get_reference(),
+    invoke_operation(wire_get_reference(),
             WIRE_CORE_OBJECT_wire_types_hash, ctx,
             &object::wire_types,
-            response, exception, sent)(opts);
+            response, exception, sent, opts);
 }
 
 object_prx
@@ -12,6 +12,8 @@
 
 #include <wire/core/connector.hpp>
 #include <wire/core/locator.hpp>
+#include <wire/core/detail/configuration_options.hpp>
+#include <wire/core/detail/staggered_connect.hpp>
 
 #include <wire/util/io_service_wait.hpp>
 #include <wire/util/scheduled_task.hpp>
@@ -86,7 +88,8 @@ reference::create_reference(connector_ptr cnctr, reference_data const& ref_data)
 bool
 reference::is_local() const
 {
-    if (local_object_cache_.lock())
+    auto entry = local_cache_.get();
+    if (entry && !entry->object.expired())
         return true;
     return get_connector()->is_local(*this);
 }
@@ -94,14 +97,55 @@ reference::is_local() const
 reference::local_servant
 reference::get_local_object() const
 {
-    auto obj = local_object_cache_.lock();
+    if (auto entry = local_cache_.get()) {
+        auto obj = entry->object.lock();
+        if (obj)
+            return {obj, entry->adapter.lock()};
+    }
+    auto loc_srv = get_connector()->find_local_servant(*this);
+    if (loc_srv.first)
+        local_cache_.set(loc_srv.first, loc_srv.second, nullptr, nullptr);
+    return loc_srv;
+}
+
+void*
+reference::get_local_target(object_ptr& obj, adapter_ptr& adapter,
+        ::std::type_info const& type, servant_cast cast) const
+{
+    if (auto entry = local_cache_.get()) {
+        obj = entry->object.lock();
+        if (obj) {
+            adapter = entry->adapter.lock();
+            if (entry->servant_type == &type)
+                return entry->servant;
+        }
+    }
     if (!obj) {
         auto loc_srv = get_connector()->find_local_servant(*this);
-        obj = loc_srv.first;
-        local_object_cache_ = obj;
-        adapter_cache_      = loc_srv.second;
+        obj     = ::std::move(loc_srv.first);
+        adapter = ::std::move(loc_srv.second);
+        if (!obj)
+            return nullptr;
+    }
+    void* srv = cast(obj);
+    local_cache_.set(obj, adapter, srv, &type);
+    return srv;
+}
+
+void
+reference::local_cache::set(object_ptr const& obj, adapter_ptr const& adapter,
+        void* servant, ::std::type_info const* type)
+{
+    lock_guard lock{mutex};
+    for (auto const& e : entries) {
+        if (e.servant_type == type && !e.object.owner_before(obj)
+                && !obj.owner_before(e.object)) {
+            current.store(&e, ::std::memory_order_release);
+            return;
+        }
     }
-    return {obj, adapter_cache_.lock()};
+    entries.push_back(local_entry{ obj, adapter, servant, type });
+    current.store(&entries.back(), ::std::memory_order_release);
 }
 
 connector_ptr
@@ -141,7 +185,8 @@ reference::set_locator(reference_data const& loc_ref)
 //      Fixed reference implementation
 //----------------------------------------------------------------------------
 fixed_reference::fixed_reference(connector_ptr cn, reference_data const& ref)
-    : reference{cn, ref}, current_{ref_.endpoints.end()}
+    : reference{cn, ref},
+      endpoints_{ ::std::make_shared< endpoint_rotation_type >(ref_.endpoints) }
 {
     if (ref_.endpoints.empty())
         throw errors::runtime_error{ "Reference endpoint list is empty" };
@@ -149,16 +194,27 @@ fixed_reference::fixed_reference(connector_ptr cn, reference_data const& ref)
 
 fixed_reference::fixed_reference(fixed_reference const& rhs)
     : reference{rhs},
-      connection_{rhs.connection_.lock()},
-      current_{ref_.endpoints.end()}
+      endpoints_{rhs.endpoints_}
 {
+    lock_guard lock{rhs.mutex_};
+    connection_ = rhs.connection_;
+    bulk_connection_ = rhs.bulk_connection_;
 }
 
 fixed_reference::fixed_reference(fixed_reference&& rhs)
     : reference{::std::move(rhs)},
-      connection_{rhs.connection_.lock()},
-      current_{ref_.endpoints.end()}
+      endpoints_{rhs.endpoints_}
 {
+    lock_guard lock{rhs.mutex_};
+    connection_ = rhs.connection_;
+    bulk_connection_ = rhs.bulk_connection_;
+}
+
+bool
+fixed_reference::pooled(bool bulk) const
+{
+    auto const& opts = get_connector()->options();
+    return (bulk ? opts.bulk_pool_size : opts.connection_pool_size) > 1;
 }
 
 void
@@ -167,23 +223,22 @@ fixed_reference::get_connection_async(
         functional::exception_callback  __exception,
         invocation_options const&       in_opts) const
 {
-    connection_ptr conn = connection_.lock();
-    if (!conn) {
+    bool bulk = in_opts.is_bulk();
+    connection_ptr conn;
+    endpoint ep;
+    {
+        lock_guard lock{mutex_};
+        auto const& cached = cache(bulk);
+        conn = cached.connection.lock();
+        ep = cached.ep;
+    }
+    if (conn && pooled(bulk)) {
+        // The endpoint is known, let the connector pick the least loaded
+        // connection of the pool for every invocation
+        get_connector()->get_outgoing_connection_async(
+                ep, __result, __exception, in_opts);
+    } else if (!conn) {
         connector_ptr cntr = get_connector();
-        endpoint ep;
-        {
-            lock_guard lock{mutex_};
-            conn = connection_.lock();
-            if (current_ == ref_.endpoints.end()) {
-                current_ = ref_.endpoints.begin();
-            }
-            ep = *current_++;
-        }
-        if (conn) {
-            // Connection is already there
-            functional::report_async_result(__result, conn);
-            return;
-        }
 
         auto opts = in_opts;
         if (opts.is_sync())
@@ -200,15 +255,17 @@ fixed_reference::get_connection_async(
             __exception = err;
         }
 
-        auto get_connection =
-            [_this, __result, __exception, res](connection_ptr c)
+        detail::staggered_connect::result_callback get_connection =
+            [_this, __result, __exception, res, bulk](connection_ptr c, endpoint const& ep)
             {
                 connection_ptr conn;
                 {
                     lock_guard lock{_this->mutex_};
-                    conn = _this->connection_.lock();
+                    auto& cached = _this->cache(bulk);
+                    conn = cached.connection.lock();
                     if (!conn || conn != c) {
-                        _this->connection_ = c;
+                        cached.connection = c;
+                        cached.ep = ep;
                         conn = c;
                     }
                 }
@@ -232,18 +289,25 @@ fixed_reference::get_connection_async(
                     functional::report_exception(__exception, ex);
                 };
         } else {
+            // The retried call caches the connection itself
+            connection_callback retry_result =
+                [__result, res](connection_ptr c)
+                {
+                    *res = true;
+                    __result(c);
+                };
             functional::void_callback retry_func;
             if (opts.retries == invocation_options::infinite_retries) {
                 retry_func =
-                    [_this, get_connection, __exception, opts]()
+                    [_this, retry_result, __exception, opts]()
                     {
-                        _this->get_connection_async(get_connection, __exception, opts);
+                        _this->get_connection_async(retry_result, __exception, opts);
                     };
             } else {
                 retry_func =
-                    [_this, get_connection, __exception, opts]()
+                    [_this, retry_result, __exception, opts]()
                     {
-                        _this->get_connection_async(get_connection, __exception, opts.dec_retries());
+                        _this->get_connection_async(retry_result, __exception, opts.dec_retries());
                     };
             }
             connect_error =
@@ -269,7 +333,8 @@ fixed_reference::get_connection_async(
                 };
         }
 
-        cntr->get_outgoing_connection_async(ep, get_connection, connect_error, opts);
+        // Try the endpoints in parallel with a small delay between attempts
+        detail::staggered_connect::start(cntr, endpoints_, get_connection, connect_error, opts);
         if (in_opts.is_sync()) {
             util::run_until(_this->get_connector()->io_service(), [res](){ return (bool)*res; });
         }
@@ -9,8 +9,15 @@
 #include <wire/errors/exceptions.hpp>
 
 #include <wire/core/ssl_certificate.hpp>
+#include <wire/core/detail/ssl_session_cache.hpp>
+#ifdef WIRE_HAS_SHM_TRANSPORT
+#include <wire/core/detail/shm_ring.hpp>
+#include <unistd.h>
+#endif
 
 #include <iostream>
+#include <map>
+#include <mutex>
 
 namespace wire {
 namespace core {
@@ -27,6 +34,14 @@ constexpr bool transport_type_traits< transport_type::udp >::stream_oriented;
 constexpr transport_type transport_type_traits< transport_type::socket >::value;
 constexpr bool transport_type_traits< transport_type::socket >::stream_oriented;
 
+#ifdef WIRE_HAS_SHM_TRANSPORT
+constexpr transport_type transport_type_traits< transport_type::shm >::value;
+constexpr bool transport_type_traits< transport_type::shm >::stream_oriented;
+#endif
+
+constexpr transport_type transport_type_traits< transport_type::inproc >::value;
+constexpr bool transport_type_traits< transport_type::inproc >::stream_oriented;
+
 //----------------------------------------------------------------------------
 //    Transport traits implementation
 //----------------------------------------------------------------------------
@@ -121,11 +136,41 @@ transport_type_traits< transport_type::socket >::close_acceptor(acceptor_type& a
     unlink(path.c_str());
 }
 
+#ifdef WIRE_HAS_SHM_TRANSPORT
+//----------------------------------------------------------------------------
+//    Shared memory transport traits implementation
+//----------------------------------------------------------------------------
+transport_type_traits< transport_type::shm >::endpoint_type
+transport_type_traits< transport_type::shm >::create_endpoint(
+        asio_config::io_service_ptr svc, endpoint const& ep)
+{
+    endpoint_data const& ed = ep.get< endpoint_data >();
+    return endpoint_type{ ed.path };
+}
+
+endpoint
+transport_type_traits< transport_type::shm >::get_endpoint_data(endpoint_type const& ep)
+{
+    return endpoint::shm(ep.path());
+}
+
+void
+transport_type_traits< transport_type::shm >::close_acceptor(acceptor_type& acceptor)
+{
+    auto ep = acceptor.local_endpoint();
+    auto path = ep.path();
+    acceptor.cancel();
+    acceptor.close();
+    unlink(path.c_str());
+}
+#endif /* WIRE_HAS_SHM_TRANSPORT */
+
 //----------------------------------------------------------------------------
 //    TCP transport
 //----------------------------------------------------------------------------
 tcp_transport::tcp_transport(asio_config::io_service_ptr io_svc)
-    : resolver_{*io_svc}, socket_{*io_svc}
+    : resolver_{*io_svc}, socket_{*io_svc},
+      uring_{ detail::uring_service::get(*io_svc) }
 {
 }
 
@@ -140,6 +185,7 @@ tcp_transport::connect(endpoint const& ep)
         resolver_type::iterator iter = resolver_.resolve(query);
         socket_.connect(*iter);
         socket_.set_option( socket_type::keep_alive{ true });
+        open_uring();
     } catch (std::exception const& e) {
         // FIXME connection_failed class
         ::std::cerr << "TCP connection error " << e.what() << "\n";
@@ -158,9 +204,26 @@ tcp_transport::connect_async(endpoint const& ep, asio_config::asio_callback cb)
                     std::placeholders::_1, std::placeholders::_2, cb));
 }
 
+void
+tcp_transport::start(asio_config::asio_callback cb)
+{
+    open_uring();
+    if (cb) cb(asio_config::error_code{});
+}
+
+void
+tcp_transport::open_uring()
+{
+    if (uring_)
+        uring_stream_ = uring_->open(socket_.native_handle());
+}
+
 void
 tcp_transport::close()
 {
+    if (uring_stream_) {
+        uring_->close(uring_stream_);
+    }
     if (socket_.is_open()) {
         socket_.cancel();
         socket_.close();
@@ -187,6 +250,7 @@ tcp_transport::handle_connect(asio_config::error_code const& ec,
 {
     if (!ec) {
         socket_.set_option( socket_type::keep_alive{ true });
+        open_uring();
     }
     if (cb) {
         cb(ec);
@@ -217,14 +281,50 @@ ssl_transport::create_context(detail::ssl_options const& opts)
         ctx.use_certificate_chain_file(opts.cert_file);
         ctx.use_private_key_file(opts.key_file, asio_ns::ssl::context::pem);
     }
+    if (opts.session_cache) {
+        // Sessions are stored in the connector-wide cache, the context is
+        // owned by a single connection.
+        SSL_CTX_set_session_cache_mode(ctx.native_handle(),
+                SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx.native_handle(),
+                &ssl_transport::new_session_callback);
+    }
+    if (!opts.ticket_keys.empty()) {
+        ::std::string keys = opts.ticket_keys;
+        if (SSL_CTX_set_tlsext_ticket_keys(ctx.native_handle(),
+                &keys[0], keys.size()) != 1) {
+            throw errors::runtime_error("Failed to set SSL session ticket keys");
+        }
+        static unsigned char const session_id_context[] = "wire";
+        SSL_CTX_set_session_id_context(ctx.native_handle(),
+                session_id_context, sizeof(session_id_context) - 1);
+    }
     return ctx;
 }
 
+int
+ssl_transport::transport_index()
+{
+    static int const idx = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return idx;
+}
+
+int
+ssl_transport::new_session_callback(SSL* ssl, SSL_SESSION* session)
+{
+    auto trans = static_cast<ssl_transport*>(SSL_get_ex_data(ssl, transport_index()));
+    if (!trans || !trans->session_cache_ || trans->session_key_.empty())
+        return 0;
+    trans->session_cache_->put(trans->session_key_, session);
+    // The cache has taken the reference
+    return 1;
+}
+
 ssl_transport::ssl_transport(asio_config::io_service_ptr io_svc,
         detail::ssl_options const& opts)
     : ctx_(create_context(opts)), resolver_(*io_svc), socket_(*io_svc, ctx_),
       strand_{*io_svc},
-      verify_{ opts.verify_func }
+      verify_{ opts.verify_func }, session_cache_{ opts.session_cache }
 {
     if (opts.require_peer_cert) {
         verify_mode_ = asio_ns::ssl::verify_peer
@@ -233,6 +333,10 @@ ssl_transport::ssl_transport(asio_config::io_service_ptr io_svc,
     socket_.set_verify_callback(
         std::bind(&ssl_transport::verify_certificate, this,
             std::placeholders::_1, std::placeholders::_2));
+    if (session_cache_) {
+        // Application data of SSL object is used by asio
+        SSL_set_ex_data(socket_.native_handle(), transport_index(), this);
+    }
 }
 
 bool
@@ -254,6 +358,9 @@ ssl_transport::connect_async(endpoint const& ep, asio_config::asio_callback cb)
     traits::endpoint_data const& ssl_data = ep.get< traits::endpoint_data >();
 
     socket_.set_verify_mode(verify_mode_);
+    if (session_cache_) {
+        session_key_ = ssl_data.host + ":" + ::std::to_string(ssl_data.port);
+    }
     asio_config::tcp::resolver::query query( ssl_data.host,
             std::to_string(ssl_data.port) );
     ::psst::asio::async_resolve(resolver_, query,
@@ -276,6 +383,13 @@ ssl_transport::close()
     socket_.lowest_layer().close();
 }
 
+bool
+ssl_transport::session_reused() const
+{
+    socket_type& s = const_cast<socket_type&>(socket_);
+    return SSL_session_reused(s.native_handle());
+}
+
 void
 ssl_transport::handle_resolve(asio_config::error_code const& ec,
         asio_config::tcp::resolver::iterator endpoint_iterator,
@@ -295,6 +409,12 @@ ssl_transport::handle_connect(asio_config::error_code const& ec,
         asio_config::asio_callback cb)
 {
     if (!ec) {
+        if (session_cache_ && !session_key_.empty()) {
+            if (auto session = session_cache_->get(session_key_)) {
+                SSL_set_session(socket_.native_handle(), session);
+                SSL_SESSION_free(session);
+            }
+        }
         ::psst::asio::async_handshake(socket_, asio_ns::ssl::stream_base::client,
             std::bind(&ssl_transport::handle_handshake, this,
                 std::placeholders::_1, cb));
@@ -307,6 +427,10 @@ void
 ssl_transport::handle_handshake(asio_config::error_code const& ec,
         asio_config::asio_callback cb)
 {
+    if (ec && session_cache_ && !session_key_.empty()) {
+        // Don't try to resume a session the peer didn't accept
+        session_cache_->erase(session_key_);
+    }
     if (cb) {
         cb(ec);
     }
@@ -316,7 +440,7 @@ ssl_transport::handle_handshake(asio_config::error_code const& ec,
 //    UDP transport
 //----------------------------------------------------------------------------
 udp_transport::udp_transport(asio_config::io_service_ptr io_svc)
-    : resolver_(*io_svc), socket_(*io_svc)
+    : io_service_{io_svc}, resolver_(*io_svc), socket_(*io_svc)
 {
 }
 
@@ -359,6 +483,75 @@ udp_transport::close()
     socket_.close();
 }
 
+void
+udp_transport::async_send_batch(detail::datagram_list const& datagrams,
+        asio_config::asio_rw_callback handler)
+{
+    if (!socket_.is_open()) {
+        handler(asio_config::make_error_code( asio_config::error::shut_down ), 0);
+        return;
+    }
+    send_batch(datagrams, 0, handler);
+}
+
+void
+udp_transport::send_batch(detail::datagram_list const& datagrams, ::std::size_t sent,
+        asio_config::asio_rw_callback handler)
+{
+    asio_config::error_code ec;
+    while (!ec && sent < datagrams.size()) {
+        auto n = detail::datagram_batch::send(socket_,
+                datagrams.begin() + sent, datagrams.end(), ec);
+        if (n == 0)
+            break;
+        sent += n;
+    }
+    if (ec || sent == datagrams.size()) {
+        io_service_->post(
+            [handler, ec, sent]()
+            {
+                handler(ec, sent);
+            });
+        return;
+    }
+    // Socket buffer is full, wait until it is writable
+    socket_.async_send(asio_ns::null_buffers(),
+        [this, &datagrams, sent, handler](asio_config::error_code const& ec, ::std::size_t)
+        {
+            if (ec) {
+                handler(ec, sent);
+            } else {
+                send_batch(datagrams, sent, handler);
+            }
+        });
+}
+
+void
+udp_transport::async_receive_batch(detail::datagram_batch& batch,
+        asio_config::asio_rw_callback handler)
+{
+    if (!socket_.is_open()) {
+        handler(asio_config::make_error_code( asio_config::error::shut_down ), 0);
+        return;
+    }
+    socket_.async_receive(asio_ns::null_buffers(),
+        [this, &batch, handler](asio_config::error_code const& ec, ::std::size_t)
+        {
+            if (ec) {
+                handler(ec, 0);
+                return;
+            }
+            asio_config::error_code rec;
+            auto n = batch.receive(socket_, rec);
+            if (!rec && n == 0) {
+                // Spurious wakeup
+                async_receive_batch(batch, handler);
+            } else {
+                handler(rec, n);
+            }
+        });
+}
+
 //----------------------------------------------------------------------------
 //    UDP transport listener
 //----------------------------------------------------------------------------
@@ -390,7 +583,7 @@ transport_listener< void, transport_type::udp >::local_endpoint() const
 //----------------------------------------------------------------------------
 
 socket_transport::socket_transport(asio_config::io_service_ptr io_svc)
-    : socket_(*io_svc)
+    : socket_(*io_svc), uring_{ detail::uring_service::get(*io_svc) }
 {
 }
 
@@ -405,18 +598,896 @@ socket_transport::connect_async(endpoint const& ep, asio_config::asio_callback c
                     std::placeholders::_1, cb));
 }
 
+void
+socket_transport::start(asio_config::asio_callback cb)
+{
+    open_uring();
+    if (cb) cb(asio_config::error_code{});
+}
+
+void
+socket_transport::open_uring()
+{
+    if (uring_)
+        uring_stream_ = uring_->open(socket_.native_handle());
+}
+
 void
 socket_transport::close()
 {
+    if (uring_stream_) {
+        uring_->close(uring_stream_);
+    }
     socket_.close();
 }
 
 void
 socket_transport::handle_connect(asio_config::error_code const& ec, asio_config::asio_callback cb)
 {
+    if (!ec) {
+        open_uring();
+    }
     if (cb) cb(ec);
 }
 #endif /* BOOST_ASIO_HAS_LOCAL_SOCKETS */
 
+#ifdef WIRE_HAS_SHM_TRANSPORT
+//----------------------------------------------------------------------------
+//    Shared memory transport
+//----------------------------------------------------------------------------
+namespace {
+
+inline void
+cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+}  /* namespace  */
+
+struct shm_transport::impl : ::std::enable_shared_from_this<impl> {
+    using side_type     = detail::shm_segment::side;
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+
+    static constexpr unsigned min_spin = 16;
+    static constexpr unsigned max_spin = 4096;
+
+    struct pending_read {
+        asio_ns::mutable_buffer         buffer;
+        asio_config::asio_rw_callback   cb;
+    };
+    struct pending_write {
+        buffer_list                     buffers;
+        ::std::size_t                   total;
+        ::std::size_t                   written;
+        asio_config::asio_rw_callback   cb;
+    };
+
+    impl(asio_config::io_service_ptr svc)
+        : io_service_{svc}, socket_{*svc}, wakeup_{*svc}
+    {
+    }
+
+    //@{
+    /** @name Connection setup */
+    void
+    connect_async(endpoint const& ep, asio_config::asio_callback cb)
+    {
+        ep.check(traits::value);
+        auto const& shm_data = ep.get< traits::endpoint_data >();
+        auto _this = shared_from_this();
+        socket_.async_connect(endpoint_type{ shm_data.path },
+            [_this, cb](asio_config::error_code const& ec)
+            {
+                if (ec) {
+                    if (cb) cb(ec);
+                    return;
+                }
+                // Wait for the segment from the server
+                _this->socket_.async_read_some(asio_ns::null_buffers(),
+                    [_this, cb](asio_config::error_code const& ec, ::std::size_t)
+                    {
+                        _this->handle_segment(ec, cb);
+                    });
+            });
+    }
+
+    void
+    handle_segment(asio_config::error_code ec, asio_config::asio_callback cb)
+    {
+        if (!ec) {
+            segment_.reset(new detail::shm_segment{});
+            segment_->receive(socket_.native_handle(), ec);
+        }
+        if (!ec) {
+            established(detail::shm_segment::client);
+        }
+        if (cb) cb(ec);
+    }
+
+    void
+    start(asio_config::asio_callback cb)
+    {
+        asio_config::error_code ec;
+        segment_.reset(new detail::shm_segment{});
+        segment_->create(detail::shm_segment::default_ring_capacity, ec);
+        if (!ec) {
+            segment_->send(socket_.native_handle(), ec);
+        }
+        if (!ec) {
+            established(detail::shm_segment::server);
+        }
+        io_service_->post([cb, ec](){ if (cb) cb(ec); });
+    }
+
+    void
+    established(side_type side)
+    {
+        side_ = side;
+        peer_ = side == detail::shm_segment::server ?
+                detail::shm_segment::client : detail::shm_segment::server;
+        wakeup_.assign(::dup(segment_->wait_fd(side_)));
+        open_ = true;
+        watch_peer();
+    }
+
+    void
+    watch_peer()
+    {
+        auto _this = shared_from_this();
+        socket_.async_read_some(asio_ns::buffer(&peer_byte_, 1),
+            [_this](asio_config::error_code const& ec, ::std::size_t)
+            {
+                if (ec != asio_config::error::operation_aborted) {
+                    // The socket carries no data, peer went away
+                    _this->peer_gone();
+                }
+            });
+    }
+    //@}
+
+    void
+    close()
+    {
+        pending_read rd;
+        pending_write wr;
+        {
+            lock_guard lock{mtx_};
+            if (open_) {
+                open_ = false;
+                incoming().close();
+                outgoing().close();
+                segment_->notify(peer_);
+            }
+            rd = ::std::move(read_);
+            wr = ::std::move(write_);
+            read_ = pending_read{};
+            write_ = pending_write{};
+        }
+        asio_config::error_code ignore;
+        wakeup_.close(ignore);
+        socket_.close(ignore);
+        auto ec = asio_config::make_error_code(asio_config::error::operation_aborted);
+        complete(rd.cb, ec, 0);
+        complete(wr.cb, ec, wr.written);
+    }
+
+    void
+    peer_gone()
+    {
+        lock_guard lock{mtx_};
+        if (open_) {
+            incoming().close();
+            outgoing().close();
+            check_pending();
+        }
+    }
+
+    //@{
+    /** @name Data transfer */
+    void
+    read_async(asio_ns::mutable_buffer buffer, asio_config::asio_rw_callback cb)
+    {
+        if (!open_) {
+            complete(cb, asio_config::make_error_code( asio_config::error::shut_down ), 0);
+            return;
+        }
+        auto n = read(buffer);
+        if (n == 0 && spin([this](){ return !incoming().empty(); }))
+            n = read(buffer);
+        if (n > 0) {
+            complete(cb, asio_config::error_code{}, n);
+            return;
+        }
+        lock_guard lock{mtx_};
+        read_ = pending_read{ buffer, ::std::move(cb) };
+        incoming().set_reader_waiting();
+        check_pending();
+    }
+
+    void
+    write_async(buffer_list&& buffers, asio_config::asio_rw_callback cb)
+    {
+        if (!open_) {
+            complete(cb, asio_config::make_error_code( asio_config::error::shut_down ), 0);
+            return;
+        }
+        ::std::size_t total = 0;
+        for (auto const& b : buffers) {
+            total += asio_ns::buffer_size(b);
+        }
+        pending_write wr{ ::std::move(buffers), total, 0, ::std::move(cb) };
+        write(wr);
+        if (wr.written < wr.total &&
+                spin([this](){ return outgoing().size() < outgoing().capacity(); }))
+            write(wr);
+        if (wr.written == wr.total) {
+            complete(wr.cb, asio_config::error_code{}, wr.total);
+            return;
+        }
+        lock_guard lock{mtx_};
+        write_ = ::std::move(wr);
+        outgoing().set_writer_waiting();
+        check_pending();
+    }
+
+    ::std::size_t
+    read(asio_ns::mutable_buffer buffer)
+    {
+        auto n = incoming().read(asio_ns::buffer_cast<void*>(buffer),
+                asio_ns::buffer_size(buffer));
+        if (n > 0 && incoming().take_writer_waiting())
+            segment_->notify(peer_);
+        return n;
+    }
+
+    void
+    write(pending_write& wr)
+    {
+        auto n = outgoing().write(wr.buffers, wr.written);
+        wr.written += n;
+        if (n > 0 && outgoing().take_reader_waiting())
+            segment_->notify(peer_);
+    }
+
+    /**
+     * Spin waiting for the condition, adapt the spin limit
+     */
+    template < typename Predicate >
+    bool
+    spin(Predicate pred)
+    {
+        auto limit = spin_limit_.load(::std::memory_order_relaxed);
+        for (unsigned i = 0; i < limit; ++i) {
+            if (pred()) {
+                spin_limit_.store(::std::min(limit * 2, max_spin),
+                        ::std::memory_order_relaxed);
+                return true;
+            }
+            cpu_relax();
+        }
+        spin_limit_.store(::std::max(limit / 2, min_spin), ::std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * Try to complete pending operations, must be called with the
+     * mutex locked. Arms the wakeup wait if something is still pending.
+     */
+    void
+    check_pending()
+    {
+        if (read_.cb) {
+            auto n = read(read_.buffer);
+            if (n > 0 || incoming().closed()) {
+                incoming().clear_reader_waiting();
+                auto ec = n > 0 ? asio_config::error_code{} :
+                        asio_config::make_error_code(asio_config::error::eof);
+                complete(read_.cb, ec, n);
+                read_ = pending_read{};
+            }
+        }
+        if (write_.cb) {
+            write(write_);
+            if (write_.written == write_.total || outgoing().closed()) {
+                auto ec = write_.written == write_.total ? asio_config::error_code{} :
+                        asio_config::make_error_code(asio_config::error::broken_pipe);
+                complete(write_.cb, ec, write_.written);
+                write_ = pending_write{};
+            }
+        }
+        if ((read_.cb || write_.cb) && !waiting_ && open_) {
+            waiting_ = true;
+            auto _this = shared_from_this();
+            wakeup_.async_read_some(asio_ns::buffer(&wake_counter_, sizeof(wake_counter_)),
+                [_this](asio_config::error_code const& ec, ::std::size_t)
+                {
+                    _this->handle_wakeup(ec);
+                });
+        }
+    }
+
+    void
+    handle_wakeup(asio_config::error_code const& ec)
+    {
+        lock_guard lock{mtx_};
+        waiting_ = false;
+        if (!ec) {
+            if (read_.cb)
+                incoming().set_reader_waiting();
+            if (write_.cb)
+                outgoing().set_writer_waiting();
+            check_pending();
+        }
+    }
+    //@}
+
+    void
+    complete(asio_config::asio_rw_callback const& cb,
+            asio_config::error_code const& ec, ::std::size_t bytes)
+    {
+        if (cb) {
+            io_service_->post([cb, ec, bytes](){ cb(ec, bytes); });
+        }
+    }
+
+    detail::shm_ring&
+    incoming()
+    { return segment_->incoming(side_); }
+    detail::shm_ring&
+    outgoing()
+    { return segment_->outgoing(side_); }
+
+    asio_config::io_service_ptr                 io_service_;
+    socket_type                                 socket_;
+    asio_ns::posix::stream_descriptor           wakeup_;
+    ::std::unique_ptr< detail::shm_segment >    segment_;
+    side_type                                   side_   = detail::shm_segment::server;
+    side_type                                   peer_   = detail::shm_segment::client;
+    ::std::atomic<bool>                         open_{false};
+
+    mutex_type                                  mtx_;
+    pending_read                                read_;
+    pending_write                               write_;
+    bool                                        waiting_    = false;
+    ::std::uint64_t                             wake_counter_ = 0;
+    char                                        peer_byte_  = 0;
+    ::std::atomic<unsigned>                     spin_limit_{min_spin};
+};
+
+constexpr unsigned shm_transport::impl::min_spin;
+constexpr unsigned shm_transport::impl::max_spin;
+
+shm_transport::shm_transport(asio_config::io_service_ptr io_svc)
+    : pimpl_{ ::std::make_shared<impl>(io_svc) }
+{
+}
+
+shm_transport::~shm_transport()
+{
+    pimpl_->close();
+}
+
+void
+shm_transport::connect_async(endpoint const& ep, asio_config::asio_callback cb)
+{
+    pimpl_->connect_async(ep, cb);
+}
+
+void
+shm_transport::start(asio_config::asio_callback cb)
+{
+    pimpl_->start(cb);
+}
+
+void
+shm_transport::close()
+{
+    pimpl_->close();
+}
+
+bool
+shm_transport::is_open() const
+{
+    return pimpl_->open_;
+}
+
+void
+shm_transport::write_async(buffer_list&& buffers, asio_config::asio_rw_callback cb)
+{
+    pimpl_->write_async(::std::move(buffers), ::std::move(cb));
+}
+
+void
+shm_transport::read_async(asio_ns::mutable_buffer buffer, asio_config::asio_rw_callback cb)
+{
+    pimpl_->read_async(buffer, ::std::move(cb));
+}
+
+shm_transport::listen_socket_type&
+shm_transport::socket()
+{
+    return pimpl_->socket_;
+}
+
+shm_transport::listen_socket_type const&
+shm_transport::socket() const
+{
+    return pimpl_->socket_;
+}
+
+endpoint
+shm_transport::local_endpoint() const
+{
+    return traits::get_endpoint_data(pimpl_->socket_.local_endpoint());
+}
+
+endpoint
+shm_transport::local_endpoint(asio_config::error_code& ec) const
+{
+    auto ep = pimpl_->socket_.local_endpoint(ec);
+    if (ec) {
+        return endpoint{};
+    }
+    return traits::get_endpoint_data(ep);
+}
+
+endpoint
+shm_transport::remote_endpoint() const
+{
+    return traits::get_endpoint_data(pimpl_->socket_.remote_endpoint());
+}
+
+endpoint
+shm_transport::remote_endpoint(asio_config::error_code& ec) const
+{
+    auto ep = pimpl_->socket_.remote_endpoint(ec);
+    if (ec) {
+        return endpoint{};
+    }
+    return traits::get_endpoint_data(ep);
+}
+#endif /* WIRE_HAS_SHM_TRANSPORT */
+
+//----------------------------------------------------------------------------
+//    In-process transport implementation
+//----------------------------------------------------------------------------
+namespace {
+
+/**
+ * Pair of byte queues connecting two in-process transports
+ */
+struct inproc_channel {
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+    using buffer_list   = ::std::vector< asio_ns::const_buffer >;
+
+    enum side_type {
+        client,
+        server
+    };
+
+    struct pending_read {
+        asio_ns::mutable_buffer         buffer;
+        asio_config::asio_rw_callback   cb;
+        asio_config::io_service_ptr     io_service;
+    };
+
+    /**
+     * Data flowing to one side of the channel
+     */
+    struct stream {
+        mutex_type                      mtx;
+        ::std::vector<unsigned char>    data;
+        ::std::size_t                   read_pos    = 0;
+        pending_read                    read;
+        bool                            closed      = false;
+
+        ::std::size_t
+        available() const
+        { return data.size() - read_pos; }
+
+        /**
+         * Copy the buffers starting from the offset to the queue
+         */
+        void
+        append(buffer_list const& buffers, ::std::size_t offset)
+        {
+            for (auto const& b : buffers) {
+                auto sz = asio_ns::buffer_size(b);
+                if (offset >= sz) {
+                    offset -= sz;
+                    continue;
+                }
+                auto p = asio_ns::buffer_cast<unsigned char const*>(b);
+                data.insert(data.end(), p + offset, p + sz);
+                offset = 0;
+            }
+        }
+
+        ::std::size_t
+        consume(asio_ns::mutable_buffer buffer)
+        {
+            auto n = ::std::min(available(), asio_ns::buffer_size(buffer));
+            ::std::copy_n(data.data() + read_pos, n,
+                    asio_ns::buffer_cast<unsigned char*>(buffer));
+            read_pos += n;
+            if (read_pos == data.size()) {
+                data.clear();
+                read_pos = 0;
+            }
+            return n;
+        }
+    };
+
+    ::std::string   name;
+    stream          streams[2];
+};
+
+using inproc_channel_ptr = ::std::shared_ptr< inproc_channel >;
+
+void
+post_completion(asio_config::io_service_ptr const& svc,
+        asio_config::asio_rw_callback cb,
+        asio_config::error_code const& ec, ::std::size_t bytes)
+{
+    if (cb && svc) {
+        svc->post([cb, ec, bytes](){ cb(ec, bytes); });
+    }
+}
+
+}  /* namespace  */
+
+struct inproc_transport::impl {
+    using side_type     = inproc_channel::side_type;
+    using lock_guard    = inproc_channel::lock_guard;
+    using stream        = inproc_channel::stream;
+    using pending_read  = inproc_channel::pending_read;
+
+    impl(asio_config::io_service_ptr svc)
+        : io_service_{svc}
+    {
+    }
+
+    void
+    attach(inproc_channel_ptr channel, side_type side)
+    {
+        channel_ = channel;
+        side_ = side;
+        open_ = true;
+    }
+
+    void
+    close()
+    {
+        if (!open_.exchange(false))
+            return;
+        pending_read own, peer;
+        {
+            lock_guard lock{incoming().mtx};
+            incoming().closed = true;
+            own = ::std::move(incoming().read);
+            incoming().read = pending_read{};
+        }
+        {
+            lock_guard lock{outgoing().mtx};
+            outgoing().closed = true;
+            peer = ::std::move(outgoing().read);
+            outgoing().read = pending_read{};
+        }
+        post_completion(own.io_service, own.cb,
+                asio_config::make_error_code(asio_config::error::operation_aborted), 0);
+        post_completion(peer.io_service, peer.cb,
+                asio_config::make_error_code(asio_config::error::eof), 0);
+    }
+
+    void
+    read_async(asio_ns::mutable_buffer buffer, asio_config::asio_rw_callback cb)
+    {
+        if (!open_) {
+            post_completion(io_service_, cb,
+                    asio_config::make_error_code( asio_config::error::shut_down ), 0);
+            return;
+        }
+        auto& in = incoming();
+        ::std::size_t n = 0;
+        {
+            lock_guard lock{in.mtx};
+            if (in.available() == 0 && !in.closed) {
+                in.read = pending_read{ buffer, ::std::move(cb), io_service_ };
+                return;
+            }
+            n = in.consume(buffer);
+        }
+        auto ec = n > 0 ? asio_config::error_code{} :
+                asio_config::make_error_code(asio_config::error::eof);
+        post_completion(io_service_, cb, ec, n);
+    }
+
+    void
+    write_async(buffer_list&& buffers, asio_config::asio_rw_callback cb)
+    {
+        if (!open_) {
+            post_completion(io_service_, cb,
+                    asio_config::make_error_code( asio_config::error::shut_down ), 0);
+            return;
+        }
+        auto& out = outgoing();
+        ::std::size_t total = asio_ns::buffer_size(buffers);
+        pending_read rd;
+        ::std::size_t delivered = 0;
+        {
+            lock_guard lock{out.mtx};
+            if (out.closed) {
+                post_completion(io_service_, cb,
+                        asio_config::make_error_code( asio_config::error::broken_pipe ), 0);
+                return;
+            }
+            if (out.read.cb) {
+                // The peer is waiting for data, so the queue is empty.
+                // Copy directly to the reader's buffer.
+                rd = ::std::move(out.read);
+                out.read = pending_read{};
+                delivered = asio_ns::buffer_copy(rd.buffer, buffers);
+            }
+            out.append(buffers, delivered);
+        }
+        post_completion(rd.io_service, rd.cb, asio_config::error_code{}, delivered);
+        post_completion(io_service_, cb, asio_config::error_code{}, total);
+    }
+
+    endpoint
+    get_endpoint(asio_config::error_code& ec) const
+    {
+        if (!open_) {
+            ec = asio_config::make_error_code(asio_config::error::not_connected);
+            return endpoint{};
+        }
+        ec = asio_config::error_code{};
+        return endpoint::inproc(channel_->name);
+    }
+
+    stream&
+    incoming()
+    { return channel_->streams[side_]; }
+    stream&
+    outgoing()
+    { return channel_->streams[side_ == inproc_channel::client ?
+            inproc_channel::server : inproc_channel::client]; }
+
+    asio_config::io_service_ptr io_service_;
+    inproc_channel_ptr          channel_;
+    side_type                   side_       = inproc_channel::client;
+    ::std::atomic<bool>         open_{false};
+};
+
+inproc_transport::inproc_transport(asio_config::io_service_ptr io_svc)
+    : pimpl_{ ::std::make_shared<impl>(io_svc) }
+{
+}
+
+inproc_transport::~inproc_transport()
+{
+    pimpl_->close();
+}
+
+void
+inproc_transport::connect_async(endpoint const& ep, asio_config::asio_callback cb)
+{
+    asio_config::error_code ec;
+    try {
+        ep.check(traits::value);
+        ec = inproc_acceptor::connect(ep.get< traits::endpoint_data >().path, *this);
+    } catch (...) {
+        ec = asio_config::make_error_code(asio_config::error::invalid_argument);
+    }
+    pimpl_->io_service_->post([cb, ec](){ if (cb) cb(ec); });
+}
+
+void
+inproc_transport::accept(inproc_transport& client, ::std::string const& name)
+{
+    auto channel = ::std::make_shared< inproc_channel >();
+    channel->name = name;
+    pimpl_->attach(channel, inproc_channel::server);
+    client.pimpl_->attach(channel, inproc_channel::client);
+}
+
+void
+inproc_transport::close()
+{
+    pimpl_->close();
+}
+
+bool
+inproc_transport::is_open() const
+{
+    return pimpl_->open_;
+}
+
+void
+inproc_transport::write_async(buffer_list&& buffers, asio_config::asio_rw_callback cb)
+{
+    pimpl_->write_async(::std::move(buffers), ::std::move(cb));
+}
+
+void
+inproc_transport::read_async(asio_ns::mutable_buffer buffer, asio_config::asio_rw_callback cb)
+{
+    pimpl_->read_async(buffer, ::std::move(cb));
+}
+
+endpoint
+inproc_transport::local_endpoint() const
+{
+    asio_config::error_code ec;
+    auto ep = pimpl_->get_endpoint(ec);
+    if (ec)
+        throw asio_config::system_error{ec};
+    return ep;
+}
+
+endpoint
+inproc_transport::local_endpoint(asio_config::error_code& ec) const
+{
+    return pimpl_->get_endpoint(ec);
+}
+
+endpoint
+inproc_transport::remote_endpoint() const
+{
+    return local_endpoint();
+}
+
+endpoint
+inproc_transport::remote_endpoint(asio_config::error_code& ec) const
+{
+    return pimpl_->get_endpoint(ec);
+}
+
+//----------------------------------------------------------------------------
+struct inproc_acceptor::impl {
+    using mutex_type    = ::std::mutex;
+    using lock_guard    = ::std::lock_guard<mutex_type>;
+    using impl_ptr      = ::std::shared_ptr<impl>;
+    using registry_type = ::std::map< ::std::string, ::std::weak_ptr<impl> >;
+
+    static mutex_type&
+    registry_mutex()
+    {
+        static mutex_type mtx;
+        return mtx;
+    }
+    static registry_type&
+    registry()
+    {
+        static registry_type reg;
+        return reg;
+    }
+
+    static impl_ptr
+    find(::std::string const& name)
+    {
+        lock_guard lock{registry_mutex()};
+        auto f = registry().find(name);
+        if (f != registry().end())
+            return f->second.lock();
+        return impl_ptr{};
+    }
+
+    void
+    bind(impl_ptr _this)
+    {
+        lock_guard lock{registry_mutex()};
+        auto& reg = registry();
+        auto f = reg.find(name_);
+        if (f != reg.end() && !f->second.expired()) {
+            throw asio_config::system_error{
+                asio_config::make_error_code(asio_config::error::address_in_use),
+                "inproc://" + name_ };
+        }
+        reg[name_] = _this;
+    }
+
+    void
+    unbind()
+    {
+        lock_guard lock{registry_mutex()};
+        auto& reg = registry();
+        auto f = reg.find(name_);
+        if (f != reg.end()) {
+            auto p = f->second.lock();
+            if (!p || p.get() == this)
+                reg.erase(f);
+        }
+    }
+
+    asio_config::error_code
+    accept(inproc_transport& client)
+    {
+        lock_guard lock{mtx_};
+        if (!handler_)
+            return asio_config::make_error_code(asio_config::error::connection_refused);
+        try {
+            handler_(client);
+        } catch (...) {
+            return asio_config::make_error_code(asio_config::error::connection_refused);
+        }
+        return asio_config::error_code{};
+    }
+
+    mutex_type              mtx_;
+    ::std::string           name_;
+    accept_handler          handler_;
+    ::std::atomic<bool>     open_{false};
+};
+
+inproc_acceptor::inproc_acceptor()
+    : pimpl_{ ::std::make_shared<impl>() }
+{
+}
+
+inproc_acceptor::~inproc_acceptor()
+{
+    close();
+}
+
+void
+inproc_acceptor::open(::std::string const& name, accept_handler handler)
+{
+    if (name.empty())
+        throw errors::logic_error("Empty name in inproc endpoint");
+    close();
+    {
+        impl::lock_guard lock{pimpl_->mtx_};
+        pimpl_->name_ = name;
+        pimpl_->handler_ = handler;
+    }
+    try {
+        pimpl_->bind(pimpl_);
+    } catch (...) {
+        impl::lock_guard lock{pimpl_->mtx_};
+        pimpl_->handler_ = nullptr;
+        throw;
+    }
+    pimpl_->open_ = true;
+}
+
+void
+inproc_acceptor::close()
+{
+    if (pimpl_->open_.exchange(false)) {
+        pimpl_->unbind();
+        impl::lock_guard lock{pimpl_->mtx_};
+        pimpl_->handler_ = nullptr;
+    }
+}
+
+bool
+inproc_acceptor::is_open() const
+{
+    return pimpl_->open_;
+}
+
+::std::string const&
+inproc_acceptor::name() const
+{
+    return pimpl_->name_;
+}
+
+asio_config::error_code
+inproc_acceptor::connect(::std::string const& name, inproc_transport& client)
+{
+    auto acceptor = impl::find(name);
+    if (!acceptor)
+        return asio_config::make_error_code(asio_config::error::connection_refused);
+    return acceptor->accept(client);
+}
+
 }  // namespace core
 }  // namespace wire
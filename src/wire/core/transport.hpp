@@ -12,6 +12,8 @@
 #include <wire/future_config.hpp>
 #include <wire/core/endpoint.hpp>
 #include <wire/core/detail/ssl_options.hpp>
+#include <wire/core/detail/datagram_batch.hpp>
+#include <wire/core/detail/uring_service.hpp>
 #include <wire/core/ssl_certificate_fwd.hpp>
 
 #include <pushkin/asio/async_ssl_ops.hpp>
@@ -19,6 +21,12 @@
 #include <memory>
 #include <future>
 #include <atomic>
+#include <functional>
+#include <vector>
+
+#if defined(__linux__) && defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#define WIRE_HAS_SHM_TRANSPORT 1
+#endif
 
 namespace wire {
 namespace core {
@@ -32,6 +40,9 @@ struct tcp_transport;
 struct ssl_transport;
 struct udp_transport;
 struct socket_transport;
+struct shm_transport;
+struct inproc_transport;
+struct inproc_acceptor;
 
 template<transport_type>
 struct transport_type_traits;
@@ -146,6 +157,48 @@ struct transport_type_traits<transport_type::socket> {
     close_acceptor(acceptor_type& acceptor);
 };
 
+//----------------------------------------------------------------------------
+#ifdef WIRE_HAS_SHM_TRANSPORT
+template<>
+struct transport_type_traits<transport_type::shm> {
+    static constexpr transport_type value   = transport_type::shm;
+    static constexpr bool stream_oriented   = true;
+    static constexpr bool is_ip             = false;
+
+    using type                  = shm_transport;
+    using endpoint_data         = detail::shm_endpoint_data;
+
+    using protocol              = asio_config::local_socket;
+    using socket_type           = protocol::socket;
+    using listen_socket_type    = protocol::socket;
+    using endpoint_type         = protocol::endpoint;
+    using acceptor_type         = protocol::acceptor;
+
+    static endpoint_type
+    create_endpoint(asio_config::io_service_ptr svc, endpoint const&);
+    static endpoint
+    get_endpoint_data(endpoint_type const&);
+
+    static void
+    close_acceptor(acceptor_type& acceptor);
+};
+#endif /* WIRE_HAS_SHM_TRANSPORT */
+
+//----------------------------------------------------------------------------
+template<>
+struct transport_type_traits<transport_type::inproc> {
+    static constexpr transport_type value   = transport_type::inproc;
+    static constexpr bool stream_oriented   = true;
+    static constexpr bool is_ip             = false;
+
+    using type                  = inproc_transport;
+    using endpoint_data         = detail::inproc_endpoint_data;
+
+    using socket_type           = inproc_transport;
+    using listen_socket_type    = inproc_transport;
+    using acceptor_type         = inproc_acceptor;
+};
+
 //----------------------------------------------------------------------------
 //  Transport implementations
 //----------------------------------------------------------------------------
@@ -168,7 +221,7 @@ struct tcp_transport {
     connect_async(endpoint const& ep)
         -> decltype(::std::declval<_Promise<void>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<void> >();
+        auto promise = make_promise< _Promise<void> >();
         connect_async(ep,
             [promise](asio_config::error_code const& ec)
             {
@@ -182,6 +235,11 @@ struct tcp_transport {
 
         return promise->get_future();
     }
+    /**
+     * Server side session start
+     */
+    void
+    start(asio_config::asio_callback cb);
     void
     close();
 
@@ -196,7 +254,13 @@ struct tcp_transport {
     async_write(BufferType const& buffer, HandlerType handler)
     {
         if (socket_.is_open()) {
-            ::psst::asio::async_write(socket_, buffer, ::std::move(handler));
+            if (uring_stream_) {
+                uring_->async_send(uring_stream_,
+                        detail::uring_service::buffer_list(buffer.begin(), buffer.end()),
+                        ::std::move(handler));
+            } else {
+                ::psst::asio::async_write(socket_, buffer, ::std::move(handler));
+            }
         } else {
             handler(asio_config::make_error_code( asio_config::error::shut_down ), 0);
         }
@@ -207,7 +271,7 @@ struct tcp_transport {
     async_write(BufferType const& buffer)
         -> decltype(::std::declval<_Promise<::std::size_t>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<::std::size_t> >();
+        auto promise = make_promise< _Promise<::std::size_t> >();
         async_write(buffer,
             [promise](asio_config::error_code const& ec, ::std::size_t bytes)
             {
@@ -226,8 +290,12 @@ struct tcp_transport {
     async_read(BufferType&& buffer, HandlerType handler)
     {
         if (socket_.is_open()) {
-            ::psst::asio::async_read(socket_, ::std::forward<BufferType>(buffer),
-                    ::std::move(handler));
+            if (uring_stream_) {
+                uring_->async_receive(uring_stream_, *buffer.begin(), ::std::move(handler));
+            } else {
+                ::psst::asio::async_read(socket_, ::std::forward< BufferType >(buffer),
+                        ::std::move(handler));
+            }
         } else {
             handler(asio_config::make_error_code( asio_config::error::shut_down ), 0);
         }
@@ -238,7 +306,7 @@ struct tcp_transport {
     async_read(BufferType&& buffer)
         -> decltype(::std::declval<_Promise<::std::size_t>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<::std::size_t> >();
+        auto promise = make_promise< _Promise<::std::size_t> >();
         async_read(::std::forward<BufferType>(buffer),
             [promise](asio_config::error_code const& ec, ::std::size_t bytes)
             {
@@ -295,6 +363,12 @@ private:
             asio_config::asio_callback);
     void
     handle_connect(asio_config::error_code const& ec, asio_config::asio_callback);
+    /**
+     * Attach the connected socket to the io_uring backend if it is
+     * enabled. Called before any read or write is started.
+     */
+    void
+    open_uring();
 private:
     tcp_transport(tcp_transport const&) = delete;
     tcp_transport&
@@ -302,6 +376,9 @@ private:
 private:
     resolver_type   resolver_;
     socket_type     socket_;
+
+    detail::uring_service*              uring_;
+    detail::uring_service::stream_ptr   uring_stream_;
     // TODO timeout settings
 };
 
@@ -348,6 +425,11 @@ struct ssl_transport {
     {
         return socket_.lowest_layer().is_open();
     }
+    /**
+     * @return true if the handshake resumed a previous session
+     */
+    bool
+    session_reused() const;
 
     inline bool
     ssl_shutdown() const
@@ -374,7 +456,7 @@ struct ssl_transport {
     async_write(BufferType const& buffer)
         -> decltype(::std::declval<_Promise<::std::size_t>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<::std::size_t> >();
+        auto promise = make_promise< _Promise<::std::size_t> >();
         async_write(buffer,
             [promise](asio_config::error_code const& ec, ::std::size_t bytes)
             {
@@ -405,7 +487,7 @@ struct ssl_transport {
     async_read(BufferType&& buffer)
         -> decltype(::std::declval<_Promise<::std::size_t>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<::std::size_t> >();
+        auto promise = make_promise< _Promise<::std::size_t> >();
         async_read(::std::forward<BufferType>(buffer),
             [promise](asio_config::error_code const& ec, ::std::size_t bytes)
             {
@@ -467,6 +549,11 @@ private:
     handle_connect(asio_config::error_code const& ec, asio_config::asio_callback);
     void
     handle_handshake(asio_config::error_code const& ec, asio_config::asio_callback);
+
+    static int
+    transport_index();
+    static int
+    new_session_callback(SSL*, SSL_SESSION*);
 private:
     ssl_transport(ssl_transport const&) = delete;
     ssl_transport&
@@ -479,6 +566,8 @@ private:
     verify_mode                     verify_mode_ = asio_ns::ssl::verify_peer;
 
     ssl_verify_callback             verify_;
+    detail::ssl_session_cache_ptr   session_cache_;
+    ::std::string                   session_key_;
 };
 
 //----------------------------------------------------------------------------
@@ -527,6 +616,28 @@ struct udp_transport {
         }
     }
 
+    //@{
+    /** @name Datagram batches */
+    /**
+     * Send datagrams via the connected socket, one wire message per
+     * datagram. Uses sendmmsg where available.
+     * @param datagrams Datagrams to send, must stay valid until the
+     *      handler is called
+     * @param handler Receives the number of datagrams sent
+     */
+    void
+    async_send_batch(detail::datagram_list const& datagrams,
+            asio_config::asio_rw_callback handler);
+    /**
+     * Wait for datagrams and receive all available ones up to the batch
+     * capacity. Uses recvmmsg where available.
+     * @param handler Receives the number of datagrams received
+     */
+    void
+    async_receive_batch(detail::datagram_batch& batch,
+            asio_config::asio_rw_callback handler);
+    //@}
+
     endpoint
     local_endpoint() const
     {
@@ -563,13 +674,18 @@ private:
             asio_config::asio_callback);
     void
     handle_connect(asio_config::error_code const&, asio_config::asio_callback);
+
+    void
+    send_batch(detail::datagram_list const& datagrams, ::std::size_t sent,
+            asio_config::asio_rw_callback handler);
 private:
     udp_transport(udp_transport const&) = delete;
     udp_transport&
     operator =(udp_transport const&) = delete;
 protected:
-    resolver_type   resolver_;
-    socket_type     socket_;
+    asio_config::io_service_ptr io_service_;
+    resolver_type               resolver_;
+    socket_type                 socket_;
 };
 
 //----------------------------------------------------------------------------
@@ -589,6 +705,11 @@ struct socket_transport {
      */
     void
     connect_async(endpoint const& ep, asio_config::asio_callback);
+    /**
+     * Server side session start
+     */
+    void
+    start(asio_config::asio_callback cb);
 
     void
     close();
@@ -603,7 +724,13 @@ struct socket_transport {
     void async_write(BufferType const& buffer, HandlerType handler)
     {
         if (socket_.is_open()) {
-            ::psst::asio::async_write(socket_, buffer, ::std::move(handler));
+            if (uring_stream_) {
+                uring_->async_send(uring_stream_,
+                        detail::uring_service::buffer_list(buffer.begin(), buffer.end()),
+                        ::std::move(handler));
+            } else {
+                ::psst::asio::async_write(socket_, buffer, ::std::move(handler));
+            }
         } else {
             handler(asio_config::make_error_code( asio_config::error::shut_down ), 0);
         }
@@ -614,7 +741,7 @@ struct socket_transport {
     async_write(BufferType const& buffer)
         -> decltype(::std::declval<_Promise<::std::size_t>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<::std::size_t> >();
+        auto promise = make_promise< _Promise<::std::size_t> >();
         async_write(buffer,
             [promise](asio_config::error_code const& ec, ::std::size_t bytes)
             {
@@ -633,8 +760,12 @@ struct socket_transport {
     async_read(BufferType&& buffer, HandlerType handler)
     {
         if (socket_.is_open()) {
-            ::psst::asio::async_read(socket_, ::std::forward< BufferType >(buffer),
-                    ::std::move(handler));
+            if (uring_stream_) {
+                uring_->async_receive(uring_stream_, *buffer.begin(), ::std::move(handler));
+            } else {
+                ::psst::asio::async_read(socket_, ::std::forward< BufferType >(buffer),
+                        ::std::move(handler));
+            }
         } else {
             handler(asio_config::make_error_code( asio_config::error::shut_down ), 0);
         }
@@ -645,7 +776,7 @@ struct socket_transport {
     async_read(BufferType&& buffer)
         -> decltype(::std::declval<_Promise<::std::size_t>>().get_future())
     {
-        auto promise = ::std::make_shared< _Promise<::std::size_t> >();
+        auto promise = make_promise< _Promise<::std::size_t> >();
         async_read(::std::forward<BufferType>(buffer),
             [promise](asio_config::error_code const& ec, ::std::size_t bytes)
             {
@@ -698,15 +829,251 @@ struct socket_transport {
 private:
     void
     handle_connect(asio_config::error_code const&, asio_config::asio_callback);
+    /**
+     * Attach the connected socket to the io_uring backend if it is
+     * enabled. Called before any read or write is started.
+     */
+    void
+    open_uring();
 private:
     socket_transport(socket_transport const&) = delete;
     socket_transport&
     operator = (socket_transport const&) = delete;
 private:
     socket_type socket_;
+
+    detail::uring_service*              uring_;
+    detail::uring_service::stream_ptr   uring_stream_;
 };
 #endif /* BOOST_ASIO_HAS_LOCAL_SOCKETS */
 
+//----------------------------------------------------------------------------
+#ifdef WIRE_HAS_SHM_TRANSPORT
+/**
+ * Shared memory transport for peers on the same host.
+ *
+ * The connection is set up over a unix socket: the accepting side creates
+ * a shared memory segment with a pair of SPSC byte rings and passes its
+ * descriptors to the connecting side. After that the data goes through the
+ * rings, the unix socket is only used to detect the peer going away.
+ * A side that finds its ring empty (or full) spins for a while before going
+ * to sleep on an eventfd, the spin limit adapts to how often spinning helps.
+ */
+struct shm_transport {
+    using traits                = transport_type_traits< transport_type::shm >;
+    using socket_type           = traits::socket_type;
+    using listen_socket_type    = traits::listen_socket_type;
+    using endpoint_type         = traits::endpoint_type;
+    static constexpr transport_type type = transport_type::shm;
+
+    shm_transport(asio_config::io_service_ptr);
+    ~shm_transport();
+
+    /**
+     * Client connect.
+     * @param ep endpoint to connect to
+     * @param cb callback that is called when the operation finishes
+     */
+    void
+    connect_async(endpoint const& ep, asio_config::asio_callback);
+    /**
+     * Server start, sends the shared memory segment to the client
+     * @param cb callback that is called when the operation finishes
+     */
+    void
+    start(asio_config::asio_callback);
+
+    void
+    close();
+
+    bool
+    is_open() const;
+
+    template<typename BufferType, typename HandlerType>
+    void async_write(BufferType const& buffer, HandlerType handler)
+    {
+        buffer_list buffers;
+        for (auto const& b : buffer) {
+            buffers.push_back(b);
+        }
+        write_async(::std::move(buffers), ::std::move(handler));
+    }
+
+    template < typename BufferType, typename HandlerType >
+    void
+    async_read(BufferType&& buffer, HandlerType handler)
+    {
+        read_async(*buffer.begin(), ::std::move(handler));
+    }
+
+    listen_socket_type&
+    socket();
+    listen_socket_type const&
+    socket() const;
+
+    endpoint
+    local_endpoint() const;
+    endpoint
+    local_endpoint(asio_config::error_code& ec) const;
+
+    endpoint
+    remote_endpoint() const;
+    endpoint
+    remote_endpoint(asio_config::error_code& ec) const;
+private:
+    using buffer_list = ::std::vector< asio_ns::const_buffer >;
+    void
+    write_async(buffer_list&&, asio_config::asio_rw_callback);
+    void
+    read_async(asio_ns::mutable_buffer, asio_config::asio_rw_callback);
+private:
+    shm_transport(shm_transport const&) = delete;
+    shm_transport&
+    operator = (shm_transport const&) = delete;
+private:
+    struct impl;
+    using pimpl = ::std::shared_ptr<impl>;
+    pimpl   pimpl_;
+};
+#endif /* WIRE_HAS_SHM_TRANSPORT */
+
+//----------------------------------------------------------------------------
+/**
+ * In-process transport.
+ *
+ * The peers are connected with a pair of in-memory byte queues, no kernel
+ * objects are involved. A write copies the data to the peer's queue or
+ * directly to the peer's pending read buffer, the completion handlers are
+ * posted to the io_service of the side that started the operation.
+ * The queues are not bounded, the amount of data in flight is limited by
+ * the connection's flow control.
+ */
+struct inproc_transport {
+    using traits                = transport_type_traits< transport_type::inproc >;
+    using socket_type           = traits::socket_type;
+    using listen_socket_type    = traits::listen_socket_type;
+    static constexpr transport_type type = transport_type::inproc;
+
+    inproc_transport(asio_config::io_service_ptr);
+    ~inproc_transport();
+
+    /**
+     * Client connect. The connection is accepted in the calling thread.
+     * @param ep endpoint to connect to
+     * @param cb callback that is called when the operation finishes
+     */
+    void
+    connect_async(endpoint const& ep, asio_config::asio_callback);
+    /**
+     * Server accept, connect the transport with the client one
+     * @param client transport of the connecting side
+     * @param name the name the acceptor is bound to
+     */
+    void
+    accept(inproc_transport& client, ::std::string const& name);
+
+    void
+    close();
+
+    bool
+    is_open() const;
+
+    template<typename BufferType, typename HandlerType>
+    void async_write(BufferType const& buffer, HandlerType handler)
+    {
+        buffer_list buffers;
+        for (auto const& b : buffer) {
+            buffers.push_back(b);
+        }
+        write_async(::std::move(buffers), ::std::move(handler));
+    }
+
+    template < typename BufferType, typename HandlerType >
+    void
+    async_read(BufferType&& buffer, HandlerType handler)
+    {
+        read_async(*buffer.begin(), ::std::move(handler));
+    }
+
+    listen_socket_type&
+    socket()
+    { return *this; }
+    listen_socket_type const&
+    socket() const
+    { return *this; }
+
+    endpoint
+    local_endpoint() const;
+    endpoint
+    local_endpoint(asio_config::error_code& ec) const;
+
+    endpoint
+    remote_endpoint() const;
+    endpoint
+    remote_endpoint(asio_config::error_code& ec) const;
+private:
+    using buffer_list = ::std::vector< asio_ns::const_buffer >;
+    void
+    write_async(buffer_list&&, asio_config::asio_rw_callback);
+    void
+    read_async(asio_ns::mutable_buffer, asio_config::asio_rw_callback);
+private:
+    inproc_transport(inproc_transport const&) = delete;
+    inproc_transport&
+    operator = (inproc_transport const&) = delete;
+private:
+    struct impl;
+    using pimpl = ::std::shared_ptr<impl>;
+    pimpl   pimpl_;
+};
+
+/**
+ * Acceptor for in-process connections. Binds a name in the process-wide
+ * registry, a client connecting to the name is passed to the accept
+ * handler in the client's thread.
+ */
+struct inproc_acceptor {
+    using accept_handler = ::std::function< void(inproc_transport&) >;
+
+    inproc_acceptor();
+    ~inproc_acceptor();
+
+    /**
+     * Bind the name and start accepting connections.
+     * @throw asio_config::system_error if the name is already bound
+     */
+    void
+    open(::std::string const& name, accept_handler);
+    /**
+     * Unbind the name, the handler is not called after the function
+     * returns.
+     */
+    void
+    close();
+
+    bool
+    is_open() const;
+
+    ::std::string const&
+    name() const;
+
+    /**
+     * Connect the client transport to the acceptor bound to the name
+     * @return connection_refused if the name is not bound or the acceptor
+     *      failed to accept the connection
+     */
+    static asio_config::error_code
+    connect(::std::string const& name, inproc_transport& client);
+private:
+    inproc_acceptor(inproc_acceptor const&) = delete;
+    inproc_acceptor&
+    operator = (inproc_acceptor const&) = delete;
+private:
+    struct impl;
+    using pimpl = ::std::shared_ptr<impl>;
+    pimpl   pimpl_;
+};
+
 //----------------------------------------------------------------------------
 template<typename Session, transport_type Type>
 struct transport_listener {
@@ -761,6 +1128,56 @@ private:
     ::std::atomic<bool>         closed_;
 };
 
+//----------------------------------------------------------------------------
+/**
+ * In-process listener, creates sessions for the clients connecting to the
+ * bound name.
+ */
+template<typename Session>
+struct transport_listener<Session, transport_type::inproc> {
+    using traits                = transport_type_traits< transport_type::inproc >;
+    using acceptor_type         = typename traits::acceptor_type;
+    using endpoint_data         = typename traits::endpoint_data;
+    using session_type          = Session;
+    using session_ptr           = std::shared_ptr<Session>;
+    using session_factory       = std::function< session_ptr(asio_config::io_service_ptr) >;
+
+    transport_listener(asio_config::io_service_ptr, session_factory);
+    ~transport_listener();
+
+    void
+    open(endpoint const&, bool reuse_port = false);
+
+    void
+    close();
+
+    endpoint
+    local_endpoint() const;
+
+    endpoint
+    remote_endpoint() const
+    { return endpoint{}; }
+
+    bool
+    ready() const
+    { return acceptor_.is_open(); }
+
+    bool
+    is_open() const
+    { return acceptor_.is_open(); }
+private:
+    void
+    handle_connect(inproc_transport& client);
+private:
+    transport_listener(transport_listener const&) = delete;
+    transport_listener&
+    operator =(transport_listener const&) = delete;
+private:
+    asio_config::io_service_ptr io_service_;
+    acceptor_type               acceptor_;
+    session_factory             factory_;
+};
+
 //----------------------------------------------------------------------------
 template<>
 struct transport_listener<void, transport_type::udp> : udp_transport {
@@ -779,8 +1196,6 @@ private:
     transport_listener(transport_listener const&) = delete;
     transport_listener&
     operator =(transport_listener const&) = delete;
-private:
-    asio_config::io_service_ptr io_service_;
 };
 
 }  // namespace core
@@ -97,6 +97,60 @@ transport_listener<Session, Type>::handle_accept(session_ptr session, asio_confi
     }
 }
 
+//----------------------------------------------------------------------------
+//  In-process listener
+//----------------------------------------------------------------------------
+template < typename Session >
+transport_listener< Session, transport_type::inproc >::transport_listener(
+        asio_config::io_service_ptr svc, session_factory factory)
+    : io_service_{svc}, acceptor_{}, factory_{factory}
+{
+}
+
+template < typename Session >
+transport_listener< Session, transport_type::inproc >::~transport_listener()
+{
+    try {
+        close();
+    } catch (...) {}
+}
+
+template < typename Session >
+void
+transport_listener< Session, transport_type::inproc >::open(endpoint const& ep, bool)
+{
+    ep.check(traits::value);
+    acceptor_.open(ep.get< endpoint_data >().path,
+        [this](inproc_transport& client)
+        {
+            handle_connect(client);
+        });
+}
+
+template < typename Session >
+void
+transport_listener< Session, transport_type::inproc >::close()
+{
+    acceptor_.close();
+}
+
+template < typename Session >
+endpoint
+transport_listener< Session, transport_type::inproc >::local_endpoint() const
+{
+    return endpoint::inproc(acceptor_.name());
+}
+
+template < typename Session >
+void
+transport_listener< Session, transport_type::inproc >::handle_connect(
+        inproc_transport& client)
+{
+    session_ptr session = factory_( io_service_ );
+    session->socket().accept(client, acceptor_.name());
+    io_service_->post([session](){ session->start_session(); });
+}
+
 }  // namespace core
 }  // namespace wire
 
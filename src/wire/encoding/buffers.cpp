@@ -161,6 +161,12 @@ outgoing::type() const
     return static_cast<message::message_flags>(pimpl_->flags_ & message::type_bits);
 }
 
+message::message_flags
+outgoing::flags() const
+{
+    return pimpl_->flags_;
+}
+
 outgoing::size_type
 outgoing::size() const
 {
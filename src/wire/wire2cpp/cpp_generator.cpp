@@ -151,6 +151,9 @@ ast::qname const root_exception         { "::wire::errors::user_exception" };
 ast::qname const connection_failed      { "::wire::errors::connection_failed" };
 
 ast::qname const wire_promise           { "::wire::promise" };
+ast::qname const wire_make_promise      { "::wire::make_promise" };
+ast::qname const wire_awaitable         { "::wire::core::invocation_awaitable" };
+ast::qname const wire_dispatch_task     { "::wire::core::dispatch_task" };
 
 ast::qname const hash_value_type_name   { "::wire::hash_value_type" };
 ast::qname const input_iterator_name    { "::wire::encoding::incoming::const_iterator" };
@@ -317,7 +320,8 @@ generator::generator(generate_options const& opts, preprocess_options const& ppo
         header_.include({
             "<wire/core/object.hpp>",
             "<wire/core/functional.hpp>",
-            "<wire/core/proxy.hpp>"
+            "<wire/core/proxy.hpp>",
+            "<wire/core/coroutine.hpp>"
         });
 
         source_.include({"<wire/core/reference.hpp>",
@@ -387,13 +391,24 @@ generator::generate_dispatch_function_member(ast::function_ptr func)
 
     auto ann = find(func->get_annotations(), ast::annotations::SYNC);
     bool async_dispatch = ann == func->get_annotations().end();
+    bool coro_dispatch = find(func->get_annotations(), annotations::CPP_COROUTINE)
+            != func->get_annotations().end();
+    if (coro_dispatch)
+        async_dispatch = false;
     auto const& params = func->get_params();
 
     code_snippet formal_params { header_.current_scope() };
     code_snippet example_params { ast::qname{} };
     for (auto const& p : params) {
-        formal_params << movable_arg_type(p.first) << " " << cpp_name(p.second) << ", ";
-        example_params << movable_arg_type(p.first) << " " << cpp_name(p.second) << ", ";
+        if (coro_dispatch) {
+            // A coroutine uses the parameters after suspension, it
+            // has to own them
+            formal_params << mapped_type{p.first} << " " << cpp_name(p.second) << ", ";
+            example_params << mapped_type{p.first} << " " << cpp_name(p.second) << ", ";
+        } else {
+            formal_params << movable_arg_type(p.first) << " " << cpp_name(p.second) << ", ";
+            example_params << movable_arg_type(p.first) << " " << cpp_name(p.second) << ", ";
+        }
     }
 
     if (async_dispatch) {
@@ -404,9 +419,9 @@ generator::generate_dispatch_function_member(ast::function_ptr func)
             ret_cb_name << cpp_name(func) << "_return_callback";
             ret_example << cpp_name(func) << "_return_callback";
             header_ << off << "using " << ret_cb_name << " = "
-                << "::std::function< void("
+                << wire_callback << "< "
                 <<  arg_type(func->get_return_type(), func->get_annotations())
-                << ") >;";
+                << " >;";
         } else {
             ret_cb_name << wire_void_callback;
             ret_example << wire_void_callback;
@@ -438,6 +453,29 @@ generator::generate_dispatch_function_member(ast::function_ptr func)
         header_ << " override;"
                 << off << "    ---->8    end copy    >8----*/"
         ;
+    } else if (coro_dispatch) {
+        code_snippet task_type{header_.current_scope()};
+        task_type << wire_dispatch_task << "< "
+                << mapped_type{func->get_return_type(), func->get_annotations()} << " >";
+        header_ << off << "/* Coroutine dispatch, the parameters and the current are passed by value */"
+                << off << "virtual " << task_type
+                << off << cpp_name(func) << "(" << formal_params
+                << wire_current << " = " << wire_no_current << ")";
+        if (func->is_const()) {
+            header_ << " const";
+        }
+        header_ << " = 0;";
+        header_ << off << "/*  ----8<    copy here   8<----"
+                << off << abs_name << task_type
+                << off << cpp_name(func) << "(" << example_params
+                    << abs_name << wire_current << " = "
+                    << abs_name << wire_no_current << ")";
+        if (func->is_const()) {
+            header_ << " const";
+        }
+        header_ << " override;"
+                << off << "    ---->8    end copy    >8----*/"
+        ;
     } else {
         header_ << off << "/* Sync dispatch */"
                 << off << "virtual "
@@ -504,21 +542,43 @@ generator::generate_dispatch_function_member(ast::function_ptr func)
                         << " _res";
             }
             source_ << ")"
-                    << off << "{"
-                    << mod(+1) << wire_outgoing << " __out{ __req.buffer->get_connector() };";
-            if (!func->is_void()) {
-                source_ << off
-                        << wire_encoding_write << "(::std::back_inserter(__out), _res);";
+                    << off << "{";
+            if (func->is_void()) {
+                source_ << mod(+1) << wire_outgoing << " __out{ __req.buffer->get_connector() };";
+            } else {
+                // Marshal the result directly into the reply message
+                source_ << mod(+1) << wire_outgoing << " __out{ __req.reply_writer() };"
+                        << off << wire_encoding_write << "(::std::back_inserter(__out), _res);";
             }
             source_ << off << "__req.result(::std::move(__out));";
             source_ << mod(-1) << "}, __req.exception, __curr);";
+        } else if (coro_dispatch) {
+            // The result is delivered when the coroutine finishes
+            fcall << "__curr)";
+            source_ << off << fcall << ".then(";
+            source_ << mod(+1) << "[__req](";
+            if (!func->is_void()) {
+                source_ <<  arg_type(func->get_return_type(), func->get_annotations())
+                        << " _res";
+            }
+            source_ << ")"
+                    << off << "{";
+            if (func->is_void()) {
+                source_ << mod(+1) << wire_outgoing << " __out{ __req.buffer->get_connector() };";
+            } else {
+                source_ << mod(+1) << wire_outgoing << " __out{ __req.reply_writer() };"
+                        << off << wire_encoding_write << "(::std::back_inserter(__out), _res);";
+            }
+            source_ << off << "__req.result(::std::move(__out));";
+            source_ << mod(-1) << "}, __req.exception);";
         } else {
             fcall << "__curr)";
-            source_ << off << wire_outgoing << " __out{ __req.buffer->get_connector() };";
             if (func->is_void()) {
-                source_ << off << fcall << ";";
+                source_ << off << wire_outgoing << " __out{ __req.buffer->get_connector() };"
+                        << off << fcall << ";";
             } else {
-                source_ << off << wire_encoding_write << "(::std::back_inserter(__out), "
+                source_ << off << wire_outgoing << " __out{ __req.reply_writer() };"
+                        << off << wire_encoding_write << "(::std::back_inserter(__out), "
                         << fcall << ");";
             }
             source_ << off << "__req.result(::std::move(__out));";
@@ -570,9 +630,9 @@ generator::generate_invocation_function_member(ast::function_ptr func)
     } else {
         result_callback << cpp_name(func) << "_responce_callback";
         header_ << off << "using " << result_callback << " = "
-                << "::std::function< void( "
+                << wire_callback << "< "
                 << movable_arg_type(func->get_return_type(), func->get_annotations())
-                << " ) >;";
+                << " >;";
     }
 
     header_ << off << "/**"
@@ -600,7 +660,7 @@ generator::generate_invocation_function_member(ast::function_ptr func)
             <<                      mapped_type{func->get_return_type(), func->get_annotations()}
             <<                      " > >().get_future() )"
             << off      << "{"
-            << mod(+1)  <<      "auto promise = ::std::make_shared< _Promise <"
+            << mod(+1)  <<      "auto promise = " << wire_make_promise << "< _Promise <"
                     << mapped_type{func->get_return_type(), func->get_annotations()} << "> >();\n";
 
     if (func->is_void()) {
@@ -652,6 +712,62 @@ generator::generate_invocation_function_member(ast::function_ptr func)
     header_ << off     <<       "return promise->get_future();"
             << mod(-1) << "}\n";
 
+    {
+        // Coroutine invocation
+        code_snippet awaitable{ header_.current_scope() };
+        awaitable << wire_awaitable << "< "
+                << mapped_type{func->get_return_type(), func->get_annotations()} << " >";
+        header_ << off << "#if WIRE_HAS_COROUTINES"
+                << off << "/**"
+                << off << " * Awaitable invocation of " << cpp_name(func)
+                << off << " * The coroutine is resumed in the thread receiving the reply"
+                << off << " */"
+                << off      << awaitable
+                << off      << cpp_name(func) << "_await(" << call_params << " "
+                <<              wire_context << " const& _ctx                  = " << wire_no_context << ","
+                << off(+2)  <<  invocation_opts << " const _opts = " << invocation_opts << "::unspecified)"
+                << off      << "{"
+                << mod(+1)  <<      "return " << awaitable << "{"
+                << mod(+1)  <<          "[&](auto&& __resp, auto&& __exception)"
+                << off      <<          "{";
+        header_.modify_offset(+1);
+        if (func->is_void()) {
+            // Allow one-way invocation
+            header_ << off      << "if (_opts.is_one_way()) {"
+                    << mod(+1)  <<    cpp_name(func) << "_async(";
+            header_.modify_offset(+1);
+            for (auto const& p : params) {
+                header_ << off <<           p.second << ",";
+            }
+            header_ << off      <<           "nullptr, __exception,"
+                    << off      <<           "[__resp, __exception](bool sent)"
+                    << off      <<            "{"
+                    << mod(+1)  <<                "if(sent) {"
+                    << off(+1)  <<                    "__resp();"
+                    << off      <<                "} else {"
+                    << off(+1)  <<                    "__exception("
+                    << off(+2)  <<                         "::std::make_exception_ptr(" << connection_failed << "{}));"
+                    << off      <<                "}"
+                    << mod(-1)  <<            "}, _ctx, _opts);";
+            header_ << mod(-2)  << "} else {";
+            header_.modify_offset(+1);
+        }
+        header_ << off      <<      cpp_name(func) << "_async(";
+        header_.modify_offset(+1);
+        for (auto const& p : params) {
+            header_ << off <<           p.second << ",";
+        }
+        header_ << off      <<           "::std::move(__resp), ::std::move(__exception),"
+                << off      <<           "nullptr, _ctx, _opts"
+                << mod(-1)  <<       ");";
+        if (func->is_void()) {
+            header_ << mod(-1) << "}";
+        }
+        header_ << mod(-1)  <<      "}};"
+                << mod(-2)  << "}"
+                << off      << "#endif /* WIRE_HAS_COROUTINES */\n";
+    }
+
     {
         // Sources
         {
@@ -676,17 +792,17 @@ generator::generate_invocation_function_member(ast::function_ptr func)
 
             source_ << mod(+1) << "if (_opts == " << invocation_opts << "::unspecified)"
                     << off(+1) << "_opts = wire_invocation_options();";
-            source_ << off     << "make_invocation(wire_get_reference(),"
+            source_ << off     << "invoke_operation(wire_get_reference(),"
                     << mod(+2) << os.str() << ", _ctx,"
                     << off << "&" << qname(func->owner()) << "::" << cpp_name(func) << ","
-                    << off << "_response, _exception, _sent";
+                    << off << "_response, _exception, _sent, _opts";
             if (!params.empty()) {
                 source_ << off;
                 for (auto const& p : params) {
                     source_ << ", " << p.second;
                 }
             }
-            source_ << ")(_opts);";
+            source_ << ");";
 
             source_ << mod(-3) << "}\n";
         }
@@ -26,6 +26,8 @@ namespace annotations {
 ::std::string const CPP_CONTAINER = "cpp_container";
 ::std::string const GENERATE_CMP = "cpp_cmp";
 ::std::string const GENERATE_IO = "cpp_io";
+/** Servant function is a coroutine returning the result */
+::std::string const CPP_COROUTINE = "cpp_coroutine";
 
 }  /* namespace annotations */
 
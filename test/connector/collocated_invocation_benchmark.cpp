@@ -0,0 +1,86 @@
+/*
+ * collocated_invocation_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <benchmark/benchmark_api.h>
+
+#include <wire/core/adapter.hpp>
+#include <wire/core/connector.hpp>
+
+#include "ping_pong_impl.hpp"
+
+namespace wire {
+namespace test {
+
+namespace {
+
+/**
+ * Connector with a ping_pong servant and a proxy to it.
+ */
+struct collocated_servant {
+    collocated_servant()
+        : io_svc{ ::std::make_shared< asio_config::io_service >() },
+          connector{ core::connector::create_connector(io_svc) },
+          adapter{ connector->create_adapter(core::identity::random(),
+                  { core::endpoint::tcp("127.0.0.1", 0) }) },
+          servant{ ::std::make_shared< ping_pong_server >(nullptr) }
+    {
+        adapter->activate();
+        prx = core::unchecked_cast< ::test::ping_pong_proxy >(
+                adapter->add_object({"ping_pong"}, servant));
+    }
+
+    asio_config::io_service_ptr             io_svc;
+    core::connector_ptr                     connector;
+    core::adapter_ptr                       adapter;
+    ::std::shared_ptr< ping_pong_server >   servant;
+    ::test::ping_pong_prx                   prx;
+};
+
+}  /* namespace  */
+
+void
+BM_DirectVirtualCall(::benchmark::State& state)
+{
+    collocated_servant srv;
+    ::test::ping_pong const& pp = *srv.servant;
+    ::std::int32_t val = 0;
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(pp.test_int(val++, core::no_current));
+    }
+}
+BENCHMARK(BM_DirectVirtualCall);
+
+void
+BM_CollocatedAsyncCall(::benchmark::State& state)
+{
+    collocated_servant srv;
+    ::std::int32_t val = 0;
+    while (state.KeepRunning()) {
+        srv.prx->test_int_async(val++,
+            [](::std::int32_t res)
+            {
+                ::benchmark::DoNotOptimize(res);
+            });
+    }
+}
+BENCHMARK(BM_CollocatedAsyncCall);
+
+void
+BM_CollocatedSyncCall(::benchmark::State& state)
+{
+    collocated_servant srv;
+    ::std::int32_t val = 0;
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(srv.prx->test_int(val++));
+    }
+}
+BENCHMARK(BM_CollocatedSyncCall);
+
+}  /* namespace test */
+}  /* namespace wire */
+
+BENCHMARK_MAIN()
@@ -0,0 +1,125 @@
+/*
+ * collocated_invocation_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+
+#include <wire/core/connector.hpp>
+#include <wire/core/adapter.hpp>
+#include <wire/errors/exceptions.hpp>
+
+#include "ping_pong_impl.hpp"
+
+#include <thread>
+
+namespace wire {
+namespace test {
+
+namespace {
+
+/**
+ * Keeps the current of the last call after the call returns
+ */
+class keep_current_server : public ping_pong_server {
+public:
+    keep_current_server() : ping_pong_server{nullptr} {}
+
+    ::std::int32_t
+    test_int(::std::int32_t val,
+            ::wire::core::current const& curr = ::wire::core::no_current) const override
+    {
+        kept = curr;
+        return val;
+    }
+
+    core::current mutable   kept;
+};
+
+}  /* namespace  */
+
+class CollocatedInvocation : public ::testing::Test {
+protected:
+    void
+    SetUp() override
+    {
+        io_svc = ::std::make_shared< asio_config::io_service >();
+        work.reset(new asio_config::io_service::work(*io_svc));
+        connector = core::connector::create_connector(io_svc);
+        adapter = connector->create_adapter(core::identity::random(),
+                { core::endpoint::tcp("127.0.0.1", 0) });
+        adapter->activate();
+        prx = core::unchecked_cast< ::test::ping_pong_proxy >(
+                adapter->add_object({"ping_pong"},
+                        ::std::make_shared< ping_pong_server >(nullptr)));
+        io_thread = ::std::thread{ [this](){ io_svc->run(); } };
+    }
+    void
+    TearDown() override
+    {
+        io_svc->stop();
+        io_thread.join();
+    }
+
+    asio_config::io_service_ptr                         io_svc;
+    ::std::unique_ptr< asio_config::io_service::work >  work;
+    core::connector_ptr                                 connector;
+    core::adapter_ptr                                   adapter;
+    ::test::ping_pong_prx                               prx;
+    ::std::thread                                       io_thread;
+};
+
+TEST_F(CollocatedInvocation, SyncServant)
+{
+    EXPECT_EQ(42, prx->test_int(42));
+}
+
+TEST_F(CollocatedInvocation, RvalueReferenceParams)
+{
+    // The servant takes the arguments by rvalue reference, the caller's
+    // values must stay intact
+    ::std::string const str{ "collocated" };
+    EXPECT_EQ(str, prx->test_string(str));
+    EXPECT_EQ("collocated", str);
+
+    ::test::data val;
+    val.str = "data";
+    EXPECT_EQ(val, prx->test_struct(val));
+    EXPECT_EQ("data", val.str);
+
+    ::std::string res;
+    prx->test_string_async(str,
+        [&](::std::string const& r)
+        {
+            res = r;
+        });
+    EXPECT_EQ(str, res) << "Collocated call is made in the calling thread";
+}
+
+TEST_F(CollocatedInvocation, ServantKeepsCurrent)
+{
+    auto srv = ::std::make_shared< keep_current_server >();
+    auto keep_prx = core::unchecked_cast< ::test::ping_pong_proxy >(
+            adapter->add_object({"keep_current"}, srv));
+    {
+        core::context_type ctx{ {"key", "value"} };
+        EXPECT_EQ(42, keep_prx->test_int(42, ctx));
+    }
+    EXPECT_EQ("value", srv->kept.get_context()["key"])
+        << "The current owns the context";
+    // The current holds the adapter
+    srv->kept = core::no_current;
+}
+
+TEST_F(CollocatedInvocation, OneWay)
+{
+    auto one_way = prx->wire_one_way();
+    EXPECT_NO_THROW(one_way->wire_ping());
+    EXPECT_THROW(one_way->wire_type(), errors::invalid_one_way_invocation)
+        << "A non-void function cannot be invoked one way";
+}
+
+}  /* namespace test */
+}  /* namespace wire */
@@ -0,0 +1,114 @@
+/*
+ * coroutine_dispatch_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+
+#include <test/coroutine_dispatch.hpp>
+#include <wire/core/connector.hpp>
+#include <wire/core/adapter.hpp>
+#include <wire/core/proxy.hpp>
+
+#include <sstream>
+#include <thread>
+
+namespace wire {
+namespace test {
+
+namespace {
+
+/**
+ * Resumes the coroutine from the I/O service queue, after the dispatch
+ * function has returned and the request state is released.
+ */
+struct resume_later {
+    asio_config::io_service&    io_svc;
+
+    bool
+    await_ready() const noexcept
+    { return false; }
+    void
+    await_suspend(core::coroutine_handle<> h)
+    {
+        io_svc.post([h]() mutable { h.resume(); });
+    }
+    void
+    await_resume() const noexcept {}
+};
+
+class coro_echo_server : public ::test::coro_echo {
+public:
+    coro_echo_server(asio_config::io_service& io_svc) : io_svc_{io_svc} {}
+
+    core::dispatch_task< ::std::string >
+    echo(::std::string val, core::current curr) override
+    {
+        co_await resume_later{ io_svc_ };
+        ::std::string res = val + ":" + curr.get_context()["key"];
+        if (curr.adapter)
+            res += ":adapter";
+        co_return res;
+    }
+private:
+    asio_config::io_service&    io_svc_;
+};
+
+struct CoroutineDispatch : ::testing::Test {
+    void
+    SetUp() override
+    {
+        srv_io = ::std::make_shared< asio_config::io_service >();
+        srv_work.reset(new asio_config::io_service::work(*srv_io));
+        srv_connector = core::connector::create_connector(srv_io);
+        adapter = srv_connector->create_adapter(core::identity::random(),
+                { core::endpoint::tcp("127.0.0.1", 0) });
+        adapter->activate();
+        srv_prx = adapter->add_object({"coro_echo"},
+                ::std::make_shared< coro_echo_server >(*srv_io));
+        srv_thread = ::std::thread{ [this](){ srv_io->run(); } };
+    }
+    void
+    TearDown() override
+    {
+        srv_io->stop();
+        srv_thread.join();
+    }
+
+    asio_config::io_service_ptr                         srv_io;
+    ::std::unique_ptr< asio_config::io_service::work >  srv_work;
+    core::connector_ptr                                 srv_connector;
+    core::adapter_ptr                                   adapter;
+    core::object_prx                                    srv_prx;
+    ::std::thread                                       srv_thread;
+};
+
+}  /* namespace  */
+
+TEST_F(CoroutineDispatch, ArgsOutliveSuspension)
+{
+    auto cl_io = ::std::make_shared< asio_config::io_service >();
+    asio_config::io_service::work cl_work(*cl_io);
+    auto cl_connector = core::connector::create_connector(cl_io);
+    ::std::ostringstream os;
+    os << *srv_prx;
+    auto prx = core::unchecked_cast< ::test::coro_echo_proxy >(
+            cl_connector->string_to_proxy(os.str()));
+    ::std::thread cl_thread{ [cl_io](){ cl_io->run(); } };
+
+    EXPECT_EQ("abc:value:adapter", prx->echo("abc", {{"key", "value"}}));
+
+    cl_io->stop();
+    cl_thread.join();
+}
+
+TEST_F(CoroutineDispatch, CollocatedArgsOutliveSuspension)
+{
+    auto prx = core::unchecked_cast< ::test::coro_echo_proxy >(srv_prx);
+    EXPECT_EQ("abc:value:adapter", prx->echo("abc", {{"key", "value"}}));
+}
+
+}  /* namespace test */
+}  /* namespace wire */
@@ -15,8 +15,10 @@
 #include <wire/core/connection.hpp>
 #include "sparring/sparring_test.hpp"
 
+#include <wire/util/fiber_scheduler.hpp>
+
 #include <boost/fiber/all.hpp>
-#include <pushkin/asio/fiber/shared_work.hpp>
+#include <chrono>
 #include <thread>
 #include <vector>
 
@@ -115,7 +117,6 @@ protected:
     SetUp() override
     {
         connector_ = core::connector::create_connector(io_svc);
-        runner_ = ::psst::asio::fiber::use_shared_work_algorithm( io_svc );
         StartPartner();
     }
 
@@ -137,7 +138,6 @@ protected:
 
     core::connector_ptr             connector_;
     core::object_prx                prx_;
-    ::psst::asio::fiber::runner_ptr runner_;
 };
 
 void
@@ -215,11 +215,11 @@ TEST_F(FiberPingPong, SyncPing)
         threads.emplace_back(
         [&](){
             tag(::std::cerr) << " Thread start\n";
-            auto runner = ::psst::asio::fiber::use_shared_work_algorithm( io_svc );
+            auto& runner = util::fiber::use_io_service_algorithm( io_svc );
             for (auto i = 0; i < fiber_cnt; ++i) {
                 fiber{ test_f, ::std::ref(b) }.detach();
             }
-            runner->run();
+            runner.run();
             tag(::std::cerr) << " Thread exit\n";
         });
     }
@@ -232,6 +232,65 @@ TEST_F(FiberPingPong, SyncPing)
     }
 }
 
+TEST_F(FiberPingPong, PingThroughput)
+{
+    using ::boost::fibers::fiber;
+    using clock_type = ::std::chrono::steady_clock;
+
+    ASSERT_NE(0, child_.pid);
+    ASSERT_TRUE(connector_.get());
+    ASSERT_TRUE(prx_.get());
+
+    const auto fiber_cnt    = 1000;
+    const auto thread_cnt   = 2;
+    const auto call_cnt     = 100;
+    ::std::atomic<int>  finish_cnt{0};
+    ::std::atomic<int>  call_errors{0};
+    auto pp_prx = core::unchecked_cast< ::test::ping_pong_proxy >(prx_);
+
+    auto test_f = [&](){
+        for (auto i = 0; i < call_cnt; ++i) {
+            try {
+                if (pp_prx->test_int(i) != i)
+                    ++call_errors;
+            } catch (...) {
+                ++call_errors;
+            }
+        }
+        if (++finish_cnt == fiber_cnt * thread_cnt) {
+            io_svc->stop();
+        }
+    };
+
+    ::std::vector<::std::thread> threads;
+    threads.reserve(thread_cnt);
+
+    auto start = clock_type::now();
+    for (auto i = 0; i < thread_cnt; ++i) {
+        threads.emplace_back(
+        [&](){
+            auto& runner = util::fiber::use_io_service_algorithm( io_svc );
+            for (auto i = 0; i < fiber_cnt; ++i) {
+                fiber{ test_f }.detach();
+            }
+            runner.run();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ::std::chrono::duration<double> elapsed = clock_type::now() - start;
+
+    EXPECT_EQ(fiber_cnt * thread_cnt, finish_cnt);
+    EXPECT_EQ(0, call_errors);
+    ::std::cerr << "Fibers " << fiber_cnt * thread_cnt
+            << " in " << thread_cnt << " threads, "
+            << fiber_cnt * thread_cnt * call_cnt << " calls in "
+            << elapsed.count() << "s, "
+            << fiber_cnt * thread_cnt * call_cnt / elapsed.count()
+            << " calls/s\n";
+}
+
 //TEST_F(FiberPingPong, CheckedCast)
 //{
 //    using boost::fibers::fiber;
@@ -0,0 +1,163 @@
+/*
+ * protocol_handshake_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+
+#include <wire/core/connector.hpp>
+#include <wire/core/proxy.hpp>
+#include <wire/encoding/message.hpp>
+#include <wire/errors/exceptions.hpp>
+#include <wire/version.hpp>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace wire {
+namespace test {
+
+namespace {
+
+/**
+ * Accepts a connection and sends a validate message with the given
+ * protocol version, reads and discards everything the client sends.
+ */
+class validate_peer {
+public:
+    validate_peer(asio_config::io_service& io_svc, encoding::version const& ver)
+        : acceptor_{io_svc,
+            asio_config::tcp::endpoint{ asio_config::address::from_string("127.0.0.1"), 0 }},
+          socket_{io_svc},
+          version_{ver}
+    {
+        acceptor_.async_accept(socket_,
+            [this](asio_config::error_code const& ec)
+            {
+                if (!ec) {
+                    send_validate();
+                    read();
+                }
+            });
+    }
+
+    ::std::string
+    proxy_string() const
+    {
+        return "ping_pong tcp://127.0.0.1:" +
+                ::std::to_string(acceptor_.local_endpoint().port());
+    }
+private:
+    void
+    send_validate()
+    {
+        using encoding::message;
+        // The message header writes the current protocol version, so the
+        // header is written field by field
+        auto o = ::std::back_inserter(out_);
+        encoding::write(o, encoding::int32_fixed_t(message::MAGIC_NUMBER));
+        encoding::write(o, message::validate_flags);
+        encoding::write(o, version_);
+        encoding::write(o, encoding::version{ ENCODING_MAJOR, ENCODING_MINOR });
+        encoding::write(o, message::size_type{0});
+        asio_ns::async_write(socket_, asio_ns::buffer(out_),
+            [](asio_config::error_code const&, ::std::size_t){});
+    }
+    void
+    read()
+    {
+        socket_.async_read_some(asio_ns::buffer(in_),
+            [this](asio_config::error_code const& ec, ::std::size_t)
+            {
+                if (!ec)
+                    read();
+            });
+    }
+private:
+    asio_config::tcp::acceptor          acceptor_;
+    asio_config::tcp::socket            socket_;
+    encoding::version                   version_;
+    ::std::vector< unsigned char >      out_;
+    ::std::array< unsigned char, 1024 > in_;
+};
+
+}  /* namespace  */
+
+class ProtocolHandshake : public ::testing::Test {
+protected:
+    void
+    SetUp() override
+    {
+        io_svc = ::std::make_shared< asio_config::io_service >();
+        work.reset(new asio_config::io_service::work(*io_svc));
+        io_thread = ::std::thread{ [this](){ io_svc->run(); } };
+    }
+    void
+    TearDown() override
+    {
+        io_svc->stop();
+        io_thread.join();
+    }
+
+    core::object_prx
+    Connect(encoding::version const& ver,
+            core::connector::args_type const& args = core::connector::args_type{})
+    {
+        peer.reset(new validate_peer{*io_svc, ver});
+        connector = core::connector::create_connector(io_svc, args);
+        return connector->string_to_proxy(peer->proxy_string());
+    }
+
+    asio_config::io_service_ptr                         io_svc;
+    ::std::unique_ptr< asio_config::io_service::work >  work;
+    ::std::thread                                       io_thread;
+    ::std::unique_ptr< validate_peer >                  peer;
+    core::connector_ptr                                 connector;
+};
+
+TEST_F(ProtocolHandshake, OlderMinorVersion)
+{
+    auto prx = Connect(encoding::version{ PROTOCOL_MAJOR, 0 });
+    EXPECT_NO_THROW(prx->wire_get_connection())
+        << "Peer with an older minor protocol version is accepted";
+}
+
+TEST_F(ProtocolHandshake, NewerMinorVersion)
+{
+    auto prx = Connect(encoding::version{ PROTOCOL_MAJOR, PROTOCOL_MINOR + 1 });
+    EXPECT_NO_THROW(prx->wire_get_connection())
+        << "Peer with a newer minor protocol version is accepted";
+}
+
+TEST_F(ProtocolHandshake, IncompatibleVersion)
+{
+    auto prx = Connect(encoding::version{ PROTOCOL_MAJOR + 1, 0 });
+    EXPECT_THROW(prx->wire_get_connection(), errors::connection_closed);
+}
+
+TEST_F(ProtocolHandshake, OptimisticIncompatibleVersion)
+{
+    auto prx = Connect(encoding::version{ PROTOCOL_MAJOR + 1, 0 },
+            { "--wire.connector.cm.optimistic_handshake" });
+    EXPECT_THROW(prx->wire_ping(), errors::connection_closed)
+        << "Requests sent before the peer's validate fail with the connection";
+}
+
+TEST_F(ProtocolHandshake, OptimisticUrgentOlderMinorVersion)
+{
+    // The urgent flag is since protocol 0.2
+    auto prx = Connect(encoding::version{ PROTOCOL_MAJOR, 1 },
+            { "--wire.connector.cm.optimistic_handshake" });
+    EXPECT_THROW(prx->wire_ping_async(core::no_context,
+                core::invocation_options{ core::invocation_flags::urgent }).get(),
+            errors::unsupported_feature)
+        << "Urgent request sent before the peer's validate fails alone";
+    EXPECT_NO_THROW(prx->wire_get_connection())
+        << "The connection stays open";
+}
+
+}  /* namespace test */
+}  /* namespace wire */
@@ -0,0 +1,190 @@
+/*
+ * request_allocation_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+
+#include <wire/core/connector.hpp>
+#include <wire/core/adapter.hpp>
+#include <wire/core/proxy.hpp>
+
+#include "ping_pong_impl.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+/**
+ * Counter for the allocations made in the current thread, allocations are
+ * counted only in the threads the test is interested in
+ */
+thread_local ::std::atomic< ::std::size_t >* allocation_counter = nullptr;
+
+}  /* namespace  */
+
+/*
+ * The replacement is global for the test-wire-request-allocations binary,
+ * that's why the test is not a part of test-wire-connector.
+ */
+void*
+operator new(::std::size_t sz)
+{
+    if (allocation_counter)
+        ++*allocation_counter;
+    if (void* p = ::std::malloc(sz ? sz : 1))
+        return p;
+    throw ::std::bad_alloc{};
+}
+
+void
+operator delete(void* p) noexcept
+{
+    ::std::free(p);
+}
+
+void
+operator delete(void* p, ::std::size_t) noexcept
+{
+    ::std::free(p);
+}
+
+namespace wire {
+namespace test {
+
+/**
+ * Heap allocations made in the server thread to dispatch a request and
+ * send the reply. Counted from the dispatch path, not measured yet:
+ *   - read buffer, read callback, incoming message and its buffer (4)
+ *   - reply encapsulation buffers (2)
+ *   - write callback, buffer sequence and write handler (3)
+ * The request state and the reply message come from the pool. The test
+ * records the measured value, set the bound to it once it is known.
+ */
+const ::std::size_t max_server_allocations = 10;
+/**
+ * Heap allocations made in the client threads for a synchronous
+ * invocation. Counted from the invocation path, not measured yet:
+ *   - invocation data, the request message and their buffers (4)
+ *   - pending reply entry and the result state (2)
+ *   - write callback, buffer sequence and write handler (3)
+ *   - read buffer, read callback, incoming message and its buffer (4)
+ * The reply and write completion callbacks are stored inline, wrapping
+ * the caller's callbacks they used to take up to three more allocations.
+ */
+const ::std::size_t max_client_allocations = 14;
+
+class RequestAllocations : public ::testing::Test {
+protected:
+    static constexpr ::std::size_t warm_up_count = 100;
+    static constexpr ::std::size_t request_count = 1000;
+
+    void
+    SetUp() override
+    {
+        srv_io = ::std::make_shared< asio_config::io_service >();
+        srv_work.reset(new asio_config::io_service::work(*srv_io));
+        srv_connector = core::connector::create_connector(srv_io);
+        adapter = srv_connector->create_adapter(core::identity::random(),
+                { core::endpoint::tcp("127.0.0.1", 0) });
+        adapter->activate();
+        auto srv_prx = adapter->add_object({"ping_pong"},
+                ::std::make_shared< ping_pong_server >(nullptr));
+
+        cl_io = ::std::make_shared< asio_config::io_service >();
+        cl_work.reset(new asio_config::io_service::work(*cl_io));
+        cl_connector = core::connector::create_connector(cl_io);
+        ::std::ostringstream os;
+        os << *srv_prx;
+        prx = core::unchecked_cast< ::test::ping_pong_proxy >(
+                cl_connector->string_to_proxy(os.str()));
+
+        srv_thread = ::std::thread{
+            [this]()
+            {
+                allocation_counter = &server_allocations;
+                srv_io->run();
+            }};
+        cl_thread = ::std::thread{
+            [this]()
+            {
+                allocation_counter = &client_allocations;
+                cl_io->run();
+            }};
+
+        // Fill the free lists and grow the buffers
+        for (::std::size_t i = 0; i < warm_up_count; ++i, ++val) {
+            ASSERT_EQ(val, prx->test_int(val));
+        }
+    }
+    void
+    TearDown() override
+    {
+        allocation_counter = nullptr;
+        cl_io->stop();
+        srv_io->stop();
+        cl_thread.join();
+        srv_thread.join();
+    }
+
+    /**
+     * Run the requests and return the per request heap allocations made
+     * in the threads counting to the counter
+     */
+    ::std::size_t
+    run_requests(::std::atomic< ::std::size_t > const& counter)
+    {
+        auto before = counter.load();
+        for (::std::size_t i = 0; i < request_count; ++i, ++val) {
+            EXPECT_EQ(val, prx->test_int(val));
+        }
+        return (counter.load() - before) / request_count;
+    }
+
+    using work_ptr = ::std::unique_ptr< asio_config::io_service::work >;
+
+    ::std::atomic< ::std::size_t >  server_allocations{0};
+    ::std::atomic< ::std::size_t >  client_allocations{0};
+
+    asio_config::io_service_ptr     srv_io;
+    work_ptr                        srv_work;
+    core::connector_ptr             srv_connector;
+    core::adapter_ptr               adapter;
+    ::std::thread                   srv_thread;
+
+    asio_config::io_service_ptr     cl_io;
+    work_ptr                        cl_work;
+    core::connector_ptr             cl_connector;
+    ::test::ping_pong_prx           prx;
+    ::std::thread                   cl_thread;
+
+    ::std::int32_t                  val = 0;
+};
+
+TEST_F(RequestAllocations, ServerSteadyState)
+{
+    auto per_request = run_requests(server_allocations);
+    RecordProperty("allocations_per_request", static_cast<int>(per_request));
+    EXPECT_GE(max_server_allocations, per_request)
+        << "Heap allocations per request in the server thread";
+}
+
+TEST_F(RequestAllocations, ClientSteadyState)
+{
+    // The synchronous invocation runs the client's handlers in the
+    // calling thread as well
+    allocation_counter = &client_allocations;
+    auto per_request = run_requests(client_allocations);
+    allocation_counter = nullptr;
+    RecordProperty("allocations_per_request", static_cast<int>(per_request));
+    EXPECT_GE(max_client_allocations, per_request)
+        << "Heap allocations per invocation in the client threads";
+}
+
+}  /* namespace test */
+}  /* namespace wire */
@@ -14,9 +14,15 @@
 #include <wire/core/object.hpp>
 
 #include <thread>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 #include "test/ping_pong.hpp"
+#include "ping_pong_impl.hpp"
 
 namespace wire {
 namespace test {
@@ -101,5 +107,262 @@ TEST(Connection, SendMulti)
     EXPECT_EQ(84, sum);
 }
 
+/**
+ * Holds test_string responses until the expected number of requests
+ * arrives, records the peers the requests came from.
+ */
+class holding_server : public ping_pong_server {
+public:
+    holding_server(::std::size_t expected)
+        : ping_pong_server{nullptr}, expected_{expected} {}
+
+    void
+    test_string(::std::string&& val,
+            test_string_return_callback __resp,
+            ::wire::core::functional::exception_callback __exception,
+            ::wire::core::current const& curr = ::wire::core::no_current) override
+    {
+        ::std::vector< ::std::pair< test_string_return_callback, ::std::string > > ready;
+        {
+            ::std::lock_guard< ::std::mutex > lock{mtx_};
+            if (::std::find(peers_.begin(), peers_.end(), curr.peer_endpoint) == peers_.end())
+                peers_.push_back(curr.peer_endpoint);
+            held_.emplace_back(__resp, ::std::move(val));
+            if (held_.size() >= expected_)
+                ready.swap(held_);
+        }
+        for (auto& r : ready) {
+            r.first(r.second);
+        }
+    }
+
+    ::std::size_t
+    peer_count() const
+    {
+        ::std::lock_guard< ::std::mutex > lock{mtx_};
+        return peers_.size();
+    }
+private:
+    ::std::size_t const                 expected_;
+    ::std::mutex mutable                mtx_;
+    ::std::vector< core::endpoint >     peers_;
+    ::std::vector< ::std::pair< test_string_return_callback, ::std::string > > held_;
+};
+
+TEST(Connection, ProxyUsesPool)
+{
+    const ::std::size_t request_count = 8;
+    asio_config::io_service_ptr srv_io =
+            ::std::make_shared< asio_config::io_service >();
+    auto srv_work = ::std::make_shared< asio_config::io_service::work >(*srv_io);
+    auto srv_connector = core::connector::create_connector(srv_io);
+    auto adapter = srv_connector->create_adapter( core::identity::random(),
+            { core::endpoint::tcp("127.0.0.1", 0) });
+    adapter->activate();
+    auto server = ::std::make_shared< holding_server >(request_count);
+    auto srv_prx = adapter->add_object({"ping_pong"}, server);
+    ::std::thread srv_thread{[srv_io](){ srv_io->run(); }};
+
+    asio_config::io_service_ptr io_svc =
+            ::std::make_shared< asio_config::io_service >();
+    auto work = ::std::make_shared< asio_config::io_service::work >(*io_svc);
+    auto connector = core::connector::create_connector(io_svc,
+            core::connector::args_type{ "--wire.connector.cm.pool_size=4" });
+    ::std::ostringstream os;
+    os << *srv_prx;
+    auto prx = core::unchecked_cast< ::test::ping_pong_proxy >(
+            connector->string_to_proxy(os.str()));
+    ::std::thread t{[io_svc](){ io_svc->run(); }};
+
+    // The proxy caches a connection
+    EXPECT_EQ(1, prx->test_int(1));
+
+    ::std::atomic< ::std::size_t > replies{0};
+    ::std::atomic< ::std::size_t > errors{0};
+    for (::std::size_t i = 0; i < request_count; ++i) {
+        prx->test_string_async("pool",
+            [&replies](::std::string const&)
+            {
+                ++replies;
+            },
+            [&errors](::std::exception_ptr)
+            {
+                ++errors;
+            });
+    }
+    auto deadline = ::std::chrono::steady_clock::now() + ::std::chrono::seconds{5};
+    while (replies + errors < request_count && ::std::chrono::steady_clock::now() < deadline) {
+        ::std::this_thread::sleep_for(::std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(request_count, replies);
+    EXPECT_EQ(0, errors);
+    EXPECT_LT(1, server->peer_count())
+        << "Concurrent requests of a proxy are spread over the pool";
+
+    work.reset();
+    io_svc->stop();
+    t.join();
+    srv_work.reset();
+    srv_io->stop();
+    srv_thread.join();
+}
+
+TEST(Connection, BulkPool)
+{
+    asio_config::io_service_ptr io_svc =
+            ::std::make_shared< asio_config::io_service >();
+    auto connector = core::connector::create_connector(io_svc);
+    auto adapter = connector->create_adapter( core::identity::random(),
+            { core::endpoint::tcp("127.0.0.1", 0) });
+    adapter->activate();
+    auto endpoints = adapter->published_endpoints();
+    ASSERT_LT(0, endpoints.size());
+    auto ep = endpoints.front();
+
+    auto work = ::std::make_shared< asio_config::io_service::work >(*io_svc);
+    ::std::thread t{[io_svc](){ io_svc->run(); }};
+
+    auto conn = connector->get_outgoing_connection(ep);
+    EXPECT_EQ(conn, connector->get_outgoing_connection(ep))
+        << "Idle connection is reused";
+    auto bulk = connector->get_outgoing_connection(ep,
+            core::invocation_options{ core::invocation_flags::bulk });
+    EXPECT_NE(conn, bulk) << "Bulk invocations use a separate pool";
+    EXPECT_EQ(bulk, connector->get_outgoing_connection(ep,
+            core::invocation_options{ core::invocation_flags::bulk }));
+    EXPECT_EQ(0, conn->outstanding_requests());
+
+    work.reset();
+    io_svc->stop();
+    t.join();
+}
+
+/**
+ * Replies to send_int after a delay, records the maximum number of requests
+ * waiting for a reply at the same time.
+ */
+class window_server : public ::test::notify {
+public:
+    window_server(asio_config::io_service_ptr io_svc) : io_svc_{io_svc} {}
+
+    void
+    send_int(::std::int32_t val,
+            ::wire::core::functional::void_callback __resp,
+            ::wire::core::functional::exception_callback __exception,
+            ::wire::core::current const& = ::wire::core::no_current) override
+    {
+        auto n = ++active_;
+        auto prev = max_active_.load();
+        while (prev < n && !max_active_.compare_exchange_weak(prev, n));
+
+        auto timer = ::std::make_shared< asio_config::system_timer >(*io_svc_);
+        timer->expires_from_now(::std::chrono::milliseconds{10});
+        timer->async_wait(
+            [this, timer, __resp](asio_config::error_code const&)
+            {
+                --active_;
+                __resp();
+            });
+    }
+
+    ::std::size_t
+    max_active() const
+    { return max_active_; }
+private:
+    asio_config::io_service_ptr     io_svc_;
+    ::std::atomic< ::std::size_t >  active_{0};
+    ::std::atomic< ::std::size_t >  max_active_{0};
+};
+
+TEST(Connection, RequestWindow)
+{
+    const ::std::size_t window = 2;
+    asio_config::io_service_ptr srv_io =
+            ::std::make_shared< asio_config::io_service >();
+    auto srv_work = ::std::make_shared< asio_config::io_service::work >(*srv_io);
+    auto srv_connector = core::connector::create_connector(srv_io);
+    auto adapter = srv_connector->create_adapter( core::identity::random(),
+            { core::endpoint::tcp("127.0.0.1", 0) });
+    adapter->activate();
+    auto endpoints = adapter->published_endpoints();
+    ASSERT_LT(0, endpoints.size());
+    auto ep = endpoints.front();
+
+    const ::std::int32_t request_count = 5;
+    ::std::atomic< ::std::size_t > notify_cnt{0};
+    ::std::atomic< ::std::int32_t > sum{0};
+    ::std::atomic< ::std::size_t > sent_cnt{0};
+
+    auto obj = ::std::make_shared< notify_client >(
+        [&notify_cnt, &sum](::std::int32_t v)
+        {
+            sum += v;
+            ++notify_cnt;
+        });
+    adapter->add_object({"obj_a"}, obj);
+    adapter->add_object({"obj_b"}, obj);
+    auto window_obj = ::std::make_shared< window_server >(srv_io);
+    adapter->add_object({"window"}, window_obj);
+    ::std::thread srv_thread{[srv_io](){ srv_io->run(); }};
+
+    // The window is configured on the client side only, the server
+    // doesn't limit dispatch
+    asio_config::io_service_ptr io_svc =
+            ::std::make_shared< asio_config::io_service >();
+    auto work = ::std::make_shared< asio_config::io_service::work >(*io_svc);
+    auto connector = core::connector::create_connector(io_svc,
+            core::connector::args_type{
+                "--wire.connector.cm.max_requests=" + ::std::to_string(window) });
+    ::std::thread t{[io_svc](){ io_svc->run(); }};
+
+    auto conn = connector->get_outgoing_connection(ep);
+    encoding::multiple_targets targets{ { {"obj_a"}, {} }, { {"obj_b"}, {} } };
+    for (::std::int32_t i = 1; i <= request_count; ++i) {
+        // Requests over the window wait in the connection's queue
+        conn->send(targets, "send_int", core::no_context, core::invocation_options{},
+            [](::std::exception_ptr ex)
+            {
+                FAIL() << "Send exception";
+            },
+            [&sent_cnt](bool sent)
+            {
+                ++sent_cnt;
+            }, i);
+    }
+
+    ::std::atomic< ::std::size_t > replies{0};
+    for (::std::int32_t i = 1; i <= request_count; ++i) {
+        conn->invoke(encoding::invocation_target{ {"window"}, {} },
+            "send_int", core::no_context, core::invocation_options{},
+            [&replies]()
+            {
+                ++replies;
+            },
+            [](::std::exception_ptr ex)
+            {
+                FAIL() << "Invocation exception";
+            }, nullptr, i);
+    }
+
+    auto deadline = ::std::chrono::steady_clock::now() + ::std::chrono::seconds{5};
+    while ((notify_cnt < 2 * request_count || replies < request_count)
+            && ::std::chrono::steady_clock::now() < deadline) {
+        ::std::this_thread::sleep_for(::std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(request_count, sent_cnt);
+    EXPECT_EQ(2 * request_count, notify_cnt);
+    EXPECT_EQ(request_count * (request_count + 1), sum);
+    EXPECT_EQ(request_count, replies);
+    EXPECT_GE(window, window_obj->max_active())
+        << "Requests in flight must not exceed the window";
+
+    work.reset();
+    io_svc->stop();
+    t.join();
+    srv_work.reset();
+    srv_io->stop();
+    srv_thread.join();
+}
+
 } // namespace test
 }  /* namespace wire */
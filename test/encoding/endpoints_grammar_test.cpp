@@ -73,7 +73,11 @@ GRAMMAR_PARSE_TEST(grammar::parse::endpoint_grammar, Endpoint, endpoint,
         ParseEndpoint::make_test_data("udp://127.0.0.1:5432",
                 endpoint::udp("127.0.0.1", 5432)),
         ParseEndpoint::make_test_data("socket:///tmp/.123.thasocket",
-                endpoint::socket("/tmp/.123.thasocket"))
+                endpoint::socket("/tmp/.123.thasocket")),
+        ParseEndpoint::make_test_data("shm:///tmp/.123.thashm",
+                endpoint::shm("/tmp/.123.thashm")),
+        ParseEndpoint::make_test_data("inproc://ping_pong/server",
+                endpoint::inproc("ping_pong/server"))
     )
 );
 
@@ -86,7 +90,9 @@ GRAMMAR_TEST(endpoint_list_grammar, EndpointList,
         "udp://127.0.0.1:5432,tcp://localhost:5432,socket:///tmp/.socket",
         "socket:///blabla/.123123/adfa/socket",
         "socket:///tmp/.wire.ping_pong,tcp://127.0.0.1:0",
-        "tcp://eth0[v6]:0,tcp://lo[v4]:0"
+        "tcp://eth0[v6]:0,tcp://lo[v4]:0",
+        "shm:///tmp/.wire.shm,socket:///tmp/.socket",
+        "inproc://wire.ping_pong,tcp://127.0.0.1:0"
     ),
     ::testing::Values(
         "socket:///tmp/.socket, tcp://localhost:5432, udp://127.0.0.1:5432",
@@ -197,6 +197,32 @@ TEST(Endpoint, Construction)
         EXPECT_EQ(transport_type::socket, epo.transport());
         EXPECT_EQ(ep, epo);
     }
+    {
+        buffer_type buffer;
+        endpoint ep{ detail::shm_endpoint_data{ "/tmp/the_shm" } };
+        EXPECT_EQ(transport_type::shm, ep.transport());
+        EXPECT_NO_THROW(encoding::write(std::back_inserter(buffer), ep));
+        endpoint epo;
+        input_iterator b = buffer.begin();
+        input_iterator e = buffer.end();
+        EXPECT_NO_THROW(encoding::read(b, e, epo));
+        EXPECT_EQ(transport_type::shm, epo.transport());
+        EXPECT_EQ(ep, epo);
+        EXPECT_NE(endpoint::socket("/tmp/the_shm"), epo);
+    }
+    {
+        buffer_type buffer;
+        endpoint ep{ detail::inproc_endpoint_data{ "the_inproc" } };
+        EXPECT_EQ(transport_type::inproc, ep.transport());
+        EXPECT_NO_THROW(encoding::write(std::back_inserter(buffer), ep));
+        endpoint epo;
+        input_iterator b = buffer.begin();
+        input_iterator e = buffer.end();
+        EXPECT_NO_THROW(encoding::read(b, e, epo));
+        EXPECT_EQ(transport_type::inproc, epo.transport());
+        EXPECT_EQ(ep, epo);
+        EXPECT_NE(endpoint::socket("the_inproc"), epo);
+    }
     {
         endpoint tcp{ detail::tcp_endpoint_data{ "127.0.0.1", 5678 } };
         endpoint ssl{ detail::ssl_endpoint_data{ "127.0.0.1", 5678 } };
@@ -204,6 +230,34 @@ TEST(Endpoint, Construction)
     }
 }
 
+TEST(Endpoint, RotationLatency)
+{
+    using rotation_type = endpoint_rotation< endpoint_list >;
+    auto a = endpoint::tcp("127.0.0.1", 1001);
+    auto b = endpoint::tcp("127.0.0.1", 1002);
+    auto c = endpoint::tcp("127.0.0.1", 1003);
+    rotation_type rot{ endpoint_list{ a, b, c } };
+
+    auto order = rot.connect_order();
+    ASSERT_EQ(3, order.size());
+    EXPECT_EQ(a, order[0]);
+    EXPECT_EQ(b, order[1]);
+    EXPECT_EQ(c, order[2]);
+
+    rot.failed(a);
+    rot.connected(b, ::std::chrono::milliseconds{10});
+    rot.connected(c, ::std::chrono::milliseconds{1});
+    order = rot.connect_order();
+    ASSERT_EQ(3, order.size());
+    EXPECT_EQ(c, order[0]) << "Fast endpoint goes first";
+    EXPECT_EQ(b, order[1]);
+    EXPECT_EQ(a, order[2]) << "Failed endpoint goes last";
+
+    rot.connected(a, ::std::chrono::milliseconds{1});
+    EXPECT_EQ(a, rot.connect_order().back())
+        << "Single connect doesn't reset the failure penalty";
+}
+
 }  // namespace test
 }  // namespace core
 }  // namespace wire
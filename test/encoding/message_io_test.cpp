@@ -60,6 +60,24 @@ TEST(Message, RequestIOTest)
     EXPECT_EQ(req, req1);
 }
 
+TEST(Message, UrgentFlagIOTest)
+{
+    typedef std::vector<uint8_t>                        buffer_type;
+
+    buffer_type buffer;
+    message m{ message::request | message::urgent, 42 };
+    EXPECT_EQ(message::request, m.type());
+    EXPECT_NO_THROW(write(std::back_inserter(buffer), m));
+    EXPECT_NE(0, buffer.size());
+
+    message m1;
+    auto begin = buffer.begin();
+    EXPECT_TRUE(try_read(begin, buffer.end(), m1));
+    EXPECT_EQ(m, m1);
+    EXPECT_EQ(message::request, m1.type());
+    EXPECT_TRUE(m1.flags & message::urgent);
+}
+
 }  // namespace test
 }  // namespace encoding
 }  // namespace wire
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 #include <wire/encoding/buffers.hpp>
+#include <wire/core/detail/dispatch_request.hpp>
 #include <bitset>
 
 namespace wire {
@@ -235,6 +236,74 @@ TEST(OutgoingBuffer, MessageHeaders)
     EXPECT_EQ(req, req1);
 }
 
+TEST(OutgoingBuffer, ReplyWriter)
+{
+    using buffer_type = ::std::vector<char>;
+    auto flatten = [](outgoing const& out)
+        {
+            buffer_type data;
+            auto buffers = out.to_buffers();
+            for (auto const& buff : *buffers) {
+                char const* bdata = reinterpret_cast<char const*>(
+                        asio_ns::detail::buffer_cast_helper(buff));
+                data.insert(data.end(), bdata,
+                        bdata + asio_ns::detail::buffer_size_helper(buff));
+            }
+            return data;
+        };
+    auto read_reply = [](buffer_type const& data, reply& rep, ::std::string& str)
+        {
+            auto begin = data.begin();
+            message m;
+            read(begin, data.end(), m);
+            EXPECT_EQ(data.end() - begin, m.size);
+            incoming in{ core::connector_ptr{}, m, begin, data.end() };
+            incoming::const_iterator b = in.begin();
+            incoming::const_iterator e = in.end();
+            read(b, e, rep);
+            incoming::encaps_guard encaps{ in.begin_encapsulation(b) };
+            auto eb = encaps->begin();
+            read(eb, encaps->end(), str);
+        };
+
+    core::detail::dispatch_request req{
+        ::std::make_shared< incoming >(core::connector_ptr{}, message{ message::request, 0 }),
+        {}, {}, 0, nullptr, nullptr, 42, message::reply | message::urgent
+    };
+    // Reply built from a separate result buffer
+    outgoing res{ core::connector_ptr{} };
+    write(::std::back_inserter(res), LIPSUM_TEST_STRING);
+    res.close_all_encaps();
+    outgoing expected{ core::connector_ptr{}, req.reply_flags };
+    write(::std::back_inserter(expected), reply{ req.number, reply::success });
+    expected.insert_encapsulation(::std::move(res));
+
+    // Result written directly to the reply
+    outgoing out = req.reply_writer();
+    EXPECT_EQ(message::reply, out.type());
+    EXPECT_TRUE(out.flags() & message::urgent);
+    write(::std::back_inserter(out), LIPSUM_TEST_STRING);
+    out.current_encapsulation().end_encaps();
+
+    reply rep;
+    ::std::string str;
+    read_reply(flatten(expected), rep, str);
+    EXPECT_EQ(req.number, rep.number);
+    EXPECT_EQ(LIPSUM_TEST_STRING, str);
+
+    auto data = flatten(out);
+    EXPECT_GE(flatten(expected).size(), data.size());
+    rep = reply{};
+    str.clear();
+    read_reply(data, rep, str);
+    EXPECT_EQ(req.number, rep.number);
+    EXPECT_EQ(reply::success, rep.status);
+    EXPECT_EQ(LIPSUM_TEST_STRING, str);
+
+    req.reply_flags = message::request;
+    EXPECT_TRUE(req.reply_writer().empty()) << "No reply is prepared for one-way requests";
+}
+
 }  // namespace test
 }  // namespace encoding
 }  // namespace wire
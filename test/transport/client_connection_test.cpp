@@ -9,6 +9,8 @@
 #include <wire/core/connection.hpp>
 #include <wire/core/transport.hpp>
 #include <wire/core/connector.hpp>
+#include <wire/core/adapter.hpp>
+#include <wire/core/object.hpp>
 #include <wire/core/reference.hpp>
 #include <wire/core/proxy.hpp>
 
@@ -17,6 +19,7 @@
 
 #include <sstream>
 #include <bitset>
+#include <thread>
 
 namespace wire {
 namespace core {
@@ -135,6 +138,46 @@ TEST_F(Client, TCPConnect)
     EXPECT_FALSE(error);
 }
 
+TEST_F(Client, TCPConnectOptimistic)
+{
+    typedef transport_type_traits< transport_type::tcp > used_transport;
+    current_transport = used_transport::value;
+    add_args.insert(add_args.end(), {
+        "--validate-message",
+        "-r2"
+    });
+    StartPartner();
+
+    ASSERT_NE(0, child_.pid);
+    ASSERT_EQ(used_transport::value, endpoint_.transport());
+
+    connector::args_type config {
+        "--wire.connector.cm.optimistic_handshake"
+    };
+    connector_ptr cnctr = connector::create_connector(io_svc, config);
+    adapter_ptr bidir = cnctr->bidir_adapter();
+    connection c{client_side{}, bidir, endpoint_.transport(), [](connection const*){}};
+
+    bool connected = false;
+    bool error = false;
+
+    c.connect_async(endpoint_,
+    [&](){
+        connected = true;
+        c.close();
+        io_svc->stop();
+    },
+    [&](std::exception_ptr) {
+        error = true;
+        io_svc->stop();
+    });
+
+    io_svc->run();
+
+    EXPECT_TRUE(connected);
+    EXPECT_FALSE(error);
+}
+
 TEST_F(Client, TCPConnectFail)
 {
     typedef transport_type_traits< transport_type::tcp > used_transport;
@@ -608,6 +651,38 @@ TEST_F(Client, SSLNoClientCert)
     EXPECT_TRUE(error);
 }
 
+TEST(OptimisticHandshake, InprocPing)
+{
+    auto io_svc = ::std::make_shared< asio_config::io_service >();
+    asio_config::io_service::work work(*io_svc);
+    endpoint ep = endpoint::inproc("wire.test.optimistic");
+
+    connector_ptr server = connector::create_connector(io_svc);
+    adapter_ptr adptr = server->create_adapter("optimistic"_wire_id, { ep });
+    adptr->activate();
+    auto obj = adptr->add_object(::std::make_shared< object >());
+
+    connector::args_type config {
+        "--wire.connector.cm.optimistic_handshake"
+    };
+    connector_ptr client = connector::create_connector(io_svc, config);
+    ::std::thread t{ [&](){ io_svc->run(); } };
+
+    reference_data ref { obj->wire_identity(), {}, {}, { ep } };
+    ::std::ostringstream os;
+    os << ref;
+
+    // The validate message and the request are sent back to back, the
+    // server must dispatch the request after it has read the validate
+    auto prx = client->string_to_proxy(os.str());
+    ASSERT_TRUE(prx.get());
+    EXPECT_NO_THROW(prx->wire_ping());
+    EXPECT_NO_THROW(prx->wire_ping());
+
+    io_svc->stop();
+    t.join();
+}
+
 }  // namespace test
 }  // namespace core
 }  // namespace wire
@@ -0,0 +1,153 @@
+/*
+ * dispatch_executor_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/dispatch_executor.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+TEST(DispatchExecutor, Unordered)
+{
+    const int task_count = 1000;
+    ::std::atomic<int> done{0};
+    {
+        dispatch_executor executor{4, dispatch_ordering::unordered};
+        EXPECT_EQ(4, executor.threads());
+        for (int i = 0; i < task_count; ++i) {
+            executor.post([&done](){ ++done; });
+        }
+        executor.wait();
+        EXPECT_EQ(task_count, done);
+        executor.post([&done](){ ++done; });
+    }
+    EXPECT_EQ(task_count + 1, done) << "Destructor waits for tasks";
+}
+
+TEST(DispatchExecutor, KeyOrder)
+{
+    const ::std::size_t key_count = 8;
+    const int task_count = 500;
+    using sequence = ::std::vector<int>;
+
+    ::std::vector<sequence> results(key_count);
+    ::std::vector<::std::atomic<int>> running(key_count);
+    ::std::atomic<bool> overlap{false};
+
+    dispatch_executor executor{4, dispatch_ordering::connection};
+    for (int i = 0; i < task_count; ++i) {
+        for (::std::size_t k = 0; k < key_count; ++k) {
+            executor.post(k, [&, k, i]()
+                {
+                    if (running[k]++ > 0)
+                        overlap = true;
+                    results[k].push_back(i);
+                    --running[k];
+                });
+        }
+    }
+    executor.wait();
+    EXPECT_FALSE(overlap) << "Tasks with the same key never run concurrently";
+    for (auto const& seq : results) {
+        ASSERT_EQ(task_count, seq.size());
+        for (int i = 0; i < task_count; ++i) {
+            EXPECT_EQ(i, seq[i]);
+        }
+    }
+}
+
+TEST(DispatchExecutor, SlowTaskDoesntBlockOthers)
+{
+    ::std::mutex mtx;
+    ::std::unique_lock<::std::mutex> blocker{mtx};
+    ::std::atomic<int> done{0};
+
+    dispatch_executor executor{2, dispatch_ordering::connection};
+    executor.post(0, [&mtx](){ ::std::lock_guard<::std::mutex> lock{mtx}; });
+    executor.post(1, [&done](){ ++done; });
+    executor.post(2, [&done](){ ++done; });
+    for (int i = 0; i < 1000 && done < 2; ++i) {
+        ::std::this_thread::sleep_for(::std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(2, done);
+    blocker.unlock();
+    executor.wait();
+}
+
+TEST(DispatchExecutor, UrgentLane)
+{
+    const int backlog = 200;
+    for (auto order : { dispatch_ordering::unordered, dispatch_ordering::connection }) {
+        ::std::mutex mtx;
+        ::std::unique_lock<::std::mutex> blocker{mtx};
+        ::std::mutex seq_mtx;
+        ::std::vector<int> seq;
+        auto record = [&](int i)
+            {
+                ::std::lock_guard<::std::mutex> lock{seq_mtx};
+                seq.push_back(i);
+            };
+
+        dispatch_executor executor{1, order};
+        // Occupy the only worker, so that the normal tasks pile up
+        executor.post([&mtx](){ ::std::lock_guard<::std::mutex> lock{mtx}; });
+        for (int i = 0; i < backlog; ++i) {
+            if (order == dispatch_ordering::unordered) {
+                executor.post([&record, i](){ record(i); });
+            } else {
+                executor.post(0, [&record, i](){ record(i); });
+            }
+        }
+        executor.post_urgent([&record](){ record(-1); });
+        blocker.unlock();
+        executor.wait();
+
+        ASSERT_EQ(backlog + 1, seq.size());
+        EXPECT_EQ(-1, seq.front()) << "Urgent task runs ahead of the backlog";
+    }
+}
+
+TEST(DispatchExecutor, MoreThreadsThanCores)
+{
+    // All the tasks block until every one of them is running, this
+    // completes only if the executor really runs all its threads
+    ::std::size_t const threads = ::std::thread::hardware_concurrency() + 2;
+    ::std::mutex mtx;
+    ::std::condition_variable cv;
+    ::std::size_t running = 0;
+    bool all_running = true;
+    {
+        dispatch_executor executor{threads, dispatch_ordering::unordered};
+        for (::std::size_t i = 0; i < threads; ++i) {
+            executor.post([&]()
+                {
+                    ::std::unique_lock<::std::mutex> lock{mtx};
+                    if (++running == threads)
+                        cv.notify_all();
+                    if (!cv.wait_for(lock, ::std::chrono::seconds{5},
+                            [&](){ return running == threads; }))
+                        all_running = false;
+                });
+        }
+        executor.wait();
+    }
+    EXPECT_EQ(threads, running);
+    EXPECT_TRUE(all_running);
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,100 @@
+/*
+ * inproc_transport_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/transport.hpp>
+
+#include <array>
+#include <string>
+
+namespace wire {
+namespace core {
+namespace test {
+
+TEST(Inproc, ConnectRefused)
+{
+    auto io_svc = ::std::make_shared< asio_config::io_service >();
+    inproc_transport client{ io_svc };
+    asio_config::error_code res;
+    client.connect_async(endpoint::inproc("wire.test.nobody"),
+        [&](asio_config::error_code const& ec)
+        {
+            res = ec;
+        });
+    io_svc->run();
+    EXPECT_EQ(asio_config::error::connection_refused, res);
+    EXPECT_FALSE(client.is_open());
+}
+
+TEST(Inproc, NameBusy)
+{
+    inproc_acceptor first, second;
+    first.open("wire.test.busy", [](inproc_transport&){});
+    EXPECT_TRUE(first.is_open());
+    EXPECT_THROW(second.open("wire.test.busy", [](inproc_transport&){}),
+            asio_config::system_error);
+    first.close();
+    EXPECT_NO_THROW(second.open("wire.test.busy", [](inproc_transport&){}));
+}
+
+TEST(Inproc, ReadWrite)
+{
+    auto io_svc = ::std::make_shared< asio_config::io_service >();
+    inproc_transport server{ io_svc };
+    inproc_acceptor acceptor;
+    acceptor.open("wire.test.rw",
+        [&](inproc_transport& client)
+        {
+            server.accept(client, acceptor.name());
+        });
+
+    inproc_transport client{ io_svc };
+    asio_config::error_code conn_ec = asio_config::error::not_connected;
+    client.connect_async(endpoint::inproc("wire.test.rw"),
+        [&](asio_config::error_code const& ec)
+        {
+            conn_ec = ec;
+        });
+    io_svc->run();
+    io_svc->reset();
+    ASSERT_FALSE(conn_ec) << conn_ec.message();
+    ASSERT_TRUE(server.is_open());
+    EXPECT_EQ(endpoint::inproc("wire.test.rw"), client.remote_endpoint());
+
+    ::std::string const msg{"the message to the server"};
+    ::std::array<char, 10> buffer;
+    ::std::string received;
+    bool eof = false;
+    ::std::function< void(asio_config::error_code const&, ::std::size_t) > on_read =
+        [&](asio_config::error_code const& ec, ::std::size_t sz)
+        {
+            if (ec) {
+                eof = ec == asio_config::error::eof;
+                return;
+            }
+            received.append(buffer.data(), sz);
+            server.async_read(asio_ns::buffer(buffer), on_read);
+        };
+    server.async_read(asio_ns::buffer(buffer), on_read);
+
+    ::std::size_t written = 0;
+    client.async_write(asio_ns::buffer(msg),
+        [&](asio_config::error_code const& ec, ::std::size_t sz)
+        {
+            EXPECT_FALSE(ec);
+            written = sz;
+            client.close();
+        });
+    io_svc->run();
+    EXPECT_EQ(msg.size(), written);
+    EXPECT_EQ(msg, received);
+    EXPECT_TRUE(eof) << "The reader gets eof when the peer closes";
+}
+
+}  /* namespace test */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,142 @@
+/*
+ * observer_container_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/observer_container.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+namespace {
+
+struct counting_observer : connection_observer {
+    void
+    send_bytes(::std::size_t bytes, endpoint const& ep) const noexcept override
+    {
+        ++send_events;
+        sent += bytes;
+    }
+    void
+    invoke_remote(request_number req_no,
+            invocation_target const& id, operation_id const& op,
+            endpoint const& ep) const noexcept override
+    {
+        ++invocations;
+    }
+
+    mutable ::std::atomic<int>              send_events{0};
+    mutable ::std::atomic<::std::size_t>    sent{0};
+    mutable ::std::atomic<int>              invocations{0};
+};
+
+struct ordering_observer : connection_observer {
+    void
+    invoke_remote(request_number req_no,
+            invocation_target const& id, operation_id const& op,
+            endpoint const& ep) const noexcept override
+    {
+        if (active.fetch_add(1) != 0)
+            ++overlaps;
+        if (req_no != last + 1)
+            ++out_of_order;
+        last = req_no;
+        ++invocations;
+        --active;
+    }
+
+    mutable ::std::atomic<int>              active{0};
+    mutable ::std::atomic<int>              overlaps{0};
+    mutable ::std::atomic<int>              out_of_order{0};
+    mutable ::std::atomic<int>              invocations{0};
+    mutable request_number                  last = 0;
+};
+
+}  /* namespace  */
+
+#ifndef WIRE_NO_CONNECTION_OBSERVERS
+TEST(ObserverContainer, PerEvent)
+{
+    auto svc = ::std::make_shared< asio_config::io_service >();
+    auto observer = ::std::make_shared< counting_observer >();
+    observer_container container{svc};
+    EXPECT_FALSE(container.has_observers());
+    container.send_bytes(100, endpoint{});
+    svc->poll();
+    EXPECT_EQ(0, observer->send_events);
+
+    svc->reset();
+    container.add_observer(observer);
+    EXPECT_TRUE(container.has_observers());
+    for (int i = 0; i < 10; ++i) {
+        container.send_bytes(100, endpoint{});
+        container.invoke_remote(i, {}, {}, endpoint{});
+    }
+    EXPECT_EQ(20, svc->poll());
+    EXPECT_EQ(10, observer->send_events);
+    EXPECT_EQ(1000, observer->sent);
+    EXPECT_EQ(10, observer->invocations);
+}
+
+TEST(ObserverContainer, Batched)
+{
+    auto svc = ::std::make_shared< asio_config::io_service >();
+    auto observer = ::std::make_shared< counting_observer >();
+    observer_container container{svc, true};
+    container.add_observer(observer);
+    for (int i = 0; i < 10; ++i) {
+        container.send_bytes(100, endpoint{});
+        container.invoke_remote(i, {}, {}, endpoint{});
+    }
+    EXPECT_EQ(1, svc->poll()) << "All events are delivered by a single handler";
+    EXPECT_EQ(1, observer->send_events) << "Byte counts are aggregated";
+    EXPECT_EQ(1000, observer->sent);
+    EXPECT_EQ(10, observer->invocations);
+
+    container.send_bytes(50, endpoint{});
+    svc->reset();
+    EXPECT_EQ(1, svc->poll());
+    EXPECT_EQ(2, observer->send_events);
+    EXPECT_EQ(1050, observer->sent);
+}
+
+TEST(ObserverContainer, BatchedOrder)
+{
+    const int event_count = 100000;
+    auto svc = ::std::make_shared< asio_config::io_service >();
+    auto observer = ::std::make_shared< ordering_observer >();
+    observer_container container{svc, true};
+    container.add_observer(observer);
+
+    ::std::vector<::std::thread> threads;
+    {
+        asio_config::io_service::work work{*svc};
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([svc](){ svc->run(); });
+        }
+        for (int i = 1; i <= event_count; ++i) {
+            container.invoke_remote(i, {}, {}, endpoint{});
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(event_count, observer->invocations);
+    EXPECT_EQ(0, observer->overlaps) << "Drain handlers must not run concurrently";
+    EXPECT_EQ(0, observer->out_of_order);
+}
+#endif
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
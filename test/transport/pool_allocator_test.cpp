@@ -0,0 +1,210 @@
+/*
+ * pool_allocator_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/pool_allocator.hpp>
+#include <wire/core/current.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+::std::atomic< ::std::size_t > heap_allocations{0};
+
+}  /* namespace  */
+
+/*
+ * The replacement is global for the test-wire-pool-allocator binary,
+ * that's why the test is not a part of test-wire-transport.
+ */
+void*
+operator new(::std::size_t sz)
+{
+    ++heap_allocations;
+    if (void* p = ::std::malloc(sz ? sz : 1))
+        return p;
+    throw ::std::bad_alloc{};
+}
+
+void
+operator delete(void* p) noexcept
+{
+    ::std::free(p);
+}
+
+void
+operator delete(void* p, ::std::size_t) noexcept
+{
+    ::std::free(p);
+}
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+namespace {
+
+/**
+ * Shaped like the state of an incoming request
+ */
+struct request_state {
+    encoding::request           req;
+    context_type                context;
+    encoding::multiple_targets  targets;
+    current                     curr;
+};
+
+using state_ptr = ::std::shared_ptr< request_state >;
+
+state_ptr
+make_state()
+{
+    return ::std::allocate_shared< request_state >(pool_allocator< request_state >{});
+}
+
+}  /* namespace  */
+
+TEST(PoolAllocator, SteadyStateDoesntAllocate)
+{
+    const ::std::size_t request_count = 1000;
+    // Warm up the pool
+    make_state();
+
+    auto before = heap_allocations.load();
+    for (::std::size_t i = 0; i < request_count; ++i) {
+        auto st = make_state();
+        st->req.number = i;
+        st->curr.operation = st->req.operation;
+        ::std::weak_ptr< request_state > weak = st;
+        context_const_ptr ctx{ st, &st->context };
+        EXPECT_FALSE(weak.expired());
+    }
+    EXPECT_EQ(before, heap_allocations.load())
+        << "Pooled request state is not allocated in the heap";
+}
+
+TEST(PoolAllocator, FreeListIsBounded)
+{
+    using allocator_type = pool_allocator< request_state >;
+    using pool_type = allocator_type::pool_type;
+    const ::std::size_t max_free = pool_type::max_free;
+    allocator_type alloc;
+    ::std::vector< request_state* > blocks;
+    for (::std::size_t i = 0; i < max_free * 2; ++i) {
+        blocks.push_back(alloc.allocate(1));
+    }
+    for (auto p : blocks) {
+        alloc.deallocate(p, 1);
+    }
+    EXPECT_EQ(max_free, pool_type::free_blocks());
+}
+
+TEST(PoolAllocator, ReleaseInOtherThread)
+{
+    using allocator_type = pool_allocator< request_state >;
+    using pool_type = allocator_type::pool_type;
+    allocator_type alloc;
+    // Empty the current thread's list
+    ::std::vector< request_state* > blocks;
+    while (pool_type::free_blocks() > 0) {
+        blocks.push_back(alloc.allocate(1));
+    }
+    request_state* p = alloc.allocate(1);
+    ::std::size_t other_free = 0;
+    ::std::thread t{
+        [&]()
+        {
+            alloc.deallocate(p, 1);
+            other_free = pool_type::free_blocks();
+        }};
+    t.join();
+    EXPECT_EQ(0, other_free)
+        << "Block is not kept by the releasing thread";
+
+    auto before = heap_allocations.load();
+    EXPECT_EQ(p, alloc.allocate(1))
+        << "Block is returned to the allocating thread";
+    EXPECT_EQ(before, heap_allocations.load());
+    alloc.deallocate(p, 1);
+    for (auto b : blocks) {
+        alloc.deallocate(b, 1);
+    }
+}
+
+TEST(PoolAllocator, ReleaseAfterOwnerExit)
+{
+    using allocator_type = pool_allocator< request_state >;
+    allocator_type alloc;
+    ::std::vector< request_state* > blocks;
+    ::std::thread t{
+        [&]()
+        {
+            for (int i = 0; i < 10; ++i) {
+                blocks.push_back(alloc.allocate(1));
+            }
+            alloc.deallocate(blocks.back(), 1);
+            blocks.pop_back();
+        }};
+    t.join();
+    // The owner's pool is gone, the blocks go to the heap
+    for (auto b : blocks) {
+        alloc.deallocate(b, 1);
+    }
+}
+
+namespace {
+
+/**
+ * Releases a block in a thread local destructor, constructed before the
+ * pool is created, so it is destroyed after the pool
+ */
+struct release_on_exit {
+    request_state*  block = nullptr;
+    ~release_on_exit()
+    {
+        if (block) {
+            pool_allocator< request_state > alloc;
+            alloc.deallocate(block, 1);
+            // Allocations after the pool is destroyed bypass it
+            alloc.deallocate(alloc.allocate(1), 1);
+        }
+    }
+};
+
+}  /* namespace  */
+
+TEST(PoolAllocator, ReleaseInThreadLocalDestructor)
+{
+    ::std::thread t{
+        []()
+        {
+            static thread_local release_on_exit holder;
+            pool_allocator< request_state > alloc;
+            holder.block = alloc.allocate(1);
+        }};
+    t.join();
+}
+
+TEST(PoolAllocator, Arrays)
+{
+    pool_allocator< int > alloc;
+    int* p = alloc.allocate(16);
+    for (int i = 0; i < 16; ++i)
+        p[i] = i;
+    alloc.deallocate(p, 16);
+    EXPECT_TRUE(alloc == pool_allocator< char >{});
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,128 @@
+/*
+ * request_table_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/request_table.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+using string_table = request_table< ::std::string, 4 >;
+
+TEST(RequestTable, InsertTake)
+{
+    string_table table;
+    EXPECT_TRUE(table.empty());
+    EXPECT_FALSE(table.contains(1));
+
+    table.insert(1, "one");
+    table.insert(2, "two");
+    EXPECT_EQ(2, table.size());
+    EXPECT_TRUE(table.contains(1));
+    EXPECT_FALSE(table.contains(5)) << "Same slot, different generation";
+
+    ::std::string val;
+    EXPECT_FALSE(table.take(5, val));
+    EXPECT_TRUE(table.take(1, val));
+    EXPECT_EQ("one", val);
+    EXPECT_FALSE(table.take(1, val)) << "Double completion";
+    EXPECT_EQ(1, table.size());
+
+    EXPECT_TRUE(table.modify(2, [](::std::string& v){ v += "!"; }));
+    EXPECT_FALSE(table.modify(6, [](::std::string& v){ v.clear(); }));
+    EXPECT_TRUE(table.take(2, val));
+    EXPECT_EQ("two!", val);
+    EXPECT_TRUE(table.empty());
+}
+
+TEST(RequestTable, Overflow)
+{
+    string_table table;
+    for (::std::uint64_t i = 1; i <= 10; ++i) {
+        table.insert(i, ::std::to_string(i));
+    }
+    EXPECT_EQ(10, table.size());
+    auto keys = table.keys();
+    ::std::sort(keys.begin(), keys.end());
+    ASSERT_EQ(10, keys.size());
+    for (::std::uint64_t i = 1; i <= 10; ++i) {
+        EXPECT_EQ(i, keys[i - 1]);
+        EXPECT_TRUE(table.contains(i));
+    }
+    ::std::string val;
+    for (::std::uint64_t i = 10; i > 0; --i) {
+        EXPECT_TRUE(table.take(i, val));
+        EXPECT_EQ(::std::to_string(i), val);
+    }
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.keys().empty());
+}
+
+TEST(RequestTable, Capacity)
+{
+    EXPECT_EQ(4, string_table{}.capacity());
+    EXPECT_EQ(4, string_table{2}.capacity());
+    EXPECT_EQ(32, string_table{10}.capacity())
+        << "Twice the expected size rounded up to a power of two";
+
+    string_table table{10};
+    for (::std::uint64_t i = 1; i <= 10; ++i) {
+        table.insert(i, ::std::to_string(i));
+    }
+    EXPECT_EQ(10, table.size());
+    ::std::string val;
+    for (::std::uint64_t i = 1; i <= 10; ++i) {
+        EXPECT_TRUE(table.take(i, val));
+        EXPECT_EQ(::std::to_string(i), val);
+    }
+    EXPECT_TRUE(table.empty());
+}
+
+TEST(RequestTable, ConcurrentCompletion)
+{
+    request_table< ::std::uint64_t, 64 > table;
+    ::std::uint64_t const request_count = 10000;
+    ::std::atomic< ::std::uint64_t > completed{0};
+    ::std::atomic< ::std::uint64_t > next{1};
+    ::std::atomic< bool > done{false};
+
+    auto complete = [&]()
+    {
+        while (!done || !table.empty()) {
+            for (auto k : table.keys()) {
+                ::std::uint64_t v;
+                if (table.take(k, v)) {
+                    EXPECT_EQ(k, v);
+                    ++completed;
+                }
+            }
+        }
+    };
+    ::std::thread c1{complete};
+    ::std::thread c2{complete};
+    for (::std::uint64_t i = 0; i < request_count; ++i) {
+        auto k = next++;
+        table.insert(k, ::std::uint64_t{k});
+    }
+    done = true;
+    c1.join();
+    c2.join();
+    EXPECT_EQ(request_count, completed);
+    EXPECT_TRUE(table.empty());
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
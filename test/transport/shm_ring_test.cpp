@@ -0,0 +1,183 @@
+/*
+ * shm_ring_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/shm_ring.hpp>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+namespace {
+
+using buffers_type = ::std::vector< asio_ns::const_buffer >;
+
+}  /* namespace  */
+
+TEST(SHMRing, WrapAround)
+{
+    ::std::size_t const capacity = 64;
+    ::std::vector< char > mem(shm_ring::memory_size(capacity) + 64);
+    void* aligned = reinterpret_cast<void*>(
+            (reinterpret_cast< ::std::uintptr_t >(mem.data()) + 63) & ~::std::uintptr_t{63});
+    shm_ring ring{ aligned, capacity, true };
+    EXPECT_TRUE(ring.empty());
+
+    ::std::string data(48, 'a');
+    char out[64];
+    EXPECT_EQ(48, ring.write(buffers_type{ asio_ns::buffer(data) }, 0));
+    EXPECT_EQ(40, ring.read(out, 40));
+
+    ::std::string more{"0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnop"};
+    auto n = ring.write(buffers_type{ asio_ns::buffer(more) }, 0);
+    EXPECT_EQ(56, n) << "Write is limited by free space";
+    EXPECT_EQ(capacity, ring.size());
+    EXPECT_EQ(0, ring.write(buffers_type{ asio_ns::buffer(more) }, n));
+
+    EXPECT_EQ(8, ring.read(out, 8));
+    EXPECT_EQ(::std::string(8, 'a'), ::std::string(out, 8));
+    EXPECT_EQ(56, ring.read(out, sizeof(out)));
+    EXPECT_EQ(more.substr(0, 56), ::std::string(out, 56));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SHMRing, BufferOffset)
+{
+    ::std::size_t const capacity = 64;
+    ::std::vector< char > mem(shm_ring::memory_size(capacity) + 64);
+    void* aligned = reinterpret_cast<void*>(
+            (reinterpret_cast< ::std::uintptr_t >(mem.data()) + 63) & ~::std::uintptr_t{63});
+    shm_ring ring{ aligned, capacity, true };
+    ::std::string a{"abcd"}, b{"efgh"};
+    EXPECT_EQ(3, ring.write(buffers_type{ asio_ns::buffer(a), asio_ns::buffer(b) }, 5));
+    char out[8];
+    EXPECT_EQ(3, ring.read(out, sizeof(out)));
+    EXPECT_EQ("fgh", ::std::string(out, 3));
+}
+
+TEST(SHMRing, WaitFlags)
+{
+    ::std::size_t const capacity = 64;
+    ::std::vector< char > mem(shm_ring::memory_size(capacity) + 64);
+    void* aligned = reinterpret_cast<void*>(
+            (reinterpret_cast< ::std::uintptr_t >(mem.data()) + 63) & ~::std::uintptr_t{63});
+    shm_ring ring{ aligned, capacity, true };
+    EXPECT_FALSE(ring.take_reader_waiting());
+    ring.set_reader_waiting();
+    EXPECT_TRUE(ring.take_reader_waiting());
+    EXPECT_FALSE(ring.take_reader_waiting()) << "Flag is cleared when taken";
+    ring.set_writer_waiting();
+    EXPECT_TRUE(ring.take_writer_waiting());
+    EXPECT_FALSE(ring.closed());
+    ring.close();
+    EXPECT_TRUE(ring.closed());
+}
+
+TEST(SHMRing, InvalidCapacity)
+{
+    ::std::vector< char > mem(shm_ring::memory_size(100));
+    EXPECT_ANY_THROW((shm_ring{ mem.data(), 100, true }));
+}
+
+TEST(SHMSegment, PassDescriptors)
+{
+    int fds[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+    shm_segment server;
+    server.create(4096);
+    asio_config::error_code ec;
+    server.send(fds[0], ec);
+    ASSERT_FALSE(ec) << ec.message();
+
+    shm_segment client;
+    client.receive(fds[1], ec);
+    ASSERT_FALSE(ec) << ec.message();
+    ASSERT_TRUE(client.valid());
+
+    ::std::string msg{"hello from server"};
+    EXPECT_EQ(msg.size(), server.outgoing(shm_segment::server).write(
+            buffers_type{ asio_ns::buffer(msg) }, 0));
+    char out[64];
+    auto n = client.incoming(shm_segment::client).read(out, sizeof(out));
+    EXPECT_EQ(msg, ::std::string(out, n));
+
+    client.notify(shm_segment::server);
+    ::std::uint64_t counter = 0;
+    EXPECT_EQ(sizeof(counter), ::read(server.wait_fd(shm_segment::server), &counter, sizeof(counter)));
+    EXPECT_EQ(1, counter);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST(SHMSegment, InvalidPeerCapacity)
+{
+    // 4096 matches the size, but the rings were never initialized
+    for (::std::uint64_t capacity : { ::std::uint64_t{0}, ::std::uint64_t{100},
+            ::std::uint64_t{4096}, ::std::uint64_t{8192}, ::std::uint64_t{1} << 40 }) {
+        int fds[2];
+        ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+        // Memory for two rings of 4096 bytes
+        shm_segment server;
+        server.create(4096);
+        int seg_fds[3] = {
+            ::memfd_create("wire.test", MFD_CLOEXEC),
+            server.wait_fd(shm_segment::server),
+            server.wait_fd(shm_segment::client)
+        };
+        ASSERT_LE(0, seg_fds[0]);
+        ASSERT_EQ(0, ::ftruncate(seg_fds[0], 2 * shm_ring::memory_size(4096)));
+
+        ::iovec iov{ &capacity, sizeof(capacity) };
+        char control[CMSG_SPACE(sizeof(seg_fds))] = {};
+        ::msghdr msg{};
+        msg.msg_iov         = &iov;
+        msg.msg_iovlen      = 1;
+        msg.msg_control     = control;
+        msg.msg_controllen  = sizeof(control);
+        ::cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level    = SOL_SOCKET;
+        cmsg->cmsg_type     = SCM_RIGHTS;
+        cmsg->cmsg_len      = CMSG_LEN(sizeof(seg_fds));
+        ::std::memcpy(CMSG_DATA(cmsg), seg_fds, sizeof(seg_fds));
+        ASSERT_EQ(sizeof(capacity), ::sendmsg(fds[0], &msg, 0));
+
+        shm_segment client;
+        asio_config::error_code ec;
+        EXPECT_NO_THROW(client.receive(fds[1], ec));
+        EXPECT_TRUE(ec) << "Capacity " << capacity << " must be rejected";
+        EXPECT_FALSE(client.valid());
+
+        ::close(seg_fds[0]);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+
+TEST(SHMSegment, InvalidCreateCapacity)
+{
+    shm_segment segment;
+    asio_config::error_code ec;
+    EXPECT_NO_THROW(segment.create(100, ec));
+    EXPECT_TRUE(ec);
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
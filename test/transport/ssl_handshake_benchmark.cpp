@@ -0,0 +1,119 @@
+/*
+ * ssl_handshake_benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <benchmark/benchmark_api.h>
+#include <wire/core/transport.hpp>
+#include <wire/core/detail/ssl_session_cache.hpp>
+
+#include "config.hpp"
+
+namespace wire {
+namespace core {
+namespace test {
+
+namespace {
+
+struct handshake_session : ::std::enable_shared_from_this< handshake_session > {
+    handshake_session(asio_config::io_service_ptr svc,
+            detail::ssl_options const& opts)
+        : transport_{svc, opts}
+    {
+    }
+
+    ssl_transport::listen_socket_type&
+    socket()
+    {
+        return transport_.socket();
+    }
+
+    void
+    start_session()
+    {
+        auto _this = shared_from_this();
+        transport_.start(
+            [_this](asio_config::error_code const&)
+            {
+                _this->transport_.close();
+            });
+    }
+
+    ssl_transport   transport_;
+};
+
+using handshake_server = transport_listener< handshake_session, transport_type::ssl >;
+
+void
+run_handshakes(::benchmark::State& state, bool resume)
+{
+    auto svc = ::std::make_shared< asio_config::io_service >();
+
+    detail::ssl_options server_opts;
+    server_opts.verify_file = wire::test::CA_ROOT;
+    server_opts.cert_file   = wire::test::SERVER_CERT;
+    server_opts.key_file    = wire::test::SERVER_KEY;
+    server_opts.ticket_keys = detail::ssl_session_cache::generate_ticket_keys();
+
+    handshake_server server{svc,
+        [&](asio_config::io_service_ptr s)
+        {
+            return ::std::make_shared< handshake_session >(s, server_opts);
+        }};
+    server.open(endpoint::ssl("127.0.0.1", 0));
+    endpoint ep = server.local_endpoint();
+
+    detail::ssl_options client_opts;
+    client_opts.verify_file = wire::test::CA_ROOT;
+    if (resume) {
+        client_opts.session_cache = ::std::make_shared< detail::ssl_session_cache >();
+    }
+
+    ::std::size_t reused = 0;
+    while (state.KeepRunning()) {
+        ssl_transport client{svc, client_opts};
+        bool connected = false;
+        client.connect_async(ep,
+            [&](asio_config::error_code const& ec)
+            {
+                connected = !ec;
+                svc->stop();
+            });
+        svc->run();
+        svc->reset();
+        if (!connected) {
+            state.SkipWithError("SSL handshake failed");
+            break;
+        }
+        if (client.session_reused())
+            ++reused;
+        client.close();
+    }
+    state.SetLabel("reused " + ::std::to_string(reused));
+    server.close();
+    svc->poll();
+}
+
+}  /* namespace  */
+
+void
+BM_SSLFullHandshake(::benchmark::State& state)
+{
+    run_handshakes(state, false);
+}
+BENCHMARK(BM_SSLFullHandshake);
+
+void
+BM_SSLResumedHandshake(::benchmark::State& state)
+{
+    run_handshakes(state, true);
+}
+BENCHMARK(BM_SSLResumedHandshake);
+
+}  /* namespace test */
+}  /* namespace core */
+}  /* namespace wire */
+
+BENCHMARK_MAIN()
@@ -0,0 +1,60 @@
+/*
+ * ssl_session_cache_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/ssl_session_cache.hpp>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+namespace {
+
+bool
+cached(ssl_session_cache const& cache, ssl_session_cache::key_type const& key)
+{
+    SSL_SESSION* s = cache.get(key);
+    if (s)
+        SSL_SESSION_free(s);
+    return s != nullptr;
+}
+
+}  /* namespace  */
+
+TEST(SSLSessionCache, EvictLeastRecentlyUsed)
+{
+    ssl_session_cache cache{3};
+    cache.put("a", SSL_SESSION_new());
+    cache.put("b", SSL_SESSION_new());
+    cache.put("c", SSL_SESSION_new());
+    EXPECT_EQ(3, cache.size());
+
+    // Use a, b is the least recently used now
+    EXPECT_TRUE(cached(cache, "a"));
+    cache.put("d", SSL_SESSION_new());
+    EXPECT_EQ(3, cache.size());
+    EXPECT_FALSE(cached(cache, "b"));
+    EXPECT_TRUE(cached(cache, "a"));
+    EXPECT_TRUE(cached(cache, "c"));
+    EXPECT_TRUE(cached(cache, "d"));
+
+    // Replacing a session counts as a use
+    cache.put("a", SSL_SESSION_new());
+    cache.put("e", SSL_SESSION_new());
+    EXPECT_FALSE(cached(cache, "c"));
+    EXPECT_TRUE(cached(cache, "a"));
+
+    cache.erase("a");
+    EXPECT_EQ(2, cache.size());
+    EXPECT_FALSE(cached(cache, "a"));
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
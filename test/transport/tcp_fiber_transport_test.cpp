@@ -6,10 +6,15 @@
  */
 
 #include <gtest/gtest.h>
-#include <pushkin/asio/fiber/shared_work.hpp>
+#include <wire/util/fiber_scheduler.hpp>
 #include <wire/core/transport.hpp>
 #include "sparring/sparring_test.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 namespace wire {
 namespace core {
 namespace test {
@@ -20,7 +25,6 @@ protected:
     void
     SetUp() override
     {
-        runner_ = ::psst::asio::fiber::use_shared_work_algorithm( io_svc );
         StartPartner();
     }
     void
@@ -37,7 +41,6 @@ protected:
         endpoint_ = endpoint{ ReadEnpointPort< detail::tcp_endpoint_data >(is) };
     }
     endpoint                        endpoint_;
-    ::psst::asio::fiber::runner_ptr runner_;
 };
 
 TEST_F(TCPFiber, ReadWriteAsync)
@@ -52,6 +55,7 @@ TEST_F(TCPFiber, ReadWriteAsync)
     asio_ns::streambuf in_buffer;
     std::string input_str;
 
+    auto& runner = util::fiber::use_io_service_algorithm( io_svc );
     ::boost::fibers::fiber{
         [&]{
             tcp_transport tcp(io_svc);
@@ -75,13 +79,90 @@ TEST_F(TCPFiber, ReadWriteAsync)
         }
     }.detach();
 
-    runner_->run();
+    runner.run();
     EXPECT_TRUE(connected);
     EXPECT_EQ(test_str.size(), written);
     EXPECT_EQ(test_str.size(), received);
     EXPECT_EQ(test_str, input_str);
 }
 
+class TCPFiberThroughput : public TCPFiber {
+protected:
+    static constexpr int thread_cnt     = 2;
+    static constexpr int fiber_cnt      = 50;
+    static constexpr int round_trip_cnt = 1000;
+
+    void
+    SetupArgs(args_type& args) override
+    {
+        args.insert(args.end(), {
+            "--transport", "tcp",
+            "--connections", ::std::to_string(thread_cnt * fiber_cnt),
+            "--requests", "0"
+        });
+    }
+};
+
+TEST_F(TCPFiberThroughput, ReadWriteSync)
+{
+    using clock_type = ::std::chrono::steady_clock;
+    ASSERT_NE(0, child_.pid);
+    ASSERT_EQ(transport_type::tcp, endpoint_.transport());
+
+    const std::string test_str("TestString");
+    ::std::atomic<int> finish_cnt{0};
+    ::std::atomic<int> round_trips{0};
+    ::std::atomic<int> errors{0};
+
+    auto test_f = [&]{
+        tcp_transport tcp(io_svc);
+        try {
+            tcp.connect_async(endpoint_).get();
+            char in[16];
+            for (auto i = 0; i < round_trip_cnt; ++i) {
+                tcp.async_write(asio_ns::buffer(test_str)).get();
+                auto received = tcp.async_read(
+                        asio_ns::buffer(in, test_str.size())).get();
+                if (received != test_str.size() ||
+                        test_str.compare(0, received, in, received) != 0)
+                    ++errors;
+                ++round_trips;
+            }
+        } catch (...) {
+            ++errors;
+        }
+        tcp.close();
+        if (++finish_cnt == thread_cnt * fiber_cnt)
+            io_svc->stop();
+    };
+
+    ::std::vector<::std::thread> threads;
+    threads.reserve(thread_cnt);
+
+    auto start = clock_type::now();
+    for (auto i = 0; i < thread_cnt; ++i) {
+        threads.emplace_back(
+        [&](){
+            auto& runner = util::fiber::use_io_service_algorithm( io_svc );
+            for (auto i = 0; i < fiber_cnt; ++i) {
+                ::boost::fibers::fiber{ test_f }.detach();
+            }
+            runner.run();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ::std::chrono::duration<double> elapsed = clock_type::now() - start;
+
+    EXPECT_EQ(0, errors);
+    EXPECT_EQ(thread_cnt * fiber_cnt * round_trip_cnt, round_trips);
+    ::std::cerr << "Fibers " << thread_cnt * fiber_cnt
+            << " in " << thread_cnt << " threads, "
+            << round_trips << " round trips in " << elapsed.count() << "s, "
+            << round_trips / elapsed.count() << " round trips/s\n";
+}
+
 } /* namespace test */
 } /* namespace core */
 } /* namespace wire */
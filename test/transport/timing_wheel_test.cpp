@@ -0,0 +1,96 @@
+/*
+ * timing_wheel_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/timing_wheel.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+TEST(TimingWheel, Expire)
+{
+    using clock_type = timing_wheel::clock_type;
+    asio_config::io_service svc;
+    auto& wheel = asio_ns::use_service<timing_wheel>(svc);
+
+    ::std::vector<int> order;
+    auto start = clock_type::now();
+    clock_type::time_point fired;
+    wheel.schedule(timing_wheel::duration_type{30}, [&](){ order.push_back(3); fired = clock_type::now(); });
+    wheel.schedule(timing_wheel::duration_type{10}, [&](){ order.push_back(1); });
+    wheel.schedule(timing_wheel::duration_type{20}, [&](){ order.push_back(2); });
+    EXPECT_EQ(3, wheel.size());
+
+    svc.run();
+    ASSERT_EQ((::std::vector<int>{1, 2, 3}), order);
+    EXPECT_LE(timing_wheel::duration_type{30},
+            ::std::chrono::duration_cast<timing_wheel::duration_type>(fired - start));
+    EXPECT_EQ(0, wheel.size());
+}
+
+TEST(TimingWheel, Cancel)
+{
+    asio_config::io_service svc;
+    auto& wheel = asio_ns::use_service<timing_wheel>(svc);
+
+    int fired = 0;
+    auto t1 = wheel.schedule(timing_wheel::duration_type{10}, [&](){ ++fired; });
+    auto t2 = wheel.schedule(timing_wheel::duration_type{20}, [&](){ ++fired; });
+    EXPECT_NE(t1, t2);
+    EXPECT_TRUE(wheel.cancel(t1));
+    EXPECT_FALSE(wheel.cancel(t1)) << "Double cancel";
+    EXPECT_FALSE(wheel.cancel(timing_wheel::invalid_timer));
+    EXPECT_EQ(1, wheel.size());
+
+    // The slot is reused, the stale handle must not cancel the new timer
+    auto t3 = wheel.schedule(timing_wheel::duration_type{5}, [&](){ ++fired; });
+    EXPECT_NE(t1, t3);
+    EXPECT_FALSE(wheel.cancel(t1));
+
+    svc.run();
+    EXPECT_EQ(2, fired);
+    EXPECT_FALSE(wheel.cancel(t2)) << "Cancel expired timer";
+}
+
+TEST(TimingWheel, MultipleRounds)
+{
+    asio_config::io_service svc;
+    auto& wheel = asio_ns::use_service<timing_wheel>(svc);
+
+    auto timeout = timing_wheel::duration_type{ timing_wheel::wheel_size * 2 + 10 };
+    auto start = timing_wheel::clock_type::now();
+    timing_wheel::clock_type::time_point fired;
+    wheel.schedule(timeout, [&](){ fired = timing_wheel::clock_type::now(); });
+    svc.run();
+    EXPECT_LE(timeout,
+            ::std::chrono::duration_cast<timing_wheel::duration_type>(fired - start));
+}
+
+TEST(TimingWheel, ScheduleFromHandler)
+{
+    asio_config::io_service svc;
+    auto& wheel = asio_ns::use_service<timing_wheel>(svc);
+
+    ::std::atomic<int> fired{0};
+    wheel.schedule(timing_wheel::duration_type{1}, [&]()
+    {
+        ++fired;
+        wheel.schedule(timing_wheel::duration_type{1}, [&](){ ++fired; });
+    });
+    svc.run();
+    EXPECT_EQ(2, fired);
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -103,6 +103,57 @@ TEST_F(UDP, ReadWrite)
     EXPECT_EQ(test_str, input_str);
 }
 
+TEST(UDPBatch, SendReceive)
+{
+    auto svc = ::std::make_shared< asio_config::io_service >();
+    transport_listener< void, transport_type::udp > server{svc};
+    server.open(endpoint::udp("127.0.0.1", 0));
+
+    ::std::vector< ::std::string > messages;
+    for (int i = 0; i < 100; ++i) {
+        messages.push_back("message " + ::std::to_string(i));
+    }
+    detail::datagram_list datagrams;
+    for (auto const& m : messages) {
+        datagrams.push_back(asio_ns::buffer(m));
+    }
+
+    ::std::vector< ::std::string > received;
+    detail::datagram_batch batch{16, 256};
+    ::std::function< void(asio_config::error_code const&, ::std::size_t) > on_receive =
+        [&](asio_config::error_code const& ec, ::std::size_t n)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+            EXPECT_LE(n, batch.capacity());
+            for (::std::size_t i = 0; i < n; ++i) {
+                EXPECT_FALSE(batch.truncated(i));
+                received.emplace_back(
+                    asio_ns::buffer_cast<char const*>(batch[i]),
+                    asio_ns::buffer_size(batch[i]));
+            }
+            if (received.size() < messages.size()) {
+                server.async_receive_batch(batch, on_receive);
+            }
+        };
+    server.async_receive_batch(batch, on_receive);
+
+    udp_transport client{svc};
+    ::std::size_t sent = 0;
+    client.connect_async(server.local_endpoint(),
+    [&](asio_config::error_code const& ec) {
+        ASSERT_FALSE(ec) << ec.message();
+        client.async_send_batch(datagrams,
+        [&](asio_config::error_code const& ec, ::std::size_t n) {
+            EXPECT_FALSE(ec) << ec.message();
+            sent = n;
+        });
+    });
+
+    svc->run();
+    EXPECT_EQ(messages.size(), sent);
+    EXPECT_EQ(messages, received) << "One message per datagram, in order";
+}
+
 
 }  // namespace test
 }  // namespace core
@@ -0,0 +1,220 @@
+/*
+ * uring_service_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/uring_service.hpp>
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+namespace {
+
+struct socket_pair {
+    socket_pair()
+    {
+        ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    }
+    ~socket_pair()
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+    int fds[2];
+};
+
+}  /* namespace  */
+
+TEST(URing, SendReceive)
+{
+    if (!uring_service::supported()) {
+        ::std::cerr << "io_uring is not available, skip the test\n";
+        return;
+    }
+    asio_config::io_service svc;
+    auto uring = uring_service::enable(svc);
+    ASSERT_NE(nullptr, uring);
+    EXPECT_EQ(uring, uring_service::get(svc));
+
+    socket_pair sp;
+    auto client = uring->open(sp.fds[0]);
+    auto server = uring->open(sp.fds[1]);
+
+    ::std::string hello{"hello"}, world{" world"};
+    int sent = 0;
+    auto on_sent = [&](asio_config::error_code const& ec, ::std::size_t)
+        {
+            EXPECT_FALSE(ec) << ec.message();
+            ++sent;
+        };
+    uring->async_send(client, { asio_ns::buffer(hello) }, on_sent);
+    uring->async_send(client, { asio_ns::buffer(world) }, on_sent);
+
+    ::std::string received;
+    char buffer[4];
+    asio_config::asio_rw_callback on_read;
+    on_read = [&](asio_config::error_code const& ec, ::std::size_t bytes)
+        {
+            ASSERT_FALSE(ec) << ec.message();
+            received.append(buffer, bytes);
+            if (received.size() < hello.size() + world.size())
+                uring->async_receive(server, asio_ns::buffer(buffer), on_read);
+        };
+    uring->async_receive(server, asio_ns::buffer(buffer), on_read);
+
+    while (received.size() < hello.size() + world.size() && svc.run_one()) {}
+    EXPECT_EQ(2, sent);
+    EXPECT_EQ("hello world", received);
+
+    uring->close(client);
+    uring->close(server);
+}
+
+TEST(URing, EndOfFile)
+{
+    if (!uring_service::supported()) {
+        return;
+    }
+    asio_config::io_service svc;
+    auto uring = uring_service::enable(svc);
+    ASSERT_NE(nullptr, uring);
+
+    socket_pair sp;
+    auto server = uring->open(sp.fds[1]);
+    ::shutdown(sp.fds[0], SHUT_WR);
+
+    asio_config::error_code error;
+    bool done = false;
+    char buffer[16];
+    uring->async_receive(server, asio_ns::buffer(buffer),
+        [&](asio_config::error_code const& ec, ::std::size_t)
+        {
+            error = ec;
+            done = true;
+        });
+    while (!done && svc.run_one()) {}
+    EXPECT_EQ(asio_config::error::eof, error);
+    uring->close(server);
+}
+
+TEST(URing, CloseAbortsRead)
+{
+    if (!uring_service::supported()) {
+        return;
+    }
+    asio_config::io_service svc;
+    auto uring = uring_service::enable(svc);
+    ASSERT_NE(nullptr, uring);
+
+    socket_pair sp;
+    auto server = uring->open(sp.fds[1]);
+    asio_config::error_code error;
+    bool done = false;
+    char buffer[16];
+    uring->async_receive(server, asio_ns::buffer(buffer),
+        [&](asio_config::error_code const& ec, ::std::size_t)
+        {
+            error = ec;
+            done = true;
+        });
+    svc.poll();
+    uring->close(server);
+    while (!done && svc.run_one()) {}
+    EXPECT_EQ(asio_config::error::operation_aborted, error);
+}
+
+TEST(URing, PausedStreamKeepsBuffers)
+{
+    if (!uring_service::supported()) {
+        return;
+    }
+    asio_config::io_service svc;
+    auto uring = uring_service::enable(svc);
+    ASSERT_NE(nullptr, uring);
+
+    // The paused stream reads once and then stops reading
+    socket_pair paused_sp;
+    auto paused = uring->open(paused_sp.fds[1]);
+    ::fcntl(paused_sp.fds[0], F_SETFL, O_NONBLOCK);
+    char buffer[16];
+    bool read_once = false;
+    uring->async_receive(paused, asio_ns::buffer(buffer),
+        [&](asio_config::error_code const& ec, ::std::size_t)
+        {
+            EXPECT_FALSE(ec) << ec.message();
+            read_once = true;
+        });
+    ::std::vector< char > data(uring_service::recv_buffer_size, 'x');
+    // Offer more data than the whole buffer pool can hold
+    ::std::size_t const total = 2 * uring_service::recv_buffer_count
+            * uring_service::recv_buffer_size;
+    ::std::size_t written = 0;
+    for (int idle = 0; written < total && idle < 100;) {
+        auto res = ::write(paused_sp.fds[0], data.data(), data.size());
+        if (res > 0) {
+            written += res;
+            idle = 0;
+        } else {
+            ++idle;
+            ::std::this_thread::sleep_for(::std::chrono::milliseconds{1});
+        }
+        svc.poll();
+        svc.reset();
+    }
+    EXPECT_TRUE(read_once);
+    EXPECT_GT(total, written) << "Peer of a paused stream must be throttled";
+
+    // Another stream still gets buffers to read to
+    socket_pair sp;
+    auto server = uring->open(sp.fds[1]);
+    ::std::string ping{"ping"};
+    ASSERT_EQ(ping.size(), ::write(sp.fds[0], ping.data(), ping.size()));
+    ::std::string received;
+    uring->async_receive(server, asio_ns::buffer(buffer),
+        [&](asio_config::error_code const& ec, ::std::size_t bytes)
+        {
+            EXPECT_FALSE(ec) << ec.message();
+            received.assign(buffer, bytes);
+        });
+    auto deadline = ::std::chrono::steady_clock::now() + ::std::chrono::seconds{2};
+    while (received.empty() && ::std::chrono::steady_clock::now() < deadline) {
+        svc.poll();
+        svc.reset();
+        ::std::this_thread::sleep_for(::std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(ping, received);
+
+    // The paused stream resumes reading the data queued for it
+    bool resumed = false;
+    uring->async_receive(paused, asio_ns::buffer(buffer),
+        [&](asio_config::error_code const& ec, ::std::size_t bytes)
+        {
+            EXPECT_FALSE(ec) << ec.message();
+            EXPECT_LT(0, bytes);
+            resumed = true;
+        });
+    while (!resumed && svc.run_one()) {}
+    EXPECT_TRUE(resumed);
+
+    uring->close(paused);
+    uring->close(server);
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
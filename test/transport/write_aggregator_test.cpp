@@ -0,0 +1,135 @@
+/*
+ * write_aggregator_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+#include <wire/core/detail/write_aggregator.hpp>
+
+#include <string>
+
+namespace wire {
+namespace core {
+namespace detail {
+namespace test {
+
+namespace {
+
+struct fake_transport {
+    template < typename BufferType, typename HandlerType >
+    void
+    async_write(BufferType const& buffers, HandlerType handler)
+    {
+        ::std::size_t bytes = 0;
+        for (auto const& b : buffers) {
+            record_sizes.push_back(asio_ns::buffer_size(b));
+            data.append(asio_ns::buffer_cast<char const*>(b), asio_ns::buffer_size(b));
+            bytes += asio_ns::buffer_size(b);
+        }
+        ++writes;
+        pending = [handler, bytes](asio_config::error_code const& ec)
+            {
+                handler(ec, bytes);
+            };
+    }
+    void
+    close()
+    {
+        closed = true;
+    }
+
+    void
+    complete(asio_config::error_code const& ec = asio_config::error_code{})
+    {
+        auto cb = ::std::move(pending);
+        pending = nullptr;
+        cb(ec);
+    }
+
+    int                                 writes = 0;
+    bool                                closed = false;
+    ::std::string                       data;
+    ::std::vector< ::std::size_t >      record_sizes;
+    asio_config::asio_callback          pending;
+};
+
+using buffers_type = ::std::vector< asio_ns::const_buffer >;
+
+}  /* namespace  */
+
+TEST(WriteAggregator, PackRecords)
+{
+    fake_transport transport;
+    write_aggregator< fake_transport > writer{transport};
+    ::std::string small(100, 'a');
+    buffers_type buffers;
+    for (int i = 0; i < 300; ++i) {
+        buffers.push_back(asio_ns::buffer(small));
+    }
+    ::std::size_t written = 0;
+    writer.write(buffers,
+        [&](asio_config::error_code const& ec, ::std::size_t bytes)
+        {
+            EXPECT_FALSE(ec);
+            written = bytes;
+        }, nullptr);
+    EXPECT_EQ(1, transport.writes);
+    ASSERT_EQ(2, transport.record_sizes.size());
+    EXPECT_EQ(record_buffer_pool::record_size, transport.record_sizes[0]);
+    EXPECT_EQ(30000 - record_buffer_pool::record_size, transport.record_sizes[1]);
+    EXPECT_EQ(0, written) << "Callback is called when the write finishes";
+    transport.complete();
+    EXPECT_EQ(30000, written);
+    EXPECT_EQ(::std::string(30000, 'a'), transport.data);
+}
+
+TEST(WriteAggregator, CoalesceMessages)
+{
+    fake_transport transport;
+    write_aggregator< fake_transport > writer{transport};
+    ::std::string msg(100, 'b');
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(100, writer.append(buffers_type{ asio_ns::buffer(msg) }));
+    }
+    EXPECT_EQ(0, transport.writes);
+    ::std::size_t written = 0;
+    writer.flush(
+        [&](asio_config::error_code const& ec, ::std::size_t bytes)
+        {
+            EXPECT_FALSE(ec);
+            written = bytes;
+        }, nullptr);
+    EXPECT_EQ(1, transport.writes);
+    ASSERT_EQ(1, transport.record_sizes.size());
+    EXPECT_EQ(1000, transport.record_sizes[0]) << "Appended messages share a record";
+    EXPECT_EQ(0, written) << "Callback is called when the write finishes";
+    transport.complete();
+    EXPECT_EQ(1000, written);
+    EXPECT_EQ(1000, transport.data.size());
+}
+
+TEST(WriteAggregator, Error)
+{
+    fake_transport transport;
+    write_aggregator< fake_transport > writer{transport};
+    ::std::string msg(100, 'd');
+    int errors = 0;
+    auto cb = [&](asio_config::error_code const& ec, ::std::size_t)
+        {
+            if (ec) ++errors;
+        };
+    writer.write(buffers_type{ asio_ns::buffer(msg) }, cb, nullptr);
+    transport.complete(asio_config::make_error_code(asio_config::error::broken_pipe));
+    EXPECT_EQ(1, errors);
+    EXPECT_TRUE(transport.closed);
+    writer.write(buffers_type{ asio_ns::buffer(msg) }, cb, nullptr);
+    EXPECT_EQ(2, errors);
+    EXPECT_EQ(1, transport.writes);
+}
+
+}  /* namespace test */
+}  /* namespace detail */
+}  /* namespace core */
+}  /* namespace wire */
@@ -0,0 +1,189 @@
+/*
+ * inplace_function_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+
+#include <wire/util/inplace_function.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+::std::atomic< ::std::size_t > heap_allocations{0};
+
+}  /* namespace  */
+
+void*
+operator new(::std::size_t sz)
+{
+    ++heap_allocations;
+    if (void* p = ::std::malloc(sz ? sz : 1))
+        return p;
+    throw ::std::bad_alloc{};
+}
+
+void
+operator delete(void* p) noexcept
+{
+    ::std::free(p);
+}
+
+void
+operator delete(void* p, ::std::size_t) noexcept
+{
+    ::std::free(p);
+}
+
+namespace wire {
+namespace util {
+namespace test {
+
+namespace {
+
+int
+free_function(int a)
+{
+    return a * 2;
+}
+
+struct move_only_arg {
+    ::std::unique_ptr<int> value;
+};
+
+}  /* namespace  */
+
+TEST(InplaceFunction, Empty)
+{
+    inplace_function< void() > f;
+    EXPECT_FALSE(f);
+    EXPECT_TRUE(f == nullptr);
+    EXPECT_TRUE(nullptr == f);
+    EXPECT_THROW(f(), ::std::bad_function_call);
+
+    inplace_function< void() > n = nullptr;
+    EXPECT_FALSE(n);
+
+    int (*null_ptr)(int) = nullptr;
+    inplace_function< int(int) > p = null_ptr;
+    EXPECT_FALSE(p) << "Null function pointer makes an empty function";
+
+    ::std::function< int(int) > empty_std;
+    inplace_function< int(int) > s = empty_std;
+    EXPECT_FALSE(s) << "Empty std::function makes an empty function";
+}
+
+TEST(InplaceFunction, Call)
+{
+    inplace_function< int(int) > f = free_function;
+    ASSERT_TRUE(f);
+    EXPECT_TRUE(f != nullptr);
+    EXPECT_EQ(42, f(21));
+
+    int offset = 10;
+    f = [offset](int a) { return a + offset; };
+    EXPECT_EQ(15, f(5));
+
+    f = nullptr;
+    EXPECT_FALSE(f);
+
+    inplace_function< void(move_only_arg&&) > m =
+        [](move_only_arg&& arg) { EXPECT_EQ(42, *arg.value); };
+    m(move_only_arg{ ::std::unique_ptr<int>{ new int{42} } });
+
+    inplace_function< long(int) > conv = free_function;
+    EXPECT_EQ(42, conv(21)) << "Result converts to the declared type";
+}
+
+TEST(InplaceFunction, SmallTargetsDontAllocate)
+{
+    auto ptr = ::std::make_shared<int>(42);
+    ::std::string str{"a string that is definitely longer than the SSO buffer"};
+    auto before = heap_allocations.load();
+    {
+        inplace_function< int() > f = [ptr]() { return *ptr; };
+        EXPECT_EQ(42, f());
+        inplace_function< int() > copy = f;
+        inplace_function< int() > moved = ::std::move(f);
+        EXPECT_FALSE(f);
+        EXPECT_EQ(42, copy());
+        EXPECT_EQ(42, moved());
+        swap(copy, moved);
+        EXPECT_EQ(3, ptr.use_count());
+    }
+    EXPECT_EQ(1, ptr.use_count());
+    EXPECT_EQ(before, heap_allocations.load())
+        << "Shared pointer capture is stored inline";
+}
+
+TEST(InplaceFunction, LargeTargetsUseHeap)
+{
+    using big_array = ::std::array< char, 256 >;
+    big_array data;
+    data.fill('x');
+    auto before = heap_allocations.load();
+    inplace_function< char(::std::size_t), 32 > f =
+        [data](::std::size_t i) { return data[i]; };
+    EXPECT_LT(before, heap_allocations.load());
+    EXPECT_EQ('x', f(100));
+
+    auto copy = f;
+    EXPECT_EQ('x', copy(200));
+    auto moved_count = heap_allocations.load();
+    auto moved = ::std::move(f);
+    EXPECT_EQ(moved_count, heap_allocations.load())
+        << "Moving a heap allocated target doesn't allocate";
+    EXPECT_EQ('x', moved(0));
+}
+
+TEST(InplaceFunction, WrappingAFunctionUsesHeap)
+{
+    // A target capturing a function of the same capacity never fits the
+    // buffer, callbacks capture their state by pointer instead
+    auto ptr = ::std::make_shared<int>(0);
+    inplace_function< void() > inner = [ptr]() { ++*ptr; };
+    auto before = heap_allocations.load();
+    {
+        inplace_function< void() > outer = [inner, ptr]() { inner(); };
+        EXPECT_LT(before, heap_allocations.load());
+    }
+    before = heap_allocations.load();
+    {
+        ::std::size_t number = 1, bytes = 100;
+        bool flag = true;
+        inplace_function< void() > small =
+            [ptr, number, flag, bytes]() { *ptr += number + bytes + flag; };
+        small();
+    }
+    EXPECT_EQ(before, heap_allocations.load())
+        << "Pointer and a few scalars are stored inline";
+}
+
+TEST(InplaceFunction, DestroysTarget)
+{
+    auto ptr = ::std::make_shared<int>(0);
+    {
+        ::std::vector< inplace_function< void() > > funcs;
+        for (int i = 0; i < 10; ++i) {
+            funcs.emplace_back([ptr]() { ++*ptr; });
+        }
+        for (auto const& f : funcs) {
+            f();
+        }
+        EXPECT_EQ(11, ptr.use_count());
+    }
+    EXPECT_EQ(10, *ptr);
+    EXPECT_EQ(1, ptr.use_count());
+}
+
+}  /* namespace test */
+}  /* namespace util */
+}  /* namespace wire */
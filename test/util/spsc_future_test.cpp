@@ -0,0 +1,149 @@
+/*
+ * spsc_future_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: zmij
+ */
+
+#include <gtest/gtest.h>
+
+#include <wire/util/spsc_future.hpp>
+#include <wire/future_config.hpp>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace wire {
+namespace util {
+namespace test {
+
+TEST(SpscFuture, Value)
+{
+    spsc_promise< ::std::string > promise;
+    auto future = promise.get_future();
+    EXPECT_TRUE(future.valid());
+    EXPECT_FALSE(future.is_ready());
+    EXPECT_THROW(promise.get_future(), ::std::future_error);
+
+    promise.set_value("test");
+    EXPECT_TRUE(future.is_ready());
+    EXPECT_THROW(promise.set_value("again"), ::std::future_error);
+    EXPECT_EQ("test", future.get());
+    EXPECT_FALSE(future.valid());
+    EXPECT_THROW(future.get(), ::std::future_error);
+}
+
+TEST(SpscFuture, Void)
+{
+    spsc_promise< void > promise;
+    auto future = promise.get_future();
+    promise.set_value();
+    EXPECT_NO_THROW(future.get());
+}
+
+TEST(SpscFuture, Exception)
+{
+    spsc_promise< int > promise;
+    auto future = promise.get_future();
+    promise.set_exception(
+            ::std::make_exception_ptr(::std::runtime_error{"test"}));
+    EXPECT_THROW(future.get(), ::std::runtime_error);
+}
+
+TEST(SpscFuture, BrokenPromise)
+{
+    spsc_future< int > future;
+    {
+        spsc_promise< int > promise;
+        future = promise.get_future();
+    }
+    ASSERT_TRUE(future.is_ready());
+    try {
+        future.get();
+        FAIL() << "Broken promise error expected";
+    } catch (::std::future_error const& e) {
+        EXPECT_EQ(::std::future_errc::broken_promise, e.code());
+    }
+}
+
+TEST(SpscFuture, SharedPromise)
+{
+    auto promise = make_promise< spsc_promise< int > >();
+    auto future = promise->get_future();
+    {
+        auto on_value = [promise](int val) { promise->set_value(val); };
+        auto on_error = [promise](::std::exception_ptr ex)
+                { promise->set_exception(ex); };
+        promise = decltype(promise){};
+        EXPECT_FALSE(future.is_ready())
+            << "Copies of the pointer keep the promise alive";
+        on_value(42);
+        (void)on_error;
+    }
+    EXPECT_EQ(42, future.get());
+
+    auto std_promise = make_promise< ::std::promise< int > >();
+    std_promise->set_value(42);
+    EXPECT_EQ(42, std_promise->get_future().get());
+}
+
+TEST(SpscFuture, WaitInOtherThread)
+{
+    for (::std::size_t spin : { ::std::size_t{0}, spsc_default_spin_count }) {
+        spsc_promise< ::std::unique_ptr<int> > promise;
+        auto future = promise.get_future();
+        ::std::thread t{
+            [&promise]()
+            {
+                ::std::this_thread::sleep_for(::std::chrono::milliseconds{10});
+                promise.set_value(::std::unique_ptr<int>{ new int{42} });
+            }};
+        future.wait(spin);
+        EXPECT_EQ(42, *future.get());
+        t.join();
+    }
+}
+
+TEST(SpscFuture, WaitFor)
+{
+    spsc_promise< int > promise;
+    auto future = promise.get_future();
+    EXPECT_EQ(::std::future_status::timeout,
+            future.wait_for(::std::chrono::milliseconds{1}));
+    promise.set_value(1);
+    EXPECT_EQ(::std::future_status::ready,
+            future.wait_for(::std::chrono::milliseconds{1}));
+}
+
+TEST(SpscFuture, StdFuture)
+{
+    {
+        spsc_promise< int > promise;
+        ::std::future< int > future = promise.get_future();
+        promise.set_value(42);
+        EXPECT_EQ(42, future.get());
+    }
+    {
+        spsc_promise< int > promise;
+        auto spsc = promise.get_future();
+        promise.set_value(42);
+        ::std::future< int > future = ::std::move(spsc);
+        EXPECT_FALSE(spsc.valid());
+        EXPECT_EQ(42, future.get());
+    }
+    {
+        ::std::future< void > future;
+        {
+            spsc_promise< void > promise;
+            future = promise.get_future();
+        }
+        EXPECT_THROW(future.get(), ::std::future_error);
+    }
+}
+
+}  /* namespace test */
+}  /* namespace util */
+}  /* namespace wire */